@@ -0,0 +1,88 @@
+/**
+* @file
+* @brief Client transmit path: per-packet formatting vs pre-built templates.
+*
+* @details
+* `BM_TxPrepare<Mode>` prepares one batch (argument = packets) of 64-byte datagrams
+* in a pool-backed slab, which is everything the send loop does besides the syscall:
+*  - `per_packet` : write the whole header and length of every packet and read the
+*    clock once per packet (the loop before @ref udp::TxTemplate).
+*  - `template`   : @ref udp::TxTemplate::stamp patches `seq` and `send_ts_ns` only,
+*    with one clock read per batch.
+*
+* `BM_ClientTx` runs a real @ref udp::UdpClient (unpaced) against a socket that
+* discards every batch, for 100 ms per iteration; items per second is the send
+* loop's single-core packet ceiling without kernel cost.
+*/
+#include <benchmark/benchmark.h>
+#include "udp/client.hpp"
+#include "udp/tx_template.hpp"
+#include <chrono>
+#include <thread>
+ 
+using namespace udp;
+ 
+static void BM_TxPrepare(benchmark::State& state, bool use_template) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    PacketPool pool(n, 64, false);
+    PacketSlab slab(pool, n);
+    TxTemplate tpl(slab, 64);
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        if (use_template) {
+            seq = tpl.stamp(n, seq + 1, now_ns()) - 1;
+        } else {
+            for (size_t i=0; i<n; ++i) {
+                PacketHeader* hdr = reinterpret_cast<PacketHeader*>(slab[i].data);
+                hdr->seq = ++seq;
+                hdr->send_ts_ns = now_ns();
+                hdr->magic = kMagic;
+                slab[i].len = 64;
+            }
+            slab.set_size(n);
+        }
+        benchmark::DoNotOptimize(slab[0].data);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+ 
+BENCHMARK_CAPTURE(BM_TxPrepare, per_packet, false)->Arg(64);
+BENCHMARK_CAPTURE(BM_TxPrepare, template, true)->Arg(64);
+ 
+/// Accepts every batch without doing anything.
+class DiscardSocket : public ISocket {
+public:
+    int fd() const override { return -1; }
+    void bind(uint16_t, bool) override {}
+    void connect(const std::string&, uint16_t) override {}
+    ssize_t recv_batch(std::vector<std::vector<uint8_t>>&) override { return 0; }
+    ssize_t send_batch(const std::vector<std::vector<uint8_t>>& bufs, const sockaddr_in*) override {
+        return static_cast<ssize_t>(bufs.size());
+    }
+    ssize_t recv_batch(PacketSlab&) override { return 0; }
+    ssize_t send_batch(const PacketSlab& slab, const sockaddr_in*) override {
+        return static_cast<ssize_t>(slab.size());
+    }
+};
+ 
+static void BM_ClientTx(benchmark::State& state) {
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        ClientConfig cfg;
+        cfg.pps = 1'000'000'000'000ull; // pacing never sleeps
+        cfg.seconds = 10;
+        cfg.batch = static_cast<int>(state.range(0));
+        cfg.hugepages = false;
+        UdpClient c(std::make_unique<DiscardSocket>(), cfg);
+        auto t0 = std::chrono::steady_clock::now();
+        c.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        c.stop();
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+        sent += c.stats().sent();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+ 
+BENCHMARK(BM_ClientTx)->Arg(64)->UseManualTime()->Iterations(5);
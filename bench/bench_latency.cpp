@@ -0,0 +1,61 @@
+/**
+* @file
+* @brief Loopback round-trip latency: interrupt-driven receive vs kernel busy polling.
+*
+* @details
+* `BM_PingPong<Mode>` bounces one 64-byte datagram between two `UdpSocket`s: an echo
+* thread and the benchmark thread both wait in a blocking `recvmmsg`
+* (`set_recv_wait`), so each iteration is one full round trip (wall time).
+*  - `interrupt` : default sockets; a waiting receive sleeps until softirq delivery.
+*  - `busy_poll` : both sockets get `SO_BUSY_POLL` (argument, in microseconds), so a
+*    waiting receive polls the device queue before sleeping.
+* The `busy_poll_us` counter is the value read back from the socket (0 means the
+* kernel refused it). Loopback traffic has no NAPI instance to poll, so expect both
+* modes to be close here; the gap shows up on real NIC queues.
+*/
+#include <benchmark/benchmark.h>
+#include "udp/socket.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <thread>
+ 
+using namespace udp;
+ 
+static void BM_PingPong(benchmark::State& state, bool busy) {
+    UdpSocket echo(1), ping(1);
+    echo.bind(0, false);
+    ping.bind(0, false);
+    ping.connect("127.0.0.1", local_port(echo));
+    BusyPoll want;
+    want.usecs = static_cast<int>(state.range(0));
+    BusyPoll got;
+    if (busy) {
+        got = echo.set_busy_poll(want);
+        ping.set_busy_poll(want);
+    }
+    echo.set_recv_wait(10);
+    ping.set_recv_wait(10);
+ 
+    std::atomic<bool> run{true};
+    std::thread echoer([&] {
+        PacketSlab in(1, 2048);
+        while (run.load(std::memory_order_relaxed)) {
+            if (echo.recv_batch(in) > 0) echo.send_batch(in, nullptr);
+        }
+    });
+ 
+    PacketSlab out(1, 64), in(1, 2048);
+    out[0].len = 64;
+    out.set_size(1);
+    for (auto _ : state) {
+        ping.send_batch(out);
+        while (ping.recv_batch(in) <= 0) {}
+    }
+    run = false;
+    echoer.join();
+    state.counters["busy_poll_us"] = got.usecs;
+}
+ 
+BENCHMARK_CAPTURE(BM_PingPong, interrupt, false)->Arg(0)->UseRealTime();
+BENCHMARK_CAPTURE(BM_PingPong, busy_poll, true)->Arg(50)->UseRealTime();
@@ -0,0 +1,60 @@
+/**
+* @file
+* @brief Loopback echo throughput: inline receive loop vs RX/processing pipeline.
+*
+* @details
+* `BM_ServerEcho<Mode>` runs a one-worker echo @ref udp::UdpServer and, per
+* iteration, sends a burst of datagrams (argument) and collects the echoes (up to
+* 5 ms). Items processed are echoed datagrams; `loss` is the fraction of the
+* burst that did not come back (socket overflow or ring drops).
+*  - `inline`   : `run_loop` receives, processes and echoes on one thread.
+*  - `pipeline` : an RX thread only receives and queues batches for the processing
+*    thread (`ServerConfig::pipeline`, ring depth 256).
+* The pipeline pays one ring hand-off per batch and needs a second core; on a
+* single core both threads share it and the inline loop wins.
+*/
+#include <benchmark/benchmark.h>
+#include "udp/server.hpp"
+#include <algorithm>
+#include <chrono>
+ 
+using namespace udp;
+ 
+static void BM_ServerEcho(benchmark::State& state, bool pipeline) {
+    ServerConfig cfg;
+    cfg.port = 0;
+    cfg.batch = 64;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.echo = true;
+    cfg.rx_timestamps = false;
+    cfg.pipeline = pipeline;
+    cfg.wait.kind = WaitKind::SpinYield;
+    UdpServer srv(std::make_unique<UdpSocket>(64), cfg);
+    srv.start();
+ 
+    UdpSocket client(64);
+    client.set_rcvbuf(4 << 20);
+    client.connect("127.0.0.1", srv.port());
+    const size_t burst = static_cast<size_t>(state.range(0));
+    std::vector<std::vector<uint8_t>> pkts(burst, std::vector<uint8_t>(64, 0));
+    PacketSlab in(64, 2048);
+    uint64_t sent = 0, echoed = 0;
+    for (auto _ : state) {
+        sent += static_cast<uint64_t>(std::max<ssize_t>(client.send_batch(pkts), 0));
+        size_t got = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+        while (got < burst && std::chrono::steady_clock::now() < deadline) {
+            ssize_t r = client.recv_batch(in);
+            if (r > 0) got += static_cast<size_t>(r);
+        }
+        echoed += got;
+    }
+    srv.stop();
+    state.SetItemsProcessed(static_cast<int64_t>(echoed));
+    state.counters["loss"] = sent ? 1.0 - static_cast<double>(echoed) / static_cast<double>(sent) : 0.0;
+    state.counters["ring_drops"] = static_cast<double>(srv.ring_drops(0));
+}
+ 
+BENCHMARK_CAPTURE(BM_ServerEcho, inline, false)->Arg(64)->Arg(512)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ServerEcho, pipeline, true)->Arg(64)->Arg(512)->UseRealTime();
@@ -0,0 +1,89 @@
+/**
+* @file
+* @brief Ring microbenchmarks: SPSC vs MPMC throughput and hand-off latency.
+*
+* @details
+*  - `BM_SpscThroughput/<batch>` : a producer thread keeps the ring full; the
+*    benchmark thread drains it @c batch elements at a time (`pop_n`). Items are
+*    elements moved.
+*  - `BM_MpmcThroughput/threads:<n>` : half of the @c n benchmark threads push,
+*    half pop, one element per iteration each, through one shared ring. Items
+*    are pops, so the rate shows how contention on the shared indices scales
+*    with producer/consumer count.
+*  - `BM_RoundTrip<Ring>` : one element bounced between two threads over a pair
+*    of rings; the time per iteration is one round trip (two hand-offs).
+* Consumers and producers spin with `yield`, so results on a machine with fewer
+* cores than threads mostly measure the scheduler.
+*/
+#include <benchmark/benchmark.h>
+#include "udp/ring.hpp"
+#include <atomic>
+#include <thread>
+ 
+using namespace udp;
+ 
+static void BM_SpscThroughput(benchmark::State& state) {
+    SpscRing<uint64_t> ring(1024);
+    std::atomic<bool> run{true};
+    std::thread producer([&] {
+        uint64_t chunk[64] = {};
+        while (run.load(std::memory_order_relaxed)) {
+            if (!ring.push_n(chunk, 64)) std::this_thread::yield();
+        }
+    });
+    const size_t batch = static_cast<size_t>(state.range(0));
+    uint64_t out[64];
+    int64_t moved = 0;
+    for (auto _ : state) {
+        size_t n = ring.pop_n(out, batch);
+        if (!n) std::this_thread::yield();
+        moved += static_cast<int64_t>(n);
+        benchmark::DoNotOptimize(out);
+    }
+    run = false;
+    producer.join();
+    state.SetItemsProcessed(moved);
+}
+BENCHMARK(BM_SpscThroughput)->Arg(1)->Arg(16)->Arg(64)->UseRealTime();
+ 
+static MpmcRing<uint64_t> g_mpmc(1024);
+ 
+static void BM_MpmcThroughput(benchmark::State& state) {
+    const bool producer = state.thread_index() % 2 == 0;
+    uint64_t v = static_cast<uint64_t>(state.thread_index());
+    for (auto _ : state) {
+        if (producer) {
+            while (!g_mpmc.push(v)) std::this_thread::yield();
+        } else {
+            while (!g_mpmc.pop(v)) std::this_thread::yield();
+            benchmark::DoNotOptimize(v);
+        }
+    }
+    if (!producer) state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_MpmcThroughput)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+ 
+template <typename Ring>
+static void BM_RoundTrip(benchmark::State& state) {
+    Ring ping(64), pong(64);
+    std::atomic<bool> run{true};
+    std::thread echo([&] {
+        uint64_t v;
+        while (run.load(std::memory_order_relaxed)) {
+            if (ping.pop(v)) {
+                while (!pong.push(v)) {}
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t v = 0;
+    for (auto _ : state) {
+        ping.push(v);
+        while (!pong.pop(v)) std::this_thread::yield();
+    }
+    run = false;
+    echo.join();
+}
+BENCHMARK_TEMPLATE(BM_RoundTrip, SpscRing<uint64_t>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RoundTrip, MpmcRing<uint64_t>)->UseRealTime();
@@ -0,0 +1,131 @@
+/**
+* @file
+* @brief Loopback packets-per-second: recvmmsg/sendmmsg (`UdpSocket`) vs io_uring (`IoUringSocket`).
+*
+* @details
+* Each benchmark moves one batch per iteration over 127.0.0.1 and reports
+* `items_per_second` (packets) plus the syscalls per batch on the io_uring side:
+*  - `BM_Tx<Backend>`  : sender under test, a `UdpSocket` drains in the same loop;
+*    `io_uring_sqpoll` submits through the kernel SQ polling thread.
+*  - `BM_Rx<Backend>`  : receiver under test, a `UdpSocket` feeds it in the same loop.
+*  - `BM_TxOnly<Mode>` : `UdpSocket` send cost alone, plain `sendmmsg` vs UDP GSO
+*    (`UDP_SEGMENT`); the receiver is never drained, so `items_per_second` (CPU
+*    time of the sending thread) is the pps one core can push into the stack.
+* The batch size is the benchmark argument (`BM_TxOnly`: batch, payload bytes).
+* io_uring/GSO variants are skipped when the kernel does not support them.
+*/
+#include <benchmark/benchmark.h>
+#include "udp/io_uring_socket.hpp"
+#include "udp/socket.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+#include <memory>
+ 
+using namespace udp;
+ 
+static std::unique_ptr<ISocket> make(SocketBackend b, int batch, benchmark::State& state, bool sqpoll = false) {
+    if (b == SocketBackend::IoUring) {
+        std::string why;
+        if (!IoUringSocket::supported(&why)) {
+            state.SkipWithError(("io_uring unsupported: " + why).c_str());
+            return nullptr;
+        }
+        auto s = std::make_unique<IoUringSocket>(batch, sqpoll);
+        if (sqpoll && !s->sqpoll()) {
+            state.SkipWithError("io_uring SQPOLL refused");
+            return nullptr;
+        }
+        return s;
+    }
+    return std::make_unique<UdpSocket>(batch);
+}
+ 
+static void fill(PacketSlab& slab, size_t n, size_t len) {
+    for (size_t i = 0; i < n; ++i) slab[i].len = static_cast<uint32_t>(len);
+    slab.set_size(n);
+}
+ 
+static void report_enters(benchmark::State& state, const ISocket& s) {
+    if (auto* u = dynamic_cast<const IoUringSocket*>(&s))
+        state.counters["enters/batch"] = benchmark::Counter(
+            static_cast<double>(u->enter_calls()) / static_cast<double>(state.iterations()));
+}
+ 
+static void BM_Tx(benchmark::State& state, SocketBackend backend, bool sqpoll = false) {
+    const int batch = static_cast<int>(state.range(0));
+    auto tx = make(backend, batch, state, sqpoll);
+    if (!tx) return;
+    UdpSocket rx(batch);
+    rx.bind(0, false);
+    rx.set_rcvbuf(8 << 20);
+    tx->connect("127.0.0.1", local_port(rx));
+    PacketSlab out(batch, 64), in(batch, 2048);
+    fill(out, batch, 64);
+ 
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        ssize_t s = tx->send_batch(out);
+        if (s > 0) sent += static_cast<uint64_t>(s);
+        while (rx.recv_batch(in) > 0) {}
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    report_enters(state, *tx);
+}
+ 
+static void BM_Rx(benchmark::State& state, SocketBackend backend) {
+    const int batch = static_cast<int>(state.range(0));
+    auto rx = make(backend, batch, state);
+    if (!rx) return;
+    rx->bind(0, false);
+    rx->set_rcvbuf(8 << 20);
+    UdpSocket tx(batch);
+    tx.connect("127.0.0.1", local_port(*rx));
+    PacketSlab out(batch, 64), in(batch, 2048);
+    fill(out, batch, 64);
+ 
+    uint64_t got = 0;
+    for (auto _ : state) {
+        ssize_t want = tx.send_batch(out);
+        for (ssize_t have = 0; have < want;) {
+            ssize_t r = rx->recv_batch(in);
+            if (r > 0) have += r;
+            if (r < 0) break;
+        }
+        got += static_cast<uint64_t>(want > 0 ? want : 0);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(got));
+    report_enters(state, *rx);
+}
+ 
+static void BM_TxOnly(benchmark::State& state, bool gso) {
+    const int batch = static_cast<int>(state.range(0));
+    const size_t payload = static_cast<size_t>(state.range(1));
+    UdpSocket rx(batch), tx(batch);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    tx.set_sndbuf(8 << 20);
+    if (gso && !tx.set_gso(true)) {
+        state.SkipWithError("UDP_SEGMENT unsupported");
+        return;
+    }
+    PacketSlab out(batch, payload);
+    fill(out, batch, payload);
+ 
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        ssize_t s = tx.send_batch(out);
+        if (s > 0) sent += static_cast<uint64_t>(s);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    state.SetBytesProcessed(static_cast<int64_t>(sent * payload));
+}
+ 
+BENCHMARK_CAPTURE(BM_TxOnly, mmsg, false)->Args({64, 64})->Args({64, 1200});
+BENCHMARK_CAPTURE(BM_TxOnly, gso, true)->Args({64, 64})->Args({64, 1200});
+BENCHMARK_CAPTURE(BM_Tx, mmsg, SocketBackend::Mmsg)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_Tx, io_uring, SocketBackend::IoUring)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_Tx, io_uring_sqpoll, SocketBackend::IoUring, true)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_Rx, mmsg, SocketBackend::Mmsg)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_Rx, io_uring, SocketBackend::IoUring)->Arg(16)->Arg(64);
+ 
+BENCHMARK_MAIN();
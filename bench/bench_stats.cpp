@@ -0,0 +1,148 @@
+/**
+* @file
+* @brief Stats microbenchmarks: cost of recording into, and reading, the latency histograms.
+*
+* @details
+*  - `BM_HistogramRecord` : one @ref udp::Stats::record_latency per iteration with
+*    values spread over 1 µs .. 1 ms; the time per iteration is the per-sample
+*    hot-path cost.
+*  - `BM_HistogramMerge` : merge one populated shard into a fresh @ref udp::Stats
+*    (what a `/metrics` scrape or a summary does once per shard).
+*  - `BM_CountersPerPacket/threads:<n>` vs `BM_CountersPerBatch/threads:<n>` :
+*    accounting for a 64-datagram batch. The first is the old scheme, with
+*    packet and byte counters in adjacent atomics and two `fetch_add`s per
+*    datagram. The second uses one @ref udp::Stats shard, a plain add per batch,
+*    and cache-line-separated groups. With two threads, thread 0 does receive
+*    accounting and thread 1 send accounting on the same object, as a server's
+*    RX and echo paths do. Items are datagrams, so ns/item is the per-packet
+*    cost.
+*  - `BM_NoteClientMutex/<clients>` vs `BM_NoteClient/<clients>` : one
+*    per-datagram client update, cycling over @c clients senders. The first is
+*    the old scheme, a mutex around an @c unordered_map; the second is the
+*    lock-free @ref udp::ClientTable behind @ref udp::Stats::note_client.
+*  - `BM_SeqWindow/<gap_every>` : @ref udp::SeqWindow::observe per datagram, in
+*    order except that every @c gap_every-th sequence is skipped (0: never).
+*/
+#include <benchmark/benchmark.h>
+#include "udp/stats.hpp"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+ 
+using namespace udp;
+ 
+static void BM_HistogramRecord(benchmark::State& state) {
+    Stats s;
+    uint64_t v = 1'000;
+    for (auto _ : state) {
+        s.record_latency(Latency::OneWay, v);
+        v = v < 1'000'000 ? v + 997 : 1'000;
+    }
+    benchmark::DoNotOptimize(s.latency(Latency::OneWay).count());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord);
+ 
+static void BM_HistogramMerge(benchmark::State& state) {
+    Stats shard;
+    for (uint64_t v = 1'000; v < 1'000'000; v += 997) shard.record_latency(Latency::OneWay, v);
+    for (auto _ : state) {
+        Stats snap;
+        snap.merge_from(shard);
+        benchmark::DoNotOptimize(snap.one_way_count());
+    }
+}
+BENCHMARK(BM_HistogramMerge);
+ 
+/// \cond INTERNAL
+/// @brief The counter layout before sharding: four adjacent atomics.
+struct AdjacentCounters {
+    std::atomic<uint64_t> sent{0}, recv{0}, rx_bytes{0}, tx_bytes{0};
+};
+static AdjacentCounters g_adjacent;
+static Stats g_shard;
+static constexpr size_t kBatch = 64;
+/// \endcond
+ 
+static void BM_CountersPerPacket(benchmark::State& state) {
+    const bool rx = state.thread_index() == 0;
+    for (auto _ : state) {
+        for (size_t i=0; i<kBatch; ++i) {
+            if (rx) {
+                g_adjacent.recv.fetch_add(1, std::memory_order_relaxed);
+                g_adjacent.rx_bytes.fetch_add(64 + i, std::memory_order_relaxed);
+            } else {
+                g_adjacent.sent.fetch_add(1, std::memory_order_relaxed);
+                g_adjacent.tx_bytes.fetch_add(64 + i, std::memory_order_relaxed);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+BENCHMARK(BM_CountersPerPacket)->Threads(1)->Threads(2);
+ 
+static void BM_CountersPerBatch(benchmark::State& state) {
+    const bool rx = state.thread_index() == 0;
+    for (auto _ : state) {
+        uint64_t n = 0, bytes = 0;
+        for (size_t i=0; i<kBatch; ++i) {
+            n++;
+            bytes += 64 + i;
+            benchmark::DoNotOptimize(bytes);
+        }
+        if (rx) {
+            g_shard.inc_recv(n);
+            g_shard.add_rx_bytes(bytes);
+        } else {
+            g_shard.inc_sent(n);
+            g_shard.add_tx_bytes(bytes);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+BENCHMARK(BM_CountersPerBatch)->Threads(1)->Threads(2);
+ 
+static void BM_NoteClientMutex(benchmark::State& state) {
+    std::mutex mu;
+    std::unordered_map<ClientKey, uint64_t, ClientKeyHash> clients;
+    const uint16_t n = static_cast<uint16_t>(state.range(0));
+    uint16_t port = 0;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lg(mu);
+        clients[ClientKey{0x7f000001, port}]++;
+        if (++port == n) port = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NoteClientMutex)->Arg(1)->Arg(1000);
+ 
+static void BM_NoteClient(benchmark::State& state) {
+    Stats s;
+    const uint16_t n = static_cast<uint16_t>(state.range(0));
+    uint16_t port = 0;
+    for (auto _ : state) {
+        s.note_client(0x7f000001, port);
+        if (++port == n) port = 0;
+    }
+    benchmark::DoNotOptimize(s.unique_clients());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NoteClient)->Arg(1)->Arg(1000);
+ 
+static void BM_SeqWindow(benchmark::State& state) {
+    const uint64_t gap_every = static_cast<uint64_t>(state.range(0));
+    SeqWindow w;
+    SeqCounts d;
+    uint64_t seq = 0, until_gap = gap_every;
+    for (auto _ : state) {
+        seq += 1;
+        if (gap_every && --until_gap == 0) {
+            until_gap = gap_every;
+            seq += 1;
+        }
+        w.observe(seq, d);
+    }
+    benchmark::DoNotOptimize(d.lost);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SeqWindow)->Arg(0)->Arg(100);
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+ 
+/**
+* @file
+* @brief CPU affinity and NUMA placement helpers for worker threads and their memory.
+*
+* NUMA topology is read straight from sysfs (no libnuma): node CPU lists from
+* `/sys/devices/system/node`, a NIC's node from `/sys/class/net/<if>/device/numa_node`,
+* and memory is steered with the raw @c mbind system call.
+*
+* @note Linux-only in effect; elsewhere @ref udp::allowed_cpus returns an empty list,
+*       node lookups return -1 and pinning/binding fails, so callers simply run
+*       unpinned on whatever memory the allocator gives them.
+*/
+ 
+namespace udp {
+ 
+/**
+* @brief CPUs the calling process may run on (its @c sched_getaffinity mask), ascending.
+* @return Empty if the mask cannot be read.
+*/
+std::vector<int> allowed_cpus();
+ 
+/**
+* @brief Pin the calling thread to a single CPU.
+* @param cpu CPU index as reported by @ref allowed_cpus.
+* @return false (errno set) if the kernel rejected the mask.
+*/
+bool pin_current_thread(int cpu);
+ 
+/**
+* @brief Switch the calling thread to the @c SCHED_FIFO real-time class.
+* @param priority 1 (lowest) to 99.
+* @return false (errno set) for an out-of-range priority, or @c EPERM without
+*         @c CAP_SYS_NICE / a sufficient @c RLIMIT_RTPRIO.
+* @warning A FIFO thread that spins is never preempted by normal threads on its
+*          CPU; keep such threads on cores reserved for them.
+*/
+bool set_current_thread_fifo(int priority);
+ 
+/**
+* @brief Parse a kernel CPU/node list such as "0-3,8,10-11" (sysfs and @c taskset syntax).
+* @return Listed ids in the order given; empty if @p list is malformed.
+*/
+std::vector<int> parse_cpu_list(const std::string& list);
+ 
+/// @brief Online NUMA nodes, ascending (empty if the system exposes none).
+std::vector<int> numa_nodes();
+ 
+/// @brief CPUs of NUMA node @p node, ascending (empty if unknown).
+std::vector<int> node_cpus(int node);
+ 
+/// @brief NUMA node of @p cpu, or -1 if unknown.
+int cpu_numa_node(int cpu);
+ 
+/**
+* @brief NUMA node the network interface @p ifname is attached to.
+* @return -1 if unknown, e.g. for virtual interfaces (loopback, veth) or
+*         single-node machines that report -1.
+*/
+int nic_numa_node(const std::string& ifname);
+ 
+/**
+* @brief Restrict the calling thread to the CPUs of NUMA node @p node.
+* @return false (errno set) if the node is unknown or the kernel rejected the mask.
+*/
+bool pin_current_thread_to_node(int node);
+ 
+/**
+* @brief Prefer node @p node for the pages of `[addr, addr + len)` (@c MPOL_PREFERRED).
+*
+* @details Only affects pages faulted in afterwards, so call it before touching
+* the memory. @p addr must be page-aligned.
+* @return false (errno set) if the policy could not be applied.
+*/
+bool bind_memory_to_node(void* addr, size_t len, int node);
+ 
+/**
+* @brief Page-granular, zero-filled allocation placed on node @p node.
+* @param node Target node; -1 allocates without a placement policy.
+* @return nullptr on failure. Release with @ref free_on_node and the same @p bytes.
+*/
+void* alloc_on_node(size_t bytes, int node);
+ 
+/// @brief Release memory from @ref alloc_on_node.
+void free_on_node(void* p, size_t bytes);
+ 
+} // namespace udp
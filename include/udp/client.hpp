@@ -8,11 +8,17 @@
 
 #include <memory>
 
+#include <string>
+
 #include "udp/socket.hpp"
 
 #include "udp/stats.hpp"
 
 #include "udp/common.hpp"
+
+#include "udp/pacer.hpp"
+
+#include "udp/traffic_profile.hpp"
  
 /**
 
@@ -44,11 +50,15 @@
 
 * @par Pacing & batching
 
-* The send loop distributes @ref ClientConfig::pps over time using a monotonic clock
+* Each send loop releases packets through a @ref Pacer: a batch is spread over its
+
+* time slot in small chunks, released by a sleep-then-spin wait on the monotonic
+
+* clock (see @ref udp::now_ns), with a configurable policy for catching up after a
 
-* (see @ref udp::now_ns). When supported by the socket implementation, messages are sent
+* stall. When supported by the socket implementation, each chunk goes out in one
 
-* in batches (e.g., via @c sendmmsg) to reduce syscall overhead and sustain high PPS.
+* batch call (e.g., via @c sendmmsg) to reduce syscall overhead and sustain high PPS.
 
 *
 
@@ -86,6 +96,14 @@ namespace udp {
 
 * - @ref verbose   : If true, prints periodic rate/counter lines to stdout.
 
+* - @ref threads   : Sender threads, one socket each; @ref pps is split between them.
+
+* - @ref pace_chunk, @ref pace_spin_us, @ref catch_up : @ref Pacer knobs.
+
+* - @ref profile   : Time-varying schedule; when set it replaces @ref pps and @ref seconds.
+
+* - @ref rtt       : Closed loop: read the server's echoes and measure round-trip time.
+
 */
 
 struct ClientConfig {
@@ -106,6 +124,34 @@ struct ClientConfig {
 
     bool        verbose   = false;       ///< Enable periodic logging if true.
 
+    bool        gso       = false;       ///< Send through UDP GSO (falls back to plain sends if unsupported).
+
+    bool        zerocopy  = false;       ///< Send with MSG_ZEROCOPY (falls back to copying sends if unsupported).
+
+    BusyPoll    busy_poll;               ///< Kernel busy polling for receives on the client socket (e.g. echoes).
+
+    bool        hugepages = true;        ///< Build send slabs in a hugepage @ref PacketPool (falls back to THP, then plain pages).
+
+    std::string nic;                     ///< Interface traffic leaves on; the send thread and its pool stay on its NUMA node (empty = no preference).
+
+    std::vector<int> cpu_list;           ///< CPUs for the send threads in order, wrapping (empty = affinity mask; overrides @ref nic).
+
+    int         rt_priority = 0;         ///< @c SCHED_FIFO priority for the send threads (0 = normal scheduling).
+
+    int         threads   = 1;           ///< Sender threads / sockets (set from the socket count by the constructor).
+
+    size_t      pace_chunk = 0;          ///< Packets per paced send (0 = auto, ~10 µs of traffic; capped at @ref batch).
+
+    int         pace_spin_us = 20;       ///< Busy-wait window before each send deadline (µs).
+
+    CatchUp     catch_up  = CatchUp::Cap;///< What a sender does after falling behind schedule.
+
+    TrafficProfile profile;              ///< Rate schedule (empty = constant @ref pps for @ref seconds).
+
+    bool        rtt       = false;       ///< Receive echoes (server `--echo`) and record round-trip times.
+
+    int         rtt_linger_ms = 200;     ///< After the last send, wait at most this long for outstanding echoes.
+
 };
  
 /**
@@ -140,6 +186,72 @@ struct ClientConfig {
 
 * - The loop exits when the configured duration elapses or when @ref stop() is called.
 
+*
+
+* Sender threads (shared-nothing):
+
+* - Each socket passed to the constructor gets its own sender: a thread, a
+
+*   connected socket (so its own source port), its own @c seq space starting at 1,
+
+*   a @ref Stats shard and a send-slab pool. The target @ref ClientConfig::pps is
+
+*   split evenly, so N threads together still aim for the configured rate.
+
+* - With more than one sender (or an explicit @ref ClientConfig::cpu_list), sender
+
+*   @c t is pinned to the @c t-th listed or allowed CPU, wrapping around; with
+
+*   @ref ClientConfig::nic on a known NUMA node the allowed CPUs are limited to it.
+
+* - @ref stats merges the shards on read; @ref thread_stats exposes one shard.
+
+*   The verbose line is printed by sender 0 for all of them.
+
+*
+
+* Traffic profiles:
+
+* - With a non-empty @ref ClientConfig::profile the run lasts the profile's
+
+*   duration, and every sender samples the profile before each send and feeds
+
+*   its share of the target (same split as @ref ClientConfig::pps, which is set
+
+*   to the profile's peak) into its @ref Pacer, including Poisson gaps.
+
+* - Packets sent during a @c warmup phase reach the server but are left out of
+
+*   @ref stats and the pacing error; @ref warmup_sent counts them.
+
+*
+
+* Closed loop (@ref ClientConfig::rtt):
+
+* - After every send, a sender drains its socket in batches (a few receive calls,
+
+*   never blocking) and matches each echo to the packet it sent by
+
+*   @ref PacketHeader::seq, through a window of the last @ref kRttWindow sends.
+
+* - Round-trip time ends at the kernel RX timestamp of the echo (pickup time if
+
+*   the socket has none), so echoes waiting while the sender sleeps are not
+
+*   charged for the wait. @ref rtt measures from @ref PacketHeader::send_ts_ns;
+
+*   @ref rtt_corrected measures from the pacer's intended send time, which
+
+*   corrects for coordinated omission: a stalled sender does not hide the delay
+
+*   its late packets experience.
+
+* - After the last send, echoes are drained for up to
+
+*   @ref ClientConfig::rtt_linger_ms. Echoes that match no outstanding packet
+
+*   (too old, duplicated, foreign) are counted in @ref unmatched_echoes.
+
 */
 
 class UdpClient {
@@ -162,6 +274,16 @@ public:
 
     explicit UdpClient(std::unique_ptr<ISocket> sock, ClientConfig cfg);
  
+    /**
+
+     * @brief One sender thread per socket, all aimed at the same server.
+
+     * @throws std::invalid_argument if @p socks is empty.
+
+     */
+
+    UdpClient(std::vector<std::unique_ptr<ISocket>> socks, ClientConfig cfg);
+ 
     /**
 
      * @brief Destructor; ensures the worker thread is stopped and joined.
@@ -210,47 +332,165 @@ public:
  
     /**
 
-     * @brief Read-only access to cumulative counters.
+     * @brief Snapshot of the cumulative counters, merged over all sender shards.
 
      *
 
-     * @return Const reference to internal @ref Stats (sent/recv, bytes, clients).
+     * @return @ref Stats copy (sent, bytes, zero-copy completions).
 
      */
 
-    const Stats& stats() const { return stats_; }
+    Stats stats() const;
+ 
+    /// @brief Number of sender threads (sockets).
+
+    size_t threads() const { return senders_.size(); }
+ 
+    /// @brief Stats shard of sender @p t (read-only, live).
+
+    const Stats& thread_stats(size_t t) const { return senders_.at(t)->stats; }
+ 
+    /// @brief CPU sender @p t is pinned to (-1 if unpinned).
+
+    int thread_cpu(size_t t) const { return senders_.at(t)->cpu; }
+ 
+    /// @brief Packets per second sender @p t aims for.
+
+    uint64_t thread_pps(size_t t) const { return senders_.at(t)->pps; }
+ 
+    /// @brief Sends remembered per sender for matching echoes (older echoes are unmatched).
+
+    static constexpr size_t kRttWindow = size_t{1} << 16;
+ 
+    /// @brief Round-trip time from @ref PacketHeader::send_ts_ns (ns), over all senders (@ref Latency::RttRaw).
+
+    LatencyHistogram rtt() const;
+ 
+    /// @brief Round-trip time from the intended send time (ns, coordinated-omission corrected; @ref Latency::Rtt).
+
+    LatencyHistogram rtt_corrected() const;
+ 
+    /// @brief Echoes matched to a sent packet, over all senders.
+
+    uint64_t echoes() const;
+ 
+    /// @brief Echoes that matched no outstanding packet, over all senders.
+
+    uint64_t unmatched_echoes() const;
+ 
+    /// @brief Counted packets per second actually sent (sum over senders of sent / time since warm-up).
+
+    double achieved_pps() const;
+ 
+    /// @brief Packets sent during warm-up phases (not in @ref stats), over all senders.
+
+    uint64_t warmup_sent() const;
+ 
+    /// @brief Pacing error (scheduled vs actual release, ns) merged over all senders.
+
+    LatencyHistogram pacing_error() const;
+ 
+    /// @brief Packet slots dropped by the catch-up policy, over all senders.
+
+    uint64_t pacing_skipped() const;
+ 
+    /// @brief Pacer of sender @p t (read-only, live).
+
+    const Pacer& thread_pacer(size_t t) const { return *senders_.at(t)->pacer; }
+ 
+    /// @brief One-line summary of the merged counters and pacing error for logs.
+
+    std::string summary() const;
  
 private:
 
+    /// @brief Everything one send loop touches, on its own cache lines.
+
+    struct alignas(kCacheLine) Sender {
+
+        std::unique_ptr<ISocket> sock;   ///< Connected socket (own source port).
+
+        Stats                    stats;  ///< This sender's shard.
+
+        uint64_t                 seq = 0;///< Last sequence number sent.
+
+        TxCompletions            tx_seen;///< Completion counters already added to @ref stats.
+
+        uint64_t                 pps = 0;///< This sender's share of @ref ClientConfig::pps.
+
+        int                      cpu = -1;
+
+        size_t                   index = 0;
+
+        std::unique_ptr<Pacer>   pacer;  ///< Release schedule at @ref pps.
+
+        std::atomic<uint64_t>    warmup_sent{0}; ///< Packets left out of @ref stats.
+
+        std::atomic<uint64_t>    t_begin{0};     ///< Start of the counted sends (ns).
+
+        std::atomic<uint64_t>    t_end{0};       ///< Last send done (ns; 0 while sending).
+
+        std::atomic<uint64_t>    echoes{0};
+
+        std::atomic<uint64_t>    unmatched{0};
+
+        std::thread              th;     ///< Runs @ref run_loop.
+
+    };
+ 
     /**
 
      * @brief Background send loop: pacing + batch send + counter updates.
 
      *
 
-     * Uses a monotonic clock (@ref now_ns) to space out batches so that the total
+     * Waits on the sender's @ref Pacer so that its packets per second approach
 
-     * number of packets per second approaches @ref ClientConfig::pps. On each
+     * its share of @ref ClientConfig::pps, then stamps as many pre-built
 
-     * iteration it prepares up to @ref ClientConfig::batch payloads and calls
+     * datagrams as the pacer released and calls @ref ISocket::send_batch.
 
-     * @ref ISocket::send_batch. Counters are updated using relaxed atomics.
+     * Counters are updated using relaxed atomics.
 
      */
 
-    void run_loop();
+    void run_loop(Sender& s);
  
-    std::unique_ptr<ISocket> sock_; ///< Injected socket strategy (owned).
+    /// @brief Intended send time of one outstanding sequence number (0 = not measured).
 
-    ClientConfig             cfg_;  ///< Immutable client configuration copy.
+    struct Intended {
 
-    Stats                    stats_;///< Hot-path counters (relaxed atomics).
+        uint64_t seq = 0;
 
-    std::thread              th_;   ///< Worker thread running @ref run_loop().
+        uint64_t due = 0;
 
-    std::atomic<bool>        running_{false}; ///< Run flag observed by @ref run_loop().
+    };
+ 
+    /**
 
-    uint64_t                 seq_{0};         ///< Sequence number for generated packets.
+     * @brief Receive pending echoes on @p s's socket into @p rx and record their RTT.
+
+     * @return Echoes matched.
+
+     */
+
+    size_t drain_echoes(Sender& s, PacketSlab& rx, std::vector<Intended>& sent);
+ 
+    /**
+
+     * @brief Reap zero-copy completions into @p s's stats until send @p token is released.
+
+     * @details Returns early if @ref stop() is requested.
+
+     */
+
+    void reclaim_tx(Sender& s, uint64_t token);
+ 
+    ClientConfig             cfg_;  ///< Immutable client configuration copy.
+
+    std::vector<std::unique_ptr<Sender>> senders_;
+
+    std::atomic<bool>        running_{false}; ///< Run flag observed by @ref run_loop().
 
 };
  
@@ -26,6 +26,10 @@
 
 *
 
+* It also holds @ref udp::kCacheLine, the padding unit shared by the lock-free types.
+
+*
+
 * @note All functions here are thread-safe and lock-free.
 
 * @warning The wire layout does not perform endian conversion; see notes on @ref udp::PacketHeader.
@@ -125,6 +129,18 @@ struct PacketHeader {
 */
 
 static constexpr uint32_t kMagic = 0xC0DEF00D;
+
+/**
+
+* @brief Cache-line size assumed for padding and alignment (x86-64 and most ARM64 cores).
+
+*
+
+* Every structure that separates writers onto their own lines aligns to this.
+
+*/
+
+static constexpr size_t kCacheLine = 64;
  
 /**
 
@@ -0,0 +1,159 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "udp/common.hpp"
+ 
+/**
+* @file
+* @brief Log-linear latency histogram (@ref udp::LatencyHistogram).
+*
+* Values (nanoseconds) are bucketed HDR-style: exact below 64, then every power
+* of two is split into 32 equal sub-buckets, so a bucket never spans more than
+* ~3% of its values. Recording is an index computation (one count-leading-zeros)
+* and a few relaxed stores; quantiles walk the fixed bucket array.
+*/
+ 
+namespace udp {
+ 
+/**
+* @brief Fixed-size log-linear histogram of nanosecond values.
+*
+* @details
+* - Values up to @ref kMaxValue (~18 minutes) keep their ~3% resolution; larger
+*   ones are counted in the last bucket. The exact maximum is kept separately.
+* - Quantiles report the highest value of the bucket they fall in (never less
+*   than the true quantile by more than one bucket width).
+*
+* @note Thread-safety: one writer thread calls @ref record; any thread may read
+*       concurrently (relaxed loads, so a reader can see a record half-applied,
+*       e.g. the count updated but not yet the sum). @ref merge_from is a reader
+*       of its argument. Instances are cache-line aligned, so neighbouring
+*       histograms with different writers do not share a line.
+*/
+class alignas(kCacheLine) LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 5;                      ///< log2 of sub-buckets per power of two.
+    static constexpr uint64_t kSub = uint64_t{1} << kSubBits;    ///< 32 sub-buckets.
+    static constexpr unsigned kMaxBits = 40;                     ///< Values below 2^40 ns keep full resolution.
+    static constexpr uint64_t kMaxValue = (uint64_t{1} << kMaxBits) - 1;
+    static constexpr size_t   kBuckets = 2 * kSub + (kMaxBits - kSubBits - 1) * kSub;
+ 
+    LatencyHistogram() = default;
+ 
+    /// @brief Snapshot copy (see @ref merge_from).
+    LatencyHistogram(const LatencyHistogram& o) { merge_from(o); }
+ 
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+ 
+    /// @brief Bucket holding @p v (values above @ref kMaxValue map to the last one).
+    static size_t bucket_of(uint64_t v) {
+        if (v < 2 * kSub) return static_cast<size_t>(v);
+        if (v > kMaxValue) v = kMaxValue;
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        const unsigned shift = msb - kSubBits;
+        return static_cast<size_t>((msb - kSubBits) * kSub + (v >> shift));
+    }
+ 
+    /// @brief Smallest value counted in bucket @p b.
+    static uint64_t bucket_low(size_t b) {
+        if (b < 2 * kSub) return b;
+        const uint64_t shift = b / kSub - 1;
+        return (b % kSub + kSub) << shift;
+    }
+ 
+    /// @brief Largest value counted in bucket @p b.
+    static uint64_t bucket_high(size_t b) {
+        if (b < 2 * kSub) return b;
+        return bucket_low(b) + (uint64_t{1} << (b / kSub - 1)) - 1;
+    }
+ 
+    /// @brief Count one value (single writer).
+    void record(uint64_t v) { record_n(v, 1); }
+ 
+    /// @brief Count @p n occurrences of @p v (single writer).
+    void record_n(uint64_t v, uint64_t n) {
+        bump(counts_[bucket_of(v)], n);
+        bump(count_, n);
+        bump(sum_, v * n);
+        if (v > max_.load(std::memory_order_relaxed)) max_.store(v, std::memory_order_relaxed);
+    }
+ 
+    /**
+     * @brief Add every bucket of @p o into this histogram.
+     * @warning Uses read-modify-write on this object: do not run it concurrently
+     *          with @ref record on the same object. @p o must not be this object.
+     */
+    void merge_from(const LatencyHistogram& o) {
+        for (size_t b=0; b<kBuckets; ++b) {
+            const uint64_t c = o.counts_[b].load(std::memory_order_relaxed);
+            if (c) counts_[b].fetch_add(c, std::memory_order_relaxed);
+        }
+        count_.fetch_add(o.count(), std::memory_order_relaxed);
+        sum_.fetch_add(o.sum(), std::memory_order_relaxed);
+        const uint64_t m = o.max();
+        if (m > max_.load(std::memory_order_relaxed)) max_.store(m, std::memory_order_relaxed);
+    }
+ 
+    /// @brief Values recorded.
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Sum of recorded values (wraps after ~584 years of nanoseconds).
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Largest value recorded (0 if empty).
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Mean of recorded values (0 if empty).
+    double mean() const {
+        const uint64_t n = count();
+        return n ? static_cast<double>(sum()) / static_cast<double>(n) : 0.0;
+    }
+ 
+    /// @brief Count in bucket @p b.
+    uint64_t bucket_count(size_t b) const { return counts_[b].load(std::memory_order_relaxed); }
+ 
+    /**
+     * @brief Values recorded at or below @p v, to bucket resolution: the whole
+     *        bucket holding @p v counts (so up to ~3% above @p v may be included).
+     */
+    uint64_t count_at_or_below(uint64_t v) const {
+        uint64_t n = 0;
+        for (size_t b=0, last=bucket_of(v); b<=last; ++b) n += counts_[b].load(std::memory_order_relaxed);
+        return n;
+    }
+ 
+    /**
+     * @brief Value at percentile @p p (0..100), e.g. 99.9.
+     * @return Highest value of the bucket holding the rank, capped at @ref max;
+     *         0 if empty.
+     */
+    uint64_t percentile(double p) const {
+        uint64_t total = 0;
+        for (size_t b=0; b<kBuckets; ++b) total += counts_[b].load(std::memory_order_relaxed);
+        if (!total) return 0;
+        p = std::min(std::max(p, 0.0), 100.0);
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (size_t b=0; b<kBuckets; ++b) {
+            seen += counts_[b].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(bucket_high(b), max());
+        }
+        return max();
+    }
+ 
+private:
+    static void bump(std::atomic<uint64_t>& a, uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+ 
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+ 
+} // namespace udp
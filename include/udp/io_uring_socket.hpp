@@ -0,0 +1,180 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "udp/socket.hpp"
+ 
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+ 
+/**
+* @file
+* @brief io_uring-based @ref udp::ISocket adapter (multishot receive, batched send).
+*
+* This header defines @ref udp::IoUringSocket, a drop-in alternative to
+* @ref udp::UdpSocket that talks to the kernel through a shared submission/completion
+* ring instead of one @c recvmmsg/@c sendmmsg syscall per batch:
+*  - **RX:** one multishot @c IORING_OP_RECVMSG request stays armed on the socket and
+*    the kernel picks receive buffers from a registered provided-buffer ring. Each
+*    datagram shows up as a completion in shared memory, so a receive loop that finds
+*    completions waiting performs no syscall at all.
+*  - **TX:** one @c IORING_OP_SEND (connected) or @c IORING_OP_SENDMSG (per-packet
+*    destination) SQE per datagram, submitted together with a single
+*    @c io_uring_enter. With @c sqpoll enabled the kernel polling thread picks them up
+*    and the sender polls the CQ instead of entering the kernel (given a spare core
+*    for the poller; see @c --io-uring-sqpoll).
+*
+* The implementation uses the raw @c io_uring_setup/@c io_uring_enter/@c io_uring_register
+* syscalls (no liburing dependency). Construction throws @c std::runtime_error when the
+* running kernel lacks a required feature; @ref udp::create_socket uses that to fall
+* back to @ref udp::UdpSocket.
+*
+* @note Thread-safety: like @ref udp::UdpSocket, one owning thread per instance.
+*/
+ 
+namespace udp {
+ 
+/**
+* @brief UDP socket whose batch I/O goes through io_uring.
+*
+* @par Receive buffers
+* The slab flavor of @ref recv_batch does not copy payloads: the returned views point
+* into socket-owned provided buffers. Those buffers are handed back to the kernel at
+* the start of the next @ref recv_batch call, so views stay valid until then (long
+* enough to inspect and echo a batch).
+*/
+class IoUringSocket : public ISocket {
+public:
+    static constexpr unsigned kRxBuffers = 1024;      ///< Provided receive buffers (power of two).
+    static constexpr unsigned kRxBufSize = 2048 + 64; ///< Bytes per buffer: recvmsg header + address + payload.
+ 
+    /**
+     * @brief Create the socket and the ring.
+     * @param batch_hint Expected messages per batch; sizes the submission queue.
+     * @param sqpoll     Request a kernel SQ polling thread (zero-syscall submission).
+     *                   Silently dropped if the kernel refuses it.
+     * @throws std::runtime_error if io_uring, provided buffer rings or multishot
+     *         receive are unavailable.
+     */
+    explicit IoUringSocket(int batch_hint = 64, bool sqpoll = false);
+ 
+    /// @brief Cancel outstanding requests, unmap the rings and close both fds.
+    ~IoUringSocket() override;
+ 
+    IoUringSocket(const IoUringSocket&) = delete;
+    IoUringSocket& operator=(const IoUringSocket&) = delete;
+ 
+    /**
+     * @brief Probe whether this kernel supports everything the backend needs.
+     * @param why Optional out-parameter receiving the reason on failure.
+     */
+    static bool supported(std::string* why = nullptr);
+ 
+    /// @copydoc ISocket::fd()
+    int fd() const override { return sockfd_; }
+ 
+    /// @brief The ring fd: receive completions are posted there, not on the socket.
+    int wait_fd() const override { return ring_fd_; }
+ 
+    /// @copydoc ISocket::bind(uint16_t,bool)
+    void bind(uint16_t port, bool reuseport) override;
+ 
+    /// @copydoc ISocket::connect(const std::string&,uint16_t)
+    void connect(const std::string& ip, uint16_t port) override;
+ 
+    /// @copydoc ISocket::recv_batch(std::vector<std::vector<uint8_t>>&)
+    ssize_t recv_batch(std::vector<std::vector<uint8_t>>& bufs) override;
+ 
+    /// @copydoc ISocket::send_batch(const std::vector<std::vector<uint8_t>>&,const sockaddr_in*)
+    ssize_t send_batch(const std::vector<std::vector<uint8_t>>& bufs,
+                       const sockaddr_in* addr = nullptr) override;
+ 
+    /// @copydoc ISocket::recv_batch(PacketSlab&)
+    ssize_t recv_batch(PacketSlab& slab) override;
+ 
+    /// @copydoc ISocket::send_batch(const PacketSlab&,const sockaddr_in*)
+    ssize_t send_batch(const PacketSlab& slab, const sockaddr_in* addr = nullptr) override;
+ 
+    /// @copydoc ISocket::set_rcvbuf(int)
+    void set_rcvbuf(int bytes) override;
+ 
+    /// @copydoc ISocket::set_sndbuf(int)
+    void set_sndbuf(int bytes) override;
+ 
+    /// @brief Number of @c io_uring_enter calls made so far (for benchmarks/diagnostics).
+    uint64_t enter_calls() const { return enter_calls_; }
+ 
+    /// @brief Whether the kernel SQ polling thread is active.
+    bool sqpoll() const { return sqpoll_; }
+ 
+private:
+    /// @brief One receive completion not yet handed to the caller.
+    struct RxCompletion {
+        uint16_t bid; ///< Provided buffer id.
+        int32_t  res; ///< Bytes written into the buffer (header + name + payload).
+    };
+ 
+    void setup_ring(unsigned entries, bool sqpoll);
+    void setup_buffers();
+    void teardown();
+    int  enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+    io_uring_sqe* next_sqe();
+    int  submit(unsigned min_complete);
+    void arm_recv();
+    void reap();
+    void recycle_buffers();
+    ssize_t take_rx(PacketView* out, size_t max);
+    io_uring_sqe* prep_send(size_t i, const uint8_t* data, uint32_t len, const sockaddr_in* dst);
+    ssize_t finish_sends(unsigned n);
+ 
+    int sockfd_;                ///< UDP socket.
+    int ring_fd_;               ///< io_uring instance.
+    bool connected_;            ///< Whether @ref connect succeeded (TX uses plain SEND).
+    bool sqpoll_;               ///< Kernel SQ polling thread active.
+    bool rx_armed_;             ///< Multishot recvmsg currently armed.
+    sockaddr_in peer_{};        ///< Connected peer.
+ 
+    // Shared ring memory (mmap'ed from ring_fd_).
+    void*  sq_ring_;            ///< SQ ring mapping.
+    void*  cq_ring_;            ///< CQ ring mapping (may alias @ref sq_ring_).
+    size_t sq_ring_sz_;         ///< SQ ring mapping size.
+    size_t cq_ring_sz_;         ///< CQ ring mapping size.
+    io_uring_sqe* sqes_;        ///< SQE array mapping.
+    size_t sqes_sz_;            ///< SQE array mapping size.
+    unsigned* sq_head_;         ///< Kernel-owned SQ head.
+    unsigned* sq_tail_;         ///< User-owned SQ tail.
+    unsigned* sq_flags_;        ///< SQ flags (NEED_WAKEUP, CQ_OVERFLOW).
+    unsigned  sq_mask_;         ///< SQ index mask.
+    unsigned  sq_entries_;      ///< SQ capacity.
+    unsigned* cq_head_;         ///< User-owned CQ head.
+    unsigned* cq_tail_;         ///< Kernel-owned CQ tail.
+    unsigned  cq_mask_;         ///< CQ index mask.
+    io_uring_cqe* cqes_;        ///< CQE array.
+    unsigned  sq_local_tail_;   ///< SQEs prepared but not yet published.
+    unsigned  sq_pending_;      ///< Published SQEs not yet submitted with io_uring_enter.
+ 
+    // Provided buffer ring for multishot receive.
+    io_uring_buf_ring* br_;     ///< Registered buffer ring.
+    size_t   br_sz_;            ///< Buffer ring mapping size.
+    uint8_t* rx_bufs_;          ///< kRxBuffers * kRxBufSize bytes of receive buffers.
+    msghdr   rx_msg_{};         ///< Template msghdr for the multishot recvmsg.
+    std::vector<RxCompletion> rx_ready_;   ///< Reaped receive completions (ring of kRxBuffers).
+    size_t   rx_ready_head_;    ///< Oldest entry in @ref rx_ready_.
+    size_t   rx_ready_count_;   ///< Entries in @ref rx_ready_.
+    int      rx_error_;         ///< errno of the last failed multishot receive (0 if none).
+    std::vector<uint16_t> rx_recycle_;     ///< Buffer ids to return on the next receive.
+    std::vector<PacketView> rx_scratch_;   ///< Views used by the vector receive flavor.
+ 
+    // TX bookkeeping.
+    std::vector<msghdr> tx_msgs_; ///< Per-SQE msghdr for SENDMSG.
+    std::vector<iovec>  tx_iov_;  ///< Per-SQE iovec for SENDMSG.
+    unsigned tx_inflight_;        ///< Send SQEs awaiting completion.
+    unsigned tx_ok_;              ///< Successful send completions of the current batch.
+    uint64_t enter_calls_;        ///< io_uring_enter syscalls issued.
+};
+ 
+} // namespace udp
@@ -2,6 +2,7 @@
 #include <thread>
 #include <atomic>
 #include <string>
+#include <functional>
 #include "udp/stats.hpp"
  
 /**
@@ -24,7 +25,7 @@
 *
 * @note Thread-safety: one instance is typically owned and controlled by a single
 *       thread. The background thread only *reads* from @ref udp::Stats via its
-*       lock-free getters; @ref Stats::unique_clients() may take a short mutex.
+*       lock-free getters, so a scrape never blocks a receive loop.
 */
  
 namespace udp {
@@ -52,6 +53,18 @@ public:
      */
     MetricsHttpServer(Stats& stats, uint16_t port);
  
+    /**
+     * @brief Construct a metrics server fed by a collect callback.
+     * @param collect Invoked on the server thread for every scrape with an empty
+     *                @ref udp::Stats; it merges the live (e.g. per-worker) shards in
+     *                (see @ref Stats::merge_from). Must stay valid while running.
+     * @param port    TCP port to listen on (host byte order).
+     * @param extra   Optional: returns additional exposition lines (e.g. labelled
+     *                per-worker series) appended after the standard counters.
+     */
+    MetricsHttpServer(std::function<void(Stats&)> collect, uint16_t port,
+                      std::function<std::string()> extra = {});
+ 
     /**
      * @brief Destructor; ensures the background thread is stopped and joined.
      *
@@ -66,6 +79,13 @@ public:
      */
     void start();
  
+    /**
+     * @brief Pin the listener thread to @p cpu (-1 = unpinned) from its next @ref start.
+     *
+     * Keeps scrapes off the cores that run receive loops.
+     */
+    void set_cpu(int cpu) { cpu_ = cpu; }
+ 
     /**
      * @brief Request a graceful shutdown and join the thread (idempotent).
      *
@@ -85,15 +105,17 @@ private:
     /**
      * @brief Build the current metrics payload as a plaintext string.
      *
-     * @details Formats counters from @ref stats_ into a simple, line-oriented
+     * @details Formats counters from a @ref collect_ snapshot into a simple, line-oriented
      *          representation (e.g., Prometheus exposition style). The snapshot
      *          is not transactional across all counters but is sufficient for
      *          human-readable logs and periodic scraping.
      */
     std::string render();
  
-    Stats& stats_;               ///< Live source of counters to expose.
+    std::function<void(Stats&)> collect_; ///< Fills a snapshot of the counters to expose.
+    std::function<std::string()> extra_;  ///< Extra exposition lines (may be empty).
     uint16_t port_;              ///< TCP port to listen on.
+    int cpu_ = -1;               ///< CPU for the listener thread (-1 = unpinned).
     std::thread th_;             ///< Background server thread.
     std::atomic<bool> running_{false}; ///< Run flag observed by @ref run().
 };
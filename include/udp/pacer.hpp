@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "udp/histogram.hpp"
+ 
+/**
+* @file
+* @brief Send-side pacing (@ref udp::Pacer): when to send, and how many packets.
+*
+* Sending a whole batch back-to-back and then sleeping puts line-rate bursts of
+* @c batch packets on the wire, and a thread that fell behind (preempted, slow
+* syscall) catches up with one unbounded burst. The pacer instead:
+*  - **Spreads** a batch over its time slot: each wake-up releases a *chunk* of
+*    packets, sized so that chunks are ~10 µs apart (1 packet per send below
+*    100 kpps), never more than the send slab holds.
+*  - **Sleeps, then spins:** @c clock_nanosleep (with 1 ns timer slack) until
+*    @ref udp::PacerConfig::spin_ns before the deadline, then busy-waits on the
+*    monotonic clock. The sleep's wake-up jitter (tens of µs) is absorbed by the
+*    spin window, so sends start within a few µs of their slot.
+*  - **Catches up per policy** (@ref udp::CatchUp) when the schedule is already
+*    behind at wake-up.
+*  - **Measures itself:** the delay between each chunk's scheduled and actual
+*    release goes into a @ref udp::LatencyHistogram (the pacing error).
+*
+* The rate can change at any time (@ref udp::Pacer::set_rate), which is how a
+* @ref udp::TrafficProfile drives it, and gaps can be exponential instead of even
+* (Poisson arrivals, @ref udp::Pacer::set_poisson).
+*/
+ 
+namespace udp {
+ 
+/// @brief What a @ref Pacer does when it wakes up with several chunks overdue.
+enum class CatchUp {
+    Burst, ///< Send everything owed, up to one full slab per call, until back on schedule.
+    Cap,   ///< Keep at most @ref PacerConfig::max_backlog packets owed; forgive the rest.
+    Skip   ///< Forgive every missed slot; send one chunk and resume the schedule from now.
+};
+ 
+/**
+* @brief Parse a CLI catch-up name ("burst", "cap" or "skip").
+* @return false if @p name is unknown (@p out is left untouched).
+*/
+bool parse_catch_up(const std::string& name, CatchUp& out);
+ 
+/// @brief CLI name of @p c (inverse of @ref parse_catch_up).
+const char* catch_up_name(CatchUp c);
+ 
+/// @brief Pacer knobs.
+struct PacerConfig {
+    double   pps = 10000;                ///< Target packets per second (<= 0: paused).
+    size_t   chunk = 0;                  ///< Packets per on-time send (0 = auto, ~10 µs of traffic).
+    size_t   max_chunk = 64;             ///< Most packets one call may release (send slab capacity).
+    uint64_t spin_ns = 20'000;           ///< Busy-wait this long before a deadline instead of sleeping.
+    CatchUp  catch_up = CatchUp::Cap;    ///< Policy when behind schedule.
+    size_t   max_backlog = 0;            ///< @ref CatchUp::Cap: packets of backlog kept (0 = @ref max_chunk).
+    bool     poisson = false;            ///< Exponentially distributed gaps with mean `1e9 / pps`.
+};
+ 
+/**
+* @brief Release schedule for one sender thread.
+*
+* @details Packets are due every `1e9 / pps` ns from @ref start. @ref wait blocks
+* until the next chunk is due and returns how many packets to send now:
+* - On schedule it returns the chunk size (@ref chunk).
+* - Behind schedule (more than a chunk overdue) the policy decides: @ref CatchUp::Burst
+*   returns up to @ref PacerConfig::max_chunk per call until the debt is paid;
+*   @ref CatchUp::Cap first drops debt beyond @ref PacerConfig::max_backlog;
+*   @ref CatchUp::Skip drops all of it. Dropped slots are counted in @ref skipped.
+* - Paused (rate <= 0) it sleeps about a millisecond and returns 0.
+* - With Poisson gaps, each packet's gap is drawn from an exponential
+*   distribution. A chunk still leaves together, so arrivals are Poisson down to
+*   the chunk spacing (~10 µs with the auto chunk size); use a chunk of 1 for
+*   per-packet arrivals at moderate rates.
+*
+* Each non-zero return records `now - due` of the oldest owed packet (before
+* the policy forgives any) in @ref error. The caller sends exactly the returned number of packets (sending
+* fewer, e.g. on a full socket buffer, just puts it behind schedule).
+*
+* @note Thread-safety: @ref wait, @ref start and @ref set_rate belong to the
+*       sending thread; @ref error, @ref skipped and @ref rate may be read from any
+*       thread.
+*/
+class Pacer {
+public:
+    /// @brief Longest sleep while paused, so rate changes and stop requests are seen.
+    static constexpr uint64_t kIdleNs = 1'000'000;
+ 
+    /// @brief Set up the schedule; call @ref start on the sending thread before @ref wait.
+    explicit Pacer(const PacerConfig& cfg);
+ 
+    Pacer(const Pacer&) = delete;
+    Pacer& operator=(const Pacer&) = delete;
+ 
+    /**
+     * @brief Begin the schedule at @p now_ns (first packet due then) and lower the
+     *        calling thread's timer slack to 1 ns, so its sleeps end on time.
+     */
+    void start(uint64_t now_ns);
+ 
+    /// @brief Wait until the next chunk is due. @return Packets to send now (0 while paused).
+    size_t wait();
+ 
+    /**
+     * @brief Change the target rate from the next packet on.
+     * @details The schedule continues from the current due time; resuming from a
+     *          pause restarts it at the current time (no catch-up for the pause).
+     */
+    void set_rate(double pps);
+ 
+    /// @brief Switch between even (false) and exponential (true) gaps from the next chunk on.
+    void set_poisson(bool on) { cfg_.poisson = on; }
+ 
+    /// @brief Stop (false) or resume (true) recording into @ref error, e.g. during a warm-up.
+    void set_measuring(bool on) { measure_ = on; }
+ 
+    /**
+     * @brief Scheduled send time (ns, monotonic) of the first packet released by
+     *        the last @ref wait; packet @c i of that chunk was due about
+     *        `released_due() + i * interval_ns()` (exact for even gaps).
+     * @details This is the intended send time that coordinated-omission-corrected
+     *          latency is measured from: a sender that stalls still owes the
+     *          packets it should have sent, and their latency clock is already running.
+     */
+    uint64_t released_due() const { return due_; }
+ 
+    /// @brief Mean gap between packets at the current rate (ns; 0 while paused).
+    double interval_ns() const { return interval_; }
+ 
+    /// @brief Current target packets per second.
+    double rate() const { return rate_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Packets per on-time send at the current rate.
+    size_t chunk() const { return chunk_; }
+ 
+    /// @brief Packet slots dropped by the catch-up policy.
+    uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Scheduled-to-actual release delay per chunk (ns).
+    const LatencyHistogram& error() const { return error_; }
+ 
+    /// @brief Auto chunk size for @p pps: ~10 µs of packets, within [1, @p max_chunk].
+    static size_t auto_chunk(double pps, size_t max_chunk);
+ 
+    /// @brief Sleep (relative @c clock_nanosleep) to @p deadline - @p spin_ns, then spin until @p deadline.
+    static void sleep_until(uint64_t deadline, uint64_t spin_ns);
+ 
+private:
+    void skip(uint64_t n);
+ 
+    /// @brief Time until the next of @p n packets: @p n intervals, or a sum of exponential gaps.
+    double gaps(size_t n);
+ 
+    PacerConfig            cfg_;
+    double                 interval_ = 0;   ///< ns between packets (0 while paused).
+    double                 next_ = 0;       ///< Due time of the next packet (ns, monotonic).
+    uint64_t               due_ = 0;        ///< Due time of the last released chunk's first packet.
+    size_t                 chunk_ = 1;
+    size_t                 backlog_ = 1;    ///< Effective @ref PacerConfig::max_backlog.
+    bool                   measure_ = true;
+    uint64_t               rng_ = 0;        ///< xorshift64* state for Poisson gaps.
+    std::atomic<double>    rate_{0};
+    std::atomic<uint64_t>  skipped_{0};
+    LatencyHistogram       error_;
+};
+ 
+} // namespace udp
@@ -0,0 +1,227 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "udp/common.hpp"
+ 
+/**
+* @file
+* @brief Hugepage-backed pool of fixed-size packet buffers with refcounted handles.
+*
+* This header defines:
+*  - @ref udp::PacketPool : one anonymous mapping carved into cache-line-aligned
+*    slots, handed out through a lock-free free list.
+*  - @ref udp::PacketHandle : a refcounted reference to one slot. Copies share the
+*    slot; the last one to go away returns it to the pool, on whatever thread that
+*    happens. Handles can therefore be passed between threads (e.g. over a
+*    @ref udp::SpscRing) without copying payload bytes.
+*
+* Backing memory, in order of preference (@ref udp::PoolBacking):
+*  - @c MAP_HUGETLB 2 MiB pages from the hugetlbfs reserve
+*    (`vm.nr_hugepages`); one TLB entry covers 1024 2 KiB slots.
+*  - Regular pages aligned to 2 MiB and advised with @c MADV_HUGEPAGE, so that
+*    transparent hugepages can back them when THP is set to `madvise` or `always`.
+*  - Plain 4 KiB pages.
+*
+* The mapping size is rounded up to the page size in use, and the rounding slack
+* becomes extra slots, so @ref udp::PacketPool::slots can exceed the request.
+*
+* A pool can be placed on one NUMA node: the mapping gets an @c MPOL_PREFERRED
+* policy for that node before its pages are first touched.
+*/
+ 
+namespace udp {
+ 
+class PacketPool;
+ 
+/// @brief Memory a @ref PacketPool ended up on.
+enum class PoolBacking {
+    HugeTlb, ///< Explicit hugepages (@c MAP_HUGETLB).
+    Thp,     ///< Regular mapping advised for transparent hugepages.
+    Pages    ///< Regular pages only.
+};
+ 
+/// @brief Metrics/CLI name of @p b ("hugetlb", "thp" or "pages").
+const char* backing_name(PoolBacking b);
+ 
+/**
+* @brief Shared reference to one @ref PacketPool slot.
+*
+* @details Copying bumps the slot's reference count (relaxed); destroying or
+* @ref reset drops it (acquire-release), and the last reference returns the slot
+* to the free list. A default-constructed handle is empty.
+*
+* @note Thread-safety: distinct handle objects may be used concurrently even when
+*       they share a slot; one handle object is not meant for concurrent use.
+*       Handles must not outlive their pool.
+*/
+class PacketHandle {
+public:
+    PacketHandle() = default;
+    PacketHandle(const PacketHandle& o);
+    PacketHandle(PacketHandle&& o) noexcept : pool_(o.pool_), idx_(o.idx_) { o.pool_ = nullptr; }
+    PacketHandle& operator=(const PacketHandle& o);
+    PacketHandle& operator=(PacketHandle&& o) noexcept;
+    ~PacketHandle() { reset(); }
+ 
+    /// @brief Drop this reference (returns the slot to the pool if it was the last).
+    void reset();
+ 
+    /// @brief Whether the handle refers to a slot.
+    explicit operator bool() const { return pool_ != nullptr; }
+ 
+    /// @brief First byte of the slot (nullptr if empty).
+    uint8_t* data() const;
+ 
+    /// @brief Slot size in bytes (0 if empty).
+    size_t capacity() const;
+ 
+    /// @brief Slot index within the pool.
+    uint32_t index() const { return idx_; }
+ 
+    /// @brief References currently held on the slot (0 if empty).
+    uint32_t use_count() const;
+ 
+private:
+    friend class PacketPool;
+    PacketHandle(PacketPool* pool, uint32_t idx) : pool_(pool), idx_(idx) {}
+ 
+    PacketPool* pool_ = nullptr;
+    uint32_t    idx_ = 0;
+};
+ 
+/**
+* @brief Fixed-size packet buffers in one hugepage-friendly mapping.
+*
+* @details
+* - Slots are @ref slot_size bytes apart (the requested size rounded up to 64
+*   bytes) and start on cache lines.
+* - Free slots form a Treiber stack of slot indices. The head packs a 32-bit
+*   index with a 32-bit modification tag, so a stale compare-and-swap after an
+*   intervening pop/push (ABA) fails. A fresh pool hands slots out in ascending
+*   order, so buffers allocated together are also adjacent in memory.
+* - @ref alloc never blocks: on exhaustion it returns an empty handle and counts
+*   an allocation failure.
+*
+* @note Thread-safety: every member may be called from any thread.
+*/
+class PacketPool {
+public:
+    /// @brief Explicit hugepage size assumed for @c MAP_HUGETLB and THP alignment.
+    static constexpr size_t kHugePage = 2u << 20;
+ 
+    /**
+     * @brief Map a pool of at least @p slots buffers of at least @p slot_size bytes.
+     * @param hugepages Try @c MAP_HUGETLB and THP first (false: plain pages only).
+     * @param node NUMA node to place the pages on (-1: no placement policy). If
+     *        the policy cannot be applied the pool still works, and @ref node
+     *        reports -1.
+     * @throws std::runtime_error if no mapping could be created.
+     */
+    PacketPool(size_t slots, size_t slot_size, bool hugepages = true, int node = -1);
+ 
+    /// @brief Unmap the region. Outstanding handles must be gone.
+    ~PacketPool();
+ 
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+ 
+    /// @brief Take a free slot (reference count 1), or an empty handle if none is left.
+    PacketHandle alloc();
+ 
+    /// @brief Number of slots.
+    size_t slots() const { return slots_; }
+ 
+    /// @brief Distance in bytes between two slots.
+    size_t slot_size() const { return stride_; }
+ 
+    /// @brief Slots currently handed out.
+    size_t in_use() const { return in_use_.load(std::memory_order_relaxed); }
+ 
+    /// @brief @ref alloc calls that found the pool empty.
+    uint64_t alloc_failures() const { return failures_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Memory the pool ended up on.
+    PoolBacking backing() const { return backing_; }
+ 
+    /// @brief Page size of the mapping (@ref kHugePage unless backed by plain pages).
+    size_t page_size() const { return page_; }
+ 
+    /// @brief Mapped bytes (a multiple of @ref page_size).
+    size_t bytes() const { return bytes_; }
+ 
+    /// @brief Pages (i.e. TLB entries) needed to cover the whole pool.
+    size_t pages() const { return bytes_ / page_; }
+ 
+    /// @brief NUMA node the pages were placed on (-1 if no policy was applied).
+    int node() const { return node_; }
+ 
+    /// @brief One-line summary for logs.
+    std::string to_string() const;
+ 
+private:
+    friend class PacketHandle;
+    static constexpr uint32_t kNil = 0xffffffffu;
+ 
+    uint8_t* slot(uint32_t idx) const { return base_ + static_cast<size_t>(idx) * stride_; }
+ 
+    /// @brief Return slot @p idx to the free list.
+    void release(uint32_t idx);
+ 
+    uint8_t*    map_ = nullptr;  ///< Start of the mapping (for munmap).
+    size_t      map_len_ = 0;    ///< Length of the mapping.
+    uint8_t*    base_ = nullptr; ///< First slot (page-aligned).
+    size_t      bytes_ = 0;
+    size_t      page_ = 0;
+    size_t      stride_ = 0;
+    size_t      slots_ = 0;
+    PoolBacking backing_ = PoolBacking::Pages;
+    int         node_ = -1;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_; ///< Free-list link per slot.
+    std::unique_ptr<std::atomic<uint32_t>[]> refs_; ///< Reference count per slot.
+    alignas(kCacheLine) std::atomic<uint64_t> head_{0}; ///< (tag << 32) | top free index.
+    alignas(kCacheLine) std::atomic<size_t>   in_use_{0};
+    std::atomic<uint64_t>             failures_{0};
+};
+ 
+inline uint8_t* PacketHandle::data() const { return pool_ ? pool_->slot(idx_) : nullptr; }
+ 
+inline size_t PacketHandle::capacity() const { return pool_ ? pool_->stride_ : 0; }
+ 
+inline uint32_t PacketHandle::use_count() const {
+    return pool_ ? pool_->refs_[idx_].load(std::memory_order_relaxed) : 0;
+}
+ 
+inline PacketHandle::PacketHandle(const PacketHandle& o) : pool_(o.pool_), idx_(o.idx_) {
+    if (pool_) pool_->refs_[idx_].fetch_add(1, std::memory_order_relaxed);
+}
+ 
+inline PacketHandle& PacketHandle::operator=(const PacketHandle& o) {
+    if (this != &o) {
+        if (o.pool_) o.pool_->refs_[o.idx_].fetch_add(1, std::memory_order_relaxed);
+        reset();
+        pool_ = o.pool_;
+        idx_ = o.idx_;
+    }
+    return *this;
+}
+ 
+inline PacketHandle& PacketHandle::operator=(PacketHandle&& o) noexcept {
+    if (this != &o) {
+        reset();
+        pool_ = o.pool_;
+        idx_ = o.idx_;
+        o.pool_ = nullptr;
+    }
+    return *this;
+}
+ 
+inline void PacketHandle::reset() {
+    if (!pool_) return;
+    if (pool_->refs_[idx_].fetch_sub(1, std::memory_order_acq_rel) == 1) pool_->release(idx_);
+    pool_ = nullptr;
+}
+ 
+} // namespace udp
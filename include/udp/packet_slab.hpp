@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <netinet/in.h>
+#include "udp/common.hpp"
+#include "udp/packet_pool.hpp"
+ 
+/**
+* @file
+* @brief Contiguous, cache-line-aligned packet storage for batch socket I/O.
+*
+* This header defines:
+*  - @ref udp::PacketView : a span-like descriptor (pointer, length, peer address)
+*    for one datagram inside a slab.
+*  - @ref udp::PacketSlab : fixed-stride slots, either carved from one aligned
+*    allocation or borrowed from a @ref udp::PacketPool, plus one @ref PacketView
+*    per slot.
+*
+* The slab replaces @c std::vector<std::vector<uint8_t>> on the hot path: every
+* datagram of a batch lives in the same block at a predictable offset, so a batch
+* touches a handful of contiguous cache lines and never calls the allocator after
+* construction.
+*/
+ 
+namespace udp {
+ 
+/**
+* @brief Non-owning view of one datagram stored in a @ref PacketSlab.
+*
+* @details
+* - On receive, @ref len is the datagram length reported by the kernel and
+*   @ref addr is the source address.
+* - On send, @ref len is the number of bytes to transmit and @ref addr is the
+*   destination used when the socket is unconnected and no per-call address is given.
+* - @ref rx_ts_ns is the kernel receive timestamp when the socket has RX
+*   timestamps enabled (see @ref ISocket::set_rx_timestamps), converted to the
+*   @ref now_ns (steady clock) time base so it can be compared with
+*   @ref PacketHeader::send_ts_ns and with user-space readings; 0 otherwise.
+*/
+struct PacketView {
+    uint8_t*    data = nullptr; ///< First byte of the datagram (inside the owning slab).
+    uint32_t    len  = 0;       ///< Valid bytes at @ref data.
+    sockaddr_in addr{};         ///< Peer address (source on RX, destination on TX).
+    uint64_t    rx_ts_ns = 0;   ///< Kernel RX timestamp (steady-clock ns), 0 if unavailable.
+};
+ 
+/**
+* @brief Fixed-stride packet slab: one aligned block, @c capacity() slots, one view per slot.
+*
+* @details
+* - Slot stride is the requested slot size rounded up to a multiple of
+*   @ref kCacheLine, and the block itself is cache-line aligned, so every slot
+*   starts on its own cache line.
+* - A pool-backed slab holds one @ref PacketHandle per slot instead of its own
+*   block; the slots go back to the pool with the slab.
+* - The first @ref size() views are the "valid" packets of the current batch.
+*   Views are plain descriptors: reordering or compacting them (e.g., to keep only
+*   admitted packets for an echo) never moves payload bytes.
+* - Sockets call @ref reset_views before receiving so that view @c i points at
+*   slot @c i again with a zero length.
+*
+* @note Thread-safety: a slab is owned by one thread at a time.
+*/
+class PacketSlab {
+public:
+    /**
+     * @brief Allocate @p slots slots of at least @p slot_size bytes each (zero-filled).
+     * @throws std::bad_alloc if the block cannot be allocated.
+     */
+    PacketSlab(size_t slots, size_t slot_size);
+ 
+    /**
+     * @brief Borrow @p slots slots from @p pool (which must outlive the slab).
+     * @throws std::bad_alloc if the pool has fewer free slots.
+     */
+    PacketSlab(PacketPool& pool, size_t slots);
+ 
+    /// @brief Release the slab memory.
+    ~PacketSlab();
+ 
+    PacketSlab(const PacketSlab&) = delete;
+    PacketSlab& operator=(const PacketSlab&) = delete;
+ 
+    /// @brief Number of slots (maximum packets per batch).
+    size_t capacity() const { return slots_; }
+ 
+    /// @brief Distance in bytes between two consecutive slots.
+    size_t slot_size() const { return stride_; }
+ 
+    /// @brief Number of valid packets in the current batch.
+    size_t size() const { return size_; }
+ 
+    /// @brief Set the number of valid packets (clamped to @ref capacity()).
+    void set_size(size_t n) { size_ = n < slots_ ? n : slots_; }
+ 
+    /// @brief Raw pointer to slot @p i (independent of view ordering).
+    uint8_t* slot(size_t i) { return slot_ptr_[i]; }
+ 
+    /// @brief Const raw pointer to slot @p i.
+    const uint8_t* slot(size_t i) const { return slot_ptr_[i]; }
+ 
+    /// @brief Mutable view @p i.
+    PacketView& operator[](size_t i) { return views_[i]; }
+ 
+    /// @brief Const view @p i.
+    const PacketView& operator[](size_t i) const { return views_[i]; }
+ 
+    /// @brief Iterators over the valid views @c [0, size()).
+    PacketView* begin() { return views_.data(); }
+    PacketView* end() { return views_.data() + size_; }
+    const PacketView* begin() const { return views_.data(); }
+    const PacketView* end() const { return views_.data() + size_; }
+ 
+    /**
+     * @brief Point view @c i back at slot @c i with zero length, and clear @ref size().
+     *
+     * @details Called by socket implementations before a receive so that any
+     * reordering done while processing the previous batch is undone.
+     */
+    void reset_views() {
+        for (size_t i = 0; i < slots_; ++i) {
+            views_[i].data = slot(i);
+            views_[i].len = 0;
+            views_[i].rx_ts_ns = 0;
+        }
+        size_ = 0;
+    }
+ 
+private:
+    uint8_t*                base_;   ///< Cache-line-aligned start of the owned block (nullptr if pool-backed).
+    std::vector<uint8_t*>   slot_ptr_; ///< Start of each slot.
+    std::vector<PacketHandle> handles_; ///< Borrowed pool slots (pool-backed only).
+    size_t                  slots_;  ///< Slot count.
+    size_t                  stride_; ///< Bytes per slot (multiple of @ref kCacheLine).
+    size_t                  size_;   ///< Valid packets in the current batch.
+    std::vector<PacketView> views_;  ///< One view per slot.
+};
+ 
+} // namespace udp
@@ -0,0 +1,235 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "udp/common.hpp"
+ 
+/**
+* @file
+* @brief Bounded lock-free rings for handing packet handles between threads.
+*
+* Two queues over power-of-two arrays, both meant for small copyable elements
+* (slab pointers, buffer handles, batch descriptors) moving between the socket
+* layer, server workers and the metrics thread:
+*  - @ref udp::SpscRing : one producer, one consumer. The producer owns @c tail_,
+*    the consumer owns @c head_; each only reads the other's index (acquire) and
+*    publishes its own (release), so there are no locks and no read-modify-write
+*    instructions. Each side also caches the other's index and re-reads it only
+*    when the ring looks full (producer) or empty (consumer).
+*  - @ref udp::MpmcRing : any number of producers and consumers (Vyukov's bounded
+*    queue). Every slot carries a sequence number; a thread claims a slot with one
+*    compare-and-swap on the shared index and hands it over by bumping the slot's
+*    sequence.
+*
+* Both offer batch operations (@c push_n / @c pop_n). On the SPSC ring a batch
+* costs one index publication regardless of its size; on the MPMC ring it is a
+* loop of single operations that stops at the first failure.
+*
+* Indices and slots are aligned to @ref udp::kCacheLine so that the two sides,
+* or two neighbouring MPMC slots, never share a cache line.
+*/
+ 
+namespace udp {
+ 
+/// \cond INTERNAL
+/// @brief Smallest power of two >= @p n (minimum 2).
+inline size_t ring_capacity(size_t n) {
+    size_t cap = 2;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+/// \endcond
+ 
+/**
+* @brief Bounded single-producer/single-consumer ring.
+*
+* @tparam T Element type; cheap to copy (pointers, handles).
+*
+* @note Exactly one thread may call @ref push / @ref push_n and exactly one (other)
+*       thread may call @ref pop / @ref pop_n. @ref size may be read from any
+*       thread and is approximate.
+*/
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Create a ring holding at least @p capacity elements.
+     * @param capacity Requested capacity, rounded up to a power of two (minimum 2).
+     */
+    explicit SpscRing(size_t capacity)
+    : buf_(ring_capacity(capacity)), mask_(buf_.size() - 1) {}
+ 
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+ 
+    /// @brief Append @p v (producer only). @return false if the ring is full.
+    bool push(const T& v) { return push_n(&v, 1) == 1; }
+ 
+    /// @brief Remove the oldest element into @p out (consumer only). @return false if empty.
+    bool pop(T& out) { return pop_n(&out, 1) == 1; }
+ 
+    /**
+     * @brief Append up to @p n elements from @p items (producer only).
+     * @return Number appended (fewer than @p n when the ring fills up).
+     */
+    size_t push_n(const T* items, size_t n) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t room = buf_.size() - (tail - head_cache_);
+        if (room < n) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            room = buf_.size() - (tail - head_cache_);
+        }
+        if (n > room) n = room;
+        for (size_t i=0; i<n; ++i) buf_[(tail + i) & mask_] = items[i];
+        if (n) tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+ 
+    /**
+     * @brief Remove up to @p max of the oldest elements into @p out (consumer only).
+     * @return Number removed (0 if the ring was empty).
+     */
+    size_t pop_n(T* out, size_t max) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t avail = tail_cache_ - head;
+        if (avail < max) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            avail = tail_cache_ - head;
+        }
+        if (max > avail) max = avail;
+        for (size_t i=0; i<max; ++i) out[i] = buf_[(head + i) & mask_];
+        if (max) head_.store(head + max, std::memory_order_release);
+        return max;
+    }
+ 
+    /// @brief Elements currently queued (approximate when read concurrently).
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+ 
+    /// @brief Maximum number of queued elements.
+    size_t capacity() const { return buf_.size(); }
+ 
+private:
+    alignas(kCacheLine) std::atomic<size_t> head_{0}; ///< Next slot to pop (written by the consumer).
+    size_t tail_cache_ = 0;                            ///< Consumer's last view of @ref tail_.
+    alignas(kCacheLine) std::atomic<size_t> tail_{0}; ///< Next slot to push (written by the producer).
+    size_t head_cache_ = 0;                            ///< Producer's last view of @ref head_.
+    alignas(kCacheLine) std::vector<T> buf_;           ///< Storage (size is a power of two).
+    const size_t mask_;                                ///< @c buf_.size() - 1.
+};
+ 
+/**
+* @brief Bounded multi-producer/multi-consumer ring.
+*
+* @details Slot @c i starts with sequence @c i. A producer at position @c p may
+* fill slot `p & mask` once its sequence equals @c p, then sets it to `p + 1`; a
+* consumer at @c p may drain it once the sequence equals `p + 1`, then sets it
+* to `p + capacity` for the producer one lap later. Producers contend only on
+* @c tail_, consumers only on @c head_.
+*
+* @tparam T Element type; default-constructible and cheap to copy.
+*
+* @note Any thread may call any member. An element popped by one consumer is
+*       never seen by another; elements from one producer reach a given consumer
+*       in push order.
+*/
+template <typename T>
+class MpmcRing {
+public:
+    /**
+     * @brief Create a ring holding at least @p capacity elements.
+     * @param capacity Requested capacity, rounded up to a power of two (minimum 2).
+     */
+    explicit MpmcRing(size_t capacity)
+    : cap_(ring_capacity(capacity)), mask_(cap_ - 1), cells_(new Cell[cap_]) {
+        for (size_t i=0; i<cap_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+ 
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+ 
+    /// @brief Append @p v. @return false if the ring is full.
+    bool push(const T& v) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const size_t seq = c->seq.load(std::memory_order_acquire);
+            const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // slot still holds the element from one lap ago
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        c->value = v;
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+ 
+    /// @brief Remove the oldest available element into @p out. @return false if empty.
+    bool pop(T& out) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const size_t seq = c->seq.load(std::memory_order_acquire);
+            const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // producer has not filled this slot yet
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        out = c->value;
+        c->seq.store(pos + cap_, std::memory_order_release);
+        return true;
+    }
+ 
+    /// @brief Append up to @p n elements from @p items. @return Number appended.
+    size_t push_n(const T* items, size_t n) {
+        size_t i = 0;
+        while (i < n && push(items[i])) ++i;
+        return i;
+    }
+ 
+    /// @brief Remove up to @p max elements into @p out. @return Number removed.
+    size_t pop_n(T* out, size_t max) {
+        size_t i = 0;
+        while (i < max && pop(out[i])) ++i;
+        return i;
+    }
+ 
+    /// @brief Elements currently queued (approximate when read concurrently).
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+ 
+    /// @brief Maximum number of queued elements.
+    size_t capacity() const { return cap_; }
+ 
+private:
+    /// @brief One slot, alone on its cache line.
+    struct alignas(kCacheLine) Cell {
+        std::atomic<size_t> seq{0};
+        T value{};
+    };
+ 
+    alignas(kCacheLine) std::atomic<size_t> head_{0}; ///< Next position to pop (shared by consumers).
+    alignas(kCacheLine) std::atomic<size_t> tail_{0}; ///< Next position to push (shared by producers).
+    alignas(kCacheLine) const size_t cap_;             ///< Slot count (power of two).
+    const size_t mask_;                                ///< @c cap_ - 1.
+    std::unique_ptr<Cell[]> cells_;
+};
+ 
+} // namespace udp
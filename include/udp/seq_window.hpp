@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+ 
+/**
+* @file
+* @brief Per-sender sequence tracking (@ref udp::SeqWindow): loss, reordering and duplicates.
+*
+* Senders number their datagrams 1, 2, 3, ... in @ref udp::PacketHeader::seq.
+* A receiver keeps, per sender, the highest sequence seen and a bitmap of which
+* of the @ref udp::SeqWindow::kBits sequences below it have arrived:
+*  - **Ahead** of the highest: the skipped sequences are counted lost (for now),
+*    and their bits cleared as the window slides over them.
+*  - **Inside** the window, bit clear: a reordered datagram. It was counted lost
+*    when it was skipped, so the loss count goes back down by one.
+*  - **Inside** the window, bit set: a duplicate.
+*  - **Behind** the window: too old to tell apart from a duplicate; it is taken
+*    to be a very late reordered datagram.
+*
+* The common case (next sequence in order) is a compare, a shift and one bit
+* set, all within the sender's ~150-byte tracker.
+*/
+ 
+namespace udp {
+ 
+/**
+* @brief Changes to the sequence counters from a run of @ref SeqWindow::observe calls.
+*
+* @details Accumulated per batch and then added to @ref Stats in one go.
+* @c lost is signed: a batch may recover more reordered datagrams than it skips.
+*/
+struct SeqCounts {
+    int64_t  lost = 0;      ///< Sequences skipped and not (yet) seen.
+    uint64_t reordered = 0; ///< Datagrams that arrived after a higher sequence.
+    uint64_t duplicate = 0; ///< Datagrams whose sequence was already seen.
+    uint64_t invalid = 0;   ///< Datagrams without a valid @ref PacketHeader (short or wrong magic).
+ 
+    /// @brief Whether nothing changed.
+    bool empty() const { return !lost && !reordered && !duplicate && !invalid; }
+};
+ 
+/**
+* @brief Sliding-window sequence bitmap for one sender.
+*
+* @details Loss is not final while a sequence is still inside the window: a
+* late arrival turns it from lost into reordered. Sequences before the first
+* one observed are not counted as lost.
+*
+* @note Not thread-safe; owned by the worker that receives the sender's traffic.
+*/
+class SeqWindow {
+public:
+    static constexpr uint64_t kBits = 1024;  ///< Sequences remembered below the highest seen.
+ 
+    /// @brief Account datagram @p seq into @p d.
+    void observe(uint64_t seq, SeqCounts& d) {
+        if (!started_) {
+            started_ = true;
+            top_ = seq;
+            set(seq);
+            return;
+        }
+        if (seq > top_) {
+            const uint64_t gap = seq - top_;
+            if (gap >= kBits) {
+                bits_.fill(0);
+            } else {
+                for (uint64_t s = top_ + 1; s < seq; ++s) clear(s);
+            }
+            top_ = seq;
+            set(seq);
+            if (gap > 1) {
+                lost_ += gap - 1;
+                d.lost += static_cast<int64_t>(gap - 1);
+            }
+            return;
+        }
+        if (top_ - seq < kBits) {
+            if (test(seq)) { ++d.duplicate; return; }
+            set(seq);
+        }
+        ++d.reordered;
+        if (lost_) {
+            --lost_;
+            --d.lost;
+        }
+    }
+ 
+    /// @brief Highest sequence seen (0 before the first datagram).
+    uint64_t top() const { return top_; }
+ 
+    /// @brief Sequences currently counted lost for this sender.
+    uint64_t lost() const { return lost_; }
+ 
+private:
+    static constexpr size_t kWords = kBits / 64;
+ 
+    void set(uint64_t s) { bits_[(s / 64) % kWords] |= uint64_t{1} << (s % 64); }
+    void clear(uint64_t s) { bits_[(s / 64) % kWords] &= ~(uint64_t{1} << (s % 64)); }
+    bool test(uint64_t s) const { return bits_[(s / 64) % kWords] >> (s % 64) & 1; }
+ 
+    std::array<uint64_t, kWords> bits_{}; ///< Bit `s % kBits` set if sequence @c s arrived.
+    uint64_t top_ = 0;
+    uint64_t lost_ = 0;
+    bool     started_ = false;
+};
+ 
+} // namespace udp
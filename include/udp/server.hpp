@@ -10,10 +10,16 @@
 
 #include <thread>
 
+#include <chrono>
+
 #include <memory>
 
+#include <unordered_map>
+
 #include <unordered_set>
 
+#include <mutex>
+
 #include "udp/socket.hpp"
 
 #include "udp/stats.hpp"
@@ -21,6 +27,12 @@
 #include "udp/common.hpp"
 
 #include "udp/metrics_http.hpp"
+
+#include "udp/wait_strategy.hpp"
+
+#include "udp/ring.hpp"
+
+#include "udp/packet_pool.hpp"
  
 namespace udp {
  
@@ -44,15 +56,25 @@ namespace udp {
 
 *
 
-* @note Enforcing admission requires access to the source address. On Linux the
+* - @ref workers > 1 runs that many receive loops in one process, each on its own
 
-*       implementation uses `recvmmsg` with `msg_name` to capture per-message
+*   socket in one `SO_REUSEPORT` group (see @ref UdpServer).
 
-*       addresses. In environments where the raw socket fd is not available
+*
 
-*       (e.g., tests with @ref MockSocket) the server falls back to a mode where
+* - @ref pipeline splits every worker into an RX thread and a processing thread
 
-*       the limit cannot be enforced, but normal packet handling still works.
+*   joined by a ring of @ref ring_depth receive batches (see @ref UdpServer).
+
+*
+
+* @note Enforcing admission requires access to the source address. The server
+
+*       receives through `ISocket::recv_batch(PacketSlab&)`, whose views carry
+
+*       per-message addresses (`recvmmsg` `msg_name` on Linux, preloaded addresses
+
+*       for @ref MockSocket), so the limit is enforced for every socket type.
 
 */
 
@@ -72,6 +94,36 @@ struct ServerConfig {
 
     size_t   max_clients = 100;   ///< **Admission limit**: max distinct (IP:port) clients.
 
+    bool     gso = false;         ///< Echo through UDP GSO (falls back to plain sends if unsupported).
+
+    bool     gro = false;         ///< Receive through UDP GRO (falls back to plain reads if unsupported).
+
+    bool     zerocopy = false;    ///< Echo with MSG_ZEROCOPY (not combined with @ref gro).
+
+    bool     rx_timestamps = true;///< Kernel RX timestamps for queueing/processing/one-way delay stats.
+
+    WaitConfig wait;              ///< What the receive loop does when a receive comes back empty.
+
+    BusyPoll   busy_poll;         ///< Kernel busy polling for receives (all zero = interrupt-driven).
+
+    int        workers = 1;       ///< Receive loops / sockets (set from the socket count by the constructor).
+
+    Steering   steering = Steering::Kernel; ///< How the reuseport group spreads flows over workers.
+
+    bool       pipeline = false;  ///< Receive on a dedicated RX thread, process on another (needs @ref ISocket::split_io).
+
+    size_t     ring_depth = 256;  ///< Pipeline: receive batches buffered per worker between RX and processing.
+
+    bool       hugepages = true;  ///< Receive slabs from a hugepage @ref PacketPool (falls back to THP, then plain pages).
+
+    std::string nic;              ///< Interface traffic arrives on; workers are kept on its NUMA node (empty = no preference).
+
+    std::vector<int> cpu_list;    ///< Explicit CPUs for worker threads, in thread order (empty = process affinity mask).
+
+    int        metrics_cpu = -1;  ///< CPU for the `/metrics` thread (-1 = unpinned).
+
+    int        rt_priority = 0;   ///< @c SCHED_FIFO priority for worker threads (0 = normal scheduling).
+
 };
  
 /**
@@ -96,6 +148,140 @@ struct ServerConfig {
 
 *
 
+* Workers (shared-nothing):
+
+*  - Each socket passed to the constructor gets its own worker: a thread, a
+
+*    @ref WaitStrategy, an admission shard and a @ref Stats shard. With more than one
+
+*    socket, all are bound to the same port with `SO_REUSEPORT`, so the kernel hashes
+
+*    every flow to one worker and no packet state is shared between cores.
+
+*  - With more than one worker, worker @c i is pinned to the @c i-th CPU of the
+
+*    process affinity mask (wrapping around).
+
+*  - @ref ServerConfig::steering replaces the kernel's 4-tuple hash with a
+
+*    classic-BPF program (see @ref Steering). With @ref Steering::Cpu, worker @c i is
+
+*    pinned to a CPU @c c with `c % workers == i`, so each datagram is processed on
+
+*    the core that ran its receive softirq. A flow then follows its softirq CPU
+
+*    (an unpinned sender, RPS or irqbalance can move it), and each worker only sees
+
+*    its share of the client's sequence numbers: lost and reordered counts are
+
+*    overstated. The server warns about this at startup.
+
+*  - `/metrics` adds per-worker packet counts and rates and the imbalance ratio
+
+*    (@ref imbalance_ratio), to spot hot workers.
+
+*  - Shards are only combined when read: @ref stats and `/metrics` merge them
+
+*    (@ref Stats::merge_from). The only shared state is the admitted-client set,
+
+*    consulted when a worker sees a client for the first time (and, once full,
+
+*    read without a lock for rejected clients); a client reaching several workers
+
+*    (as @ref Steering::Cpu allows) still takes one admission slot.
+
+*
+
+* Pipeline mode (@ref ServerConfig::pipeline):
+
+*  - Each worker runs two threads. The RX thread only receives: it takes an empty
+
+*    slab from a pool of @ref ServerConfig::ring_depth, fills it with one
+
+*    `recv_batch` and pushes it onto an @ref SpscRing. The processing thread pops
+
+*    batches, does admission, stats and echo, and returns the slab to the pool
+
+*    through a second ring. A slow handler then backs up the ring instead of the
+
+*    socket receive buffer.
+
+*  - When the pool is exhausted (the ring is full), the RX thread keeps draining
+
+*    the socket into a spare slab and counts those datagrams as ring drops, so
+
+*    overload shows up in @ref ring_drops rather than as silent kernel drops.
+
+*  - The RX thread takes the worker's CPU pin and wait strategy; the processing
+
+*    thread spins for @ref WaitConfig::spin empty polls, then yields.
+
+*  - `/metrics` adds per-worker ring occupancy and drop series.
+
+*  - Needs sockets whose receive and send paths are independent
+
+*    (@ref ISocket::split_io); other sockets run the inline loop. GRO and
+
+*    zero-copy echo are not combined with pipeline mode.
+
+*
+
+* Packet memory:
+
+*  - Every receive slab is carved out of one @ref PacketPool, sized at
+
+*    construction for all workers and mapped on hugepages when
+
+*    @ref ServerConfig::hugepages allows. A batch then spans few TLB entries and
+
+*    the loops never allocate. `/metrics` reports the pool's slots, occupancy,
+
+*    allocation failures, backing and page count.
+
+*
+
+* NUMA placement:
+
+*  - Each worker's node is the node of the CPU it is pinned to. Its @ref Stats
+
+*    shard and admission set live in node-local memory, and its receive slabs
+
+*    come from a @ref PacketPool placed on that node (one pool per node in use).
+
+*  - With @ref ServerConfig::nic set and the interface reporting a node
+
+*    (`/sys/class/net/<if>/device/numa_node`), workers are pinned only to allowed
+
+*    CPUs of that node, even a single worker, so packets are received and processed
+
+*    next to the NIC's DMA buffers. Without local CPUs the full mask is kept.
+
+*  - The placement is logged at startup (verbose) and exported in `/metrics`.
+
+*
+
+* Explicit placement:
+
+*  - @ref ServerConfig::cpu_list replaces the affinity mask (and the NIC filter):
+
+*    worker threads take its entries in order, wrapping around. A pipelined
+
+*    worker takes two, first for its RX thread, then for its processing thread.
+
+*    Even a single worker is pinned.
+
+*  - @ref ServerConfig::metrics_cpu pins the `/metrics` thread, typically to a
+
+*    housekeeping core away from the receive loops.
+
+*  - @ref ServerConfig::rt_priority moves worker threads to @c SCHED_FIFO. If the
+
+*    kernel refuses (no @c CAP_SYS_NICE), a note is printed and they keep the
+
+*    normal scheduler.
+
+*
+
 * Admission semantics:
 
 *  - A "client" is the observed (IPv4 address, UDP port) of an incoming datagram.
@@ -108,11 +294,27 @@ struct ServerConfig {
 
 *
 
-* @note Admission relies on retrieving source addresses from the kernel via
+* Sequence tracking:
+
+*  - Every admitted datagram's @ref PacketHeader is checked: too short or with
+
+*    the wrong @ref kMagic counts as invalid (it is still served).
 
-*       `recvmmsg`/`recvfrom`. Where not available (e.g., @ref MockSocket),
+*  - Valid ones go through the client's @ref SeqWindow, which counts lost,
 
-*       the server continues to run but cannot enforce the cap.
+*    reordered and duplicate datagrams into the worker's @ref Stats.
+
+*  - Windows are per worker and are not merged, so the counts are only exact
+
+*    when a flow stays on one worker (every @ref Steering mode but
+
+*    @ref Steering::Cpu).
+
+*
+
+* @note Admission relies on the source address reported in each @ref PacketView
+
+*       of the receive slab.
 
 */
 
@@ -120,47 +322,285 @@ class UdpServer {
 
 public:
 
+    /// @brief Single-worker server on @p sock.
+
     explicit UdpServer(std::unique_ptr<ISocket> sock, ServerConfig cfg);
+ 
+    /**
+
+     * @brief One worker per socket, all bound to @ref ServerConfig::port.
+
+     * @throws std::invalid_argument if @p socks is empty.
+
+     */
+
+    UdpServer(std::vector<std::unique_ptr<ISocket>> socks, ServerConfig cfg);
 
     ~UdpServer();
  
-    /// @brief Start worker thread (and metrics if configured).
+    /// @brief Start worker threads (and metrics if configured).
 
     void start();
  
-    /// @brief Request stop and join worker thread; stop metrics.
+    /// @brief Request stop and join worker threads; stop metrics.
 
     void stop();
  
-    /// @brief Last computed packets-per-second (1s window).
+    /// @brief Last computed packets-per-second (1s window), summed over workers.
+
+    double last_rate_pps() const;
+ 
+    /// @brief Busy-poll settings read back from the (first) socket at construction.
+
+    const BusyPoll& busy_poll() const { return workers_.front()->busy; }
+ 
+    /// @brief UDP port the workers are bound to (resolved if configured as 0).
+
+    uint16_t port() const { return cfg_.port; }
+ 
+    /// @brief Number of workers (sockets).
+
+    size_t workers() const { return workers_.size(); }
+ 
+    /// @brief Snapshot of the cumulative stats, merged over all worker shards.
+
+    Stats stats() const;
+ 
+    /// @brief Receive rate of worker @p i over its last one-second window.
+
+    double worker_rate_pps(size_t i) const { return workers_.at(i)->rate_pps.load(std::memory_order_relaxed); }
+ 
+    /**
+
+     * @brief Load skew: busiest worker's rate divided by the mean worker rate.
+
+     * @return 1.0 for perfectly even load (and when idle), up to @ref workers() when
+
+     *         one worker takes everything.
+
+     */
+
+    double imbalance_ratio() const;
+ 
+    /// @brief Stats shard of worker @p i (read-only, live).
+
+    const Stats& worker_stats(size_t i) const { return workers_.at(i)->stats; }
+ 
+    /// @brief Whether worker @p i runs as an RX/processing thread pair.
+
+    bool pipelined(size_t i) const { return workers_.at(i)->pipe != nullptr; }
+ 
+    /// @brief Packet pool @p i (one per NUMA node in use; pool 0 serves worker 0).
+
+    const PacketPool& pool(size_t i = 0) const { return *pools_.at(i); }
+ 
+    /// @brief Number of packet pools.
+
+    size_t pools() const { return pools_.size(); }
+ 
+    /// @brief CPU worker @p i is pinned to (its RX thread in pipeline mode; -1 if unpinned).
+
+    int worker_cpu(size_t i) const { return workers_.at(i)->cpu; }
+ 
+    /// @brief CPU of worker @p i's processing thread (-1 if unpinned or not pipelined).
+
+    int worker_proc_cpu(size_t i) const { return workers_.at(i)->pipe ? workers_.at(i)->proc_cpu : -1; }
+ 
+    /// @brief NUMA node of worker @p i's CPU, stats and buffers (-1 if unknown).
 
-    double last_rate_pps() const { return last_rate_pps_; }
+    int worker_node(size_t i) const { return workers_.at(i)->node; }
  
-    /// @brief Read-only access to cumulative stats.
+    /// @brief NUMA node of @ref ServerConfig::nic (-1 if unset or unknown).
 
-    const Stats& stats() const { return stats_; }
+    int nic_node() const { return nic_node_; }
+ 
+    /// @brief Receive batches queued between worker @p i's RX and processing threads (0 inline).
+
+    size_t ring_occupancy(size_t i) const;
+ 
+    /// @brief Datagrams worker @p i's RX thread dropped because its ring was full (0 inline).
+
+    uint64_t ring_drops(size_t i) const;
  
 private:
 
-    void run_loop();
+    /// @brief One received batch in flight from the RX thread to the processing thread.
+
+    struct Batch {
+
+        PacketSlab* slab = nullptr;
+
+        uint64_t    recv_ns = 0; ///< When `recv_batch` returned (@ref now_ns).
+
+    };
+ 
+    /// @brief RX-to-processing hand-off of one worker (pipeline mode).
+
+    struct Pipeline {
+
+        Pipeline(size_t depth, PacketPool& pool, int batch);
+
+        std::vector<std::unique_ptr<PacketSlab>> slabs; ///< Receive slabs, including @ref spare.
+
+        SpscRing<Batch>       full;    ///< RX to processing: received batches.
+
+        SpscRing<PacketSlab*> empty;   ///< Processing to RX: slabs to refill.
+
+        PacketSlab*           spare;   ///< Received into, then discarded, while @ref empty is dry.
+
+        PacketSlab*           held = nullptr; ///< Slab the RX thread popped but has not filled yet.
+
+        std::atomic<uint64_t> drops{0};///< Datagrams discarded that way.
+
+        std::atomic<bool>     rx_done{false};
+
+        std::thread           rx;
+
+    };
+ 
+    /// @brief Everything one receive loop touches on its hot path, on its own cache lines.
+
+    struct alignas(kCacheLine) Worker {
+
+        std::unique_ptr<ISocket>      sock;
+
+        std::unique_ptr<WaitStrategy> wait;    ///< Idle policy (bound to @ref sock).
+
+        Stats                         stats;   ///< This worker's shard.
+
+        std::unordered_map<ClientKey, SeqWindow, ClientKeyHash> admitted; ///< Clients this worker admitted, with their sequence windows.
+
+        TxCompletions                 tx_seen; ///< Zero-copy completions already in @ref stats.
+
+        BusyPoll                      busy;    ///< Effective busy-poll settings.
+
+        std::atomic<double>           rate_pps{0.0};
+
+        int                           cpu = -1; ///< CPU to pin to (-1 = unpinned).
+
+        int                           proc_cpu = -1; ///< Pipeline processing thread's CPU (-1 = unpinned).
+
+        int                           node = -1;///< NUMA node of @ref cpu (-1 = unknown).
+
+        PacketPool*                   pool = nullptr; ///< Node-local pool the slabs come from.
+
+        std::unique_ptr<Pipeline>     pipe;    ///< Set in pipeline mode.
+
+        std::vector<std::unique_ptr<PacketSlab>> slabs; ///< Inline loop's receive slabs.
+
+        std::thread                   th;      ///< Receive loop, or processing loop in pipeline mode.
+
+    };
+ 
+    /// @brief Destroys a @ref Worker created by @ref make_worker.
+
+    struct WorkerDelete {
+
+        void operator()(Worker* w) const;
+
+    };
+
+    using WorkerPtr = std::unique_ptr<Worker, WorkerDelete>;
+ 
+    /// @brief Construct a worker in memory placed on NUMA node @p node (-1: anywhere).
+
+    static WorkerPtr make_worker(int node);
+ 
+    /// @brief Pin the calling thread to @p cpu and apply @ref ServerConfig::rt_priority (notes on failure).
+
+    void place_thread(int cpu, const char* what) const;
+ 
+    /// @brief Apply the socket options of @ref cfg_ to @p w and create its wait strategy.
+
+    void setup_worker(Worker& w, bool log);
+ 
+    void run_loop(Worker& w);
+ 
+    /// @brief Pipeline mode: receive into pooled slabs and hand them to the processing thread.
+
+    void rx_loop(Worker& w);
+ 
+    /// @brief Pipeline mode: process batches handed over by @ref rx_loop.
+
+    void process_loop(Worker& w);
+ 
+    /**
+
+     * @brief Admission, stats and echo for the first @p r views of @p slab.
+
+     * @param pickup When the batch left the socket (@ref now_ns), for delay stats.
+
+     * @return Whether an echo was sent from @p slab.
+
+     */
+
+    bool process_batch(Worker& w, PacketSlab& slab, size_t r, uint64_t pickup);
+ 
+    /// @brief Bookkeeping of one loop's once-per-second window.
+
+    struct Window {
+
+        std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+
+        uint64_t recv = 0;      ///< Worker's received count at @ref last.
+
+        uint64_t idle_seen = 0; ///< Wait-strategy iterations already folded into the stats.
+
+        uint64_t busy_seen = 0;
+
+    };
+ 
+    /// @brief Fold @p w's wait-strategy iterations since the last call into its stats.
+
+    void publish_wait(Worker& w, Window& win);
+ 
+    /**
+
+     * @brief Once per second: publish @p w's receive rate (and, if @p with_wait, its
+
+     *        wait iterations) and print the verbose line.
+
+     */
+
+    void tick(Worker& w, Window& win, bool with_wait);
  
-    std::unique_ptr<ISocket> sock_;
+    /// @brief Reap zero-copy completions into @p w's stats until send @p token is released.
 
+    void reclaim_tx(Worker& w, uint64_t token);
+ 
+    /// @brief Admit @p key if it already holds a slot or one is free (false if full).
+
+    bool try_admit(const ClientKey& key);
+ 
+    /// @brief Per-worker and imbalance series appended to `/metrics`.
+
+    std::string render_worker_metrics() const;
+ 
+    /// @brief Packet pool series appended to `/metrics`.
+
+    std::string render_pool_metrics() const;
+ 
+    /// @brief NUMA placement series appended to `/metrics`.
+
+    std::string render_placement_metrics() const;
+ 
     ServerConfig             cfg_;
 
-    Stats                    stats_;
+    int                      nic_node_ = -1;
 
-    std::unique_ptr<MetricsHttpServer> metrics_;
+    std::vector<std::unique_ptr<PacketPool>> pools_; ///< Declared before @ref workers_: slabs return their slots on destruction.
 
-    std::thread              th_;
+    std::vector<WorkerPtr>   workers_;
+
+    std::unique_ptr<MetricsHttpServer> metrics_;
 
     std::atomic<bool>        running_{false};
 
-    double                   last_rate_pps_{0.0};
- 
-    // Admission set: distinct clients currently admitted (IP:port in host order).
+    std::mutex               admit_mu_;         ///< Guards inserts into @ref admitted_.
+
+    std::unordered_set<ClientKey, ClientKeyHash> admitted_; ///< Clients admitted across all workers.
 
-    std::unordered_set<ClientKey, ClientKeyHash> admitted_;
+    std::atomic<size_t>      admitted_total_{0}; ///< Size of @ref admitted_; at the cap the set is frozen and read lock-free.
 
 };
  
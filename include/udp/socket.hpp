@@ -5,7 +5,10 @@
 #include <atomic>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <memory>
 #include <unistd.h>
+#include "udp/packet_slab.hpp"
  
 /**
 * @file
@@ -27,6 +30,68 @@
  
 namespace udp {
  
+/**
+* @brief Cumulative transmit-completion state of a socket (see @ref ISocket::reap_tx).
+*
+* @details All fields count send messages (one per @c sendmmsg entry) since the
+* socket was created or zero-copy was enabled.
+*/
+struct TxCompletions {
+    uint64_t released = 0; ///< Sends @c [0, released) no longer reference caller memory.
+    uint64_t zerocopy = 0; ///< Completions where the kernel transmitted from caller pages.
+    uint64_t copied   = 0; ///< Completions where the kernel fell back to copying.
+};
+ 
+/**
+* @brief Kernel busy-poll settings of a socket (see @ref ISocket::set_busy_poll).
+*
+* @details Busy polling lets a blocking receive on an empty socket poll the NIC
+* queue (NAPI) for up to @ref usecs instead of sleeping until the interrupt path
+* delivers, trading CPU for receive latency. Zero fields mean "kernel default"
+* (interrupt-driven) both when requesting and when reading back.
+*/
+struct BusyPoll {
+    int  usecs  = 0;     ///< @c SO_BUSY_POLL: microseconds a receive may poll the device queue.
+    bool prefer = false; ///< @c SO_PREFER_BUSY_POLL: keep softirq processing deferred to the busy poller.
+    int  budget = 0;     ///< @c SO_BUSY_POLL_BUDGET: packets per poll (0 = kernel default).
+ 
+    /// @brief Whether receives busy-poll at all.
+    bool enabled() const { return usecs > 0; }
+ 
+    /// @brief One-line form for logs, e.g. "usecs=50 prefer=1 budget=8".
+    std::string to_string() const {
+        return "usecs=" + std::to_string(usecs) + " prefer=" + (prefer ? "1" : "0")
+             + " budget=" + std::to_string(budget);
+    }
+};
+ 
+/**
+* @brief How a @c SO_REUSEPORT group spreads incoming datagrams over its sockets
+*        (see @ref ISocket::set_steering).
+*
+* @details Every mode except @ref Kernel attaches a classic-BPF program
+* (@c SO_ATTACH_REUSEPORT_CBPF) that returns a socket index; socket @c i of the group
+* is the @c i-th one bound. Hash modes mix the selected IPv4/UDP header fields
+* (multiplicative hash) before taking them modulo the group size.
+*/
+enum class Steering {
+    Kernel,  ///< Kernel default: hash of the 4-tuple.
+    Cpu,     ///< Index = CPU that ran the receive softirq (@c SKF_AD_CPU) modulo group size.
+             ///< A flow is not pinned to one socket: it moves when its softirq CPU does.
+    SrcIp,   ///< Hash of the source address only: all flows of one host share a socket.
+    SrcPort, ///< Hash of the source port only.
+    Flow     ///< Hash of source address XOR source port.
+};
+ 
+/**
+* @brief Parse a CLI steering name ("kernel", "cpu", "src-ip", "src-port" or "flow").
+* @return false if @p name is unknown (@p out is left untouched).
+*/
+bool parse_steering(const std::string& name, Steering& out);
+ 
+/// @brief Slabs a zero-copy sender rotates through, so a slab is rewritten only after its sends completed.
+static constexpr size_t kZeroCopySlabs = 4;
+ 
 /**
 * @brief Abstract socket interface (strategy/port).
 *
@@ -34,10 +99,13 @@ namespace udp {
 * Concrete implementations (e.g., @ref UdpSocket, @ref MockSocket) realize it.
 *
 * @par Batch semantics
-* - @ref recv_batch and @ref send_batch operate on vectors of contiguous buffers.
-* - Implementations typically attempt to process up to @c bufs.size() messages in
-*   one call (e.g., via @c recvmmsg/@c sendmmsg on Linux) and return the number of
-*   messages successfully processed (not bytes).
+* - @ref recv_batch and @ref send_batch come in two flavors: one operating on vectors
+*   of individually allocated buffers, and one operating on a @ref PacketSlab
+*   (one contiguous, cache-line-aligned block with fixed-stride slots). Hot paths
+*   should prefer the slab flavor, which also carries per-packet lengths and addresses.
+* - Implementations typically attempt to process up to @c bufs.size() (or
+*   @c slab.capacity()) messages in one call (e.g., via @c recvmmsg/@c sendmmsg on
+*   Linux) and return the number of messages successfully processed (not bytes).
 */
 class ISocket {
 public:
@@ -103,6 +171,28 @@ public:
     virtual ssize_t send_batch(const std::vector<std::vector<uint8_t>>& bufs,
                                const sockaddr_in* addr = nullptr) = 0;
  
+    /**
+     * @brief Receive up to @c slab.capacity() datagrams into the slab's slots.
+     *
+     * On return, views @c [0, n) of @p slab describe the received datagrams
+     * (data pointer, length, source address) and @c slab.size() equals @c n.
+     *
+     * @param slab Destination slab; its views are reset before receiving.
+     * @return Number of datagrams received (>= 0), or -1 on error (with errno set).
+     */
+    virtual ssize_t recv_batch(PacketSlab& slab) = 0;
+ 
+    /**
+     * @brief Send the first @c slab.size() views of @p slab.
+     *
+     * @param slab Source slab; each view supplies data pointer and length.
+     * @param addr Destination for every packet if non-null. If null and the socket
+     *             is connected, the connected peer is used; otherwise each view's
+     *             own @ref PacketView::addr is used (e.g., echoing to many peers).
+     * @return Number of datagrams sent (>= 0), or -1 on error (with errno set).
+     */
+    virtual ssize_t send_batch(const PacketSlab& slab, const sockaddr_in* addr = nullptr) = 0;
+ 
     /**
      * @brief Hint the desired receive buffer size (bytes).
      * @param bytes Requested size in bytes for @c SO_RCVBUF.
@@ -118,6 +208,137 @@ public:
      * @note Implementations may clamp or ignore values depending on OS limits.
      */
     virtual void set_sndbuf(int bytes);
+ 
+    /**
+     * @brief Request UDP generic segmentation offload (GSO) for slab sends.
+     *
+     * @details While active, @ref send_batch(const PacketSlab&,const sockaddr_in*)
+     * may hand runs of consecutive views with the same destination and length to
+     * the kernel as one super-buffer, which the stack splits back into the original
+     * datagrams. Receivers observe exactly the same datagrams either way.
+     *
+     * @param enable Turn GSO on (true) or off (false).
+     * @return Whether GSO is active afterwards; the default implementation has no
+     *         GSO and always returns false.
+     */
+    virtual bool set_gso(bool enable);
+ 
+    /// @brief Whether slab sends currently use GSO (see @ref set_gso).
+    virtual bool gso() const { return false; }
+ 
+    /**
+     * @brief Request UDP generic receive offload (GRO).
+     *
+     * @details While active, the kernel may coalesce consecutive same-size datagrams
+     * of one flow into a single read. Implementations split such reads back into the
+     * original datagrams, so @ref recv_batch still returns one view (or buffer) per
+     * datagram; only the number of kernel reads changes.
+     *
+     * @param enable Turn GRO on (true) or off (false).
+     * @return Whether GRO is active afterwards; the default implementation has no
+     *         GRO and always returns false.
+     */
+    virtual bool set_gro(bool enable);
+ 
+    /// @brief Whether receives currently use GRO (see @ref set_gro).
+    virtual bool gro() const { return false; }
+ 
+    /**
+     * @brief Request kernel receive timestamps in @ref PacketView::rx_ts_ns.
+     *
+     * @details The timestamp is taken by the kernel when the datagram entered the
+     * stack, so `pickup - rx_ts_ns` is the time spent queued in the socket, and
+     * `rx_ts_ns - PacketHeader::send_ts_ns` is the one-way latency (same host/clock).
+     *
+     * @param enable Turn timestamps on (true) or off (false).
+     * @return Whether timestamps are active afterwards; the default implementation
+     *         has none and always returns false.
+     */
+    virtual bool set_rx_timestamps(bool enable);
+ 
+    /// @brief Whether receives currently carry kernel timestamps (see @ref set_rx_timestamps).
+    virtual bool rx_timestamps() const { return false; }
+ 
+    /**
+     * @brief Select reuseport steering for the next @ref bind with @c reuseport set.
+     *
+     * @param steering   Steering mode (@ref Steering::Kernel detaches nothing, keeps the default).
+     * @param group_size Number of sockets that will form the group.
+     * @return Whether the socket can steer; the default implementation cannot and
+     *         returns false (binding then uses the kernel hash).
+     */
+    virtual bool set_steering(Steering steering, unsigned group_size);
+ 
+    /**
+     * @brief Configure kernel busy polling for receives.
+     *
+     * @details Non-zero fields of @p want are applied; the effective values are then
+     * read back from the socket, so options the kernel refused (unsupported, or
+     * @c EPERM without @c CAP_NET_ADMIN) show up as zero. Busy polling only acts
+     * inside a receive that would otherwise wait, i.e. with @ref set_recv_wait.
+     *
+     * @param want Requested settings.
+     * @return Settings in effect afterwards; the default implementation has no
+     *         busy polling and returns all zeros.
+     */
+    virtual BusyPoll set_busy_poll(const BusyPoll& want);
+ 
+    /**
+     * @brief Make receives block until the first datagram arrives.
+     *
+     * @details While active, a receive waits up to @p timeout_ms for one datagram,
+     * then returns it together with whatever else is already queued (up to the batch
+     * size). A timeout returns 0 like an empty non-blocking receive. Sends stay
+     * non-blocking.
+     *
+     * @param timeout_ms Longest wait per receive; 0 restores non-blocking receives.
+     * @return Whether blocking receives are active afterwards; the default
+     *         implementation cannot block and always returns false.
+     */
+    virtual bool set_recv_wait(int timeout_ms);
+ 
+    /**
+     * @brief Descriptor that polls readable once a receive would return data.
+     * @return @ref fd() by default; -1 if the socket cannot be polled.
+     */
+    virtual int wait_fd() const { return fd(); }
+ 
+    /**
+     * @brief Whether one thread may receive while a different thread sends.
+     *
+     * @details Lifts the single-owner rule for exactly that split: one receiving
+     * thread and one sending (and @ref reap_tx) thread. Configuration calls still
+     * need a single owner.
+     * @return false by default.
+     */
+    virtual bool split_io() const { return false; }
+ 
+    /**
+     * @brief Request zero-copy transmission (@c MSG_ZEROCOPY).
+     *
+     * @details While active, sends return before the kernel is done with the
+     * caller's buffers. Every send message gets the next sequence number
+     * (@ref tx_issued counts them); a buffer may be rewritten only once
+     * @ref reap_tx reports its send as released.
+     *
+     * @param enable Turn zero-copy on (true) or off (false).
+     * @return Whether zero-copy is active afterwards; the default implementation
+     *         always copies and returns false.
+     */
+    virtual bool set_zerocopy(bool enable);
+ 
+    /// @brief Whether sends currently use zero-copy (see @ref set_zerocopy).
+    virtual bool zerocopy() const { return false; }
+ 
+    /// @brief Number of send messages issued so far in zero-copy mode.
+    virtual uint64_t tx_issued() const { return 0; }
+ 
+    /**
+     * @brief Collect pending transmit completions without blocking.
+     * @return Cumulative completion state; for copying sockets every send is
+     *         released as soon as it returns.
+     */
+    virtual TxCompletions reap_tx();
 };
  
 /**
@@ -126,12 +347,47 @@ public:
 * Prefers batch syscalls (e.g., @c recvmmsg/@c sendmmsg) when available to reduce
 * syscall overhead and improve packets-per-second (PPS). Falls back to classic
 * @c recvfrom/@c sendto loops if batch syscalls are not available.
+*
+* @par Generic segmentation offload
+* With @ref set_gso enabled, the slab flavor of @ref send_batch groups runs of
+* consecutive views that share a destination and a length (the last one may be
+* shorter) into one message: its @c iovec array gathers the views in place and a
+* @c UDP_SEGMENT control message carries the segment size, so the stack is
+* traversed once per run of up to @ref kMaxGsoSegs datagrams.
+*
+* @par Generic receive offload
+* With @ref set_gro enabled, receives go into socket-owned 64 KiB buffers (one per
+* @c batch_hint message) and each coalesced read is split at the @c UDP_GRO segment
+* size reported in its control message. The slab flavor returns views pointing into
+* those buffers (no copy; valid until the next receive call). Segments that do not
+* fit into the caller's batch stay queued and are returned by the next call
+* without entering the kernel.
+*
+* @par Receive timestamps
+* @ref set_rx_timestamps prefers software @c SO_TIMESTAMPING
+* (@c SOF_TIMESTAMPING_RX_SOFTWARE) and falls back to @c SO_TIMESTAMPNS. Both report
+* @c CLOCK_REALTIME; each receive converts them to the steady clock with the
+* realtime-minus-monotonic offset sampled once per call. Timestamps are read from
+* the per-message control area of the RX ring.
+*
+* @par Zero-copy transmit
+* With @ref set_zerocopy enabled (@c SO_ZEROCOPY, Linux 5.0+ for UDP), every
+* @c sendmmsg entry is sent with @c MSG_ZEROCOPY. @ref reap_tx drains
+* @c MSG_ERRQUEUE notifications (@c SO_EE_ORIGIN_ZEROCOPY id ranges, with
+* @c SO_EE_CODE_ZEROCOPY_COPIED marking copied fallbacks) and advances the
+* released watermark over contiguous completed ids.
+*
+* @par Allocation behavior
+* The @c mmsghdr/@c iovec/@c sockaddr_in/control arrays handed to the kernel are
+* owned by the socket (one ring for RX, one for TX), sized from @c batch_hint at
+* construction and grown only when a larger batch shows up. Steady-state calls to
+* @ref recv_batch and @ref send_batch therefore perform no heap allocations.
 */
 class UdpSocket : public ISocket {
 public:
     /**
      * @brief Construct a UDP socket.
-     * @param batch_hint A hint for internal pre-allocation of I/O vectors.
+     * @param batch_hint Number of messages the internal header rings are pre-sized for.
      */
     explicit UdpSocket(int batch_hint = 64);
  
@@ -154,24 +410,142 @@ public:
     ssize_t send_batch(const std::vector<std::vector<uint8_t>>& bufs,
                        const sockaddr_in* addr = nullptr) override;
  
+    /// @copydoc ISocket::recv_batch(PacketSlab&)
+    ssize_t recv_batch(PacketSlab& slab) override;
+ 
+    /// @copydoc ISocket::send_batch(const PacketSlab&,const sockaddr_in*)
+    ssize_t send_batch(const PacketSlab& slab, const sockaddr_in* addr = nullptr) override;
+ 
     /// @copydoc ISocket::set_rcvbuf(int)
     void set_rcvbuf(int bytes) override;
  
     /// @copydoc ISocket::set_sndbuf(int)
     void set_sndbuf(int bytes) override;
  
+    /// @copydoc ISocket::set_gso(bool)
+    bool set_gso(bool enable) override;
+ 
+    /// @copydoc ISocket::gso()
+    bool gso() const override { return gso_; }
+ 
+    /// @copydoc ISocket::set_gro(bool)
+    bool set_gro(bool enable) override;
+ 
+    /// @copydoc ISocket::gro()
+    bool gro() const override { return gro_; }
+ 
+    /// @copydoc ISocket::set_rx_timestamps(bool)
+    bool set_rx_timestamps(bool enable) override;
+ 
+    /// @copydoc ISocket::rx_timestamps()
+    bool rx_timestamps() const override { return ts_mode_ != 0; }
+ 
+    /// @copydoc ISocket::set_recv_wait(int)
+    bool set_recv_wait(int timeout_ms) override;
+ 
+    /// @brief True: receives and sends use separate header rings (GRO views excepted, see @ref set_gro).
+    bool split_io() const override { return true; }
+ 
+    /// @copydoc ISocket::set_busy_poll(const BusyPoll&)
+    BusyPoll set_busy_poll(const BusyPoll& want) override;
+ 
+    /// @copydoc ISocket::set_steering(Steering,unsigned)
+    bool set_steering(Steering steering, unsigned group_size) override;
+ 
+    /// @copydoc ISocket::set_zerocopy(bool)
+    bool set_zerocopy(bool enable) override;
+ 
+    /// @copydoc ISocket::zerocopy()
+    bool zerocopy() const override { return zc_; }
+ 
+    /// @copydoc ISocket::tx_issued()
+    uint64_t tx_issued() const override { return zc_issued_; }
+ 
+    /// @copydoc ISocket::reap_tx()
+    TxCompletions reap_tx() override;
+ 
+    static constexpr size_t kMaxGsoSegs  = 64;    ///< Kernel limit on segments per GSO send.
+    static constexpr size_t kMaxGsoBytes = 65507; ///< Largest UDP payload of one GSO send.
+    static constexpr size_t kGroBufSize  = 65536; ///< Receive buffer per coalesced GRO read.
+ 
+    /**
+     * @brief Number of messages the RX/TX header rings can currently describe.
+     *
+     * @details Starts at @c batch_hint and only grows (never shrinks) when a batch
+     * larger than the current capacity is passed in. Mainly useful for tests.
+     */
+    size_t ring_capacity() const;
+ 
 private:
+#if defined(__linux__)
+    /**
+     * @brief Reusable header arrays for one direction of batch I/O.
+     *
+     * @details Each slot's @c msg_hdr is pre-wired once to its own @c iovec,
+     * @c sockaddr_in and control area, so the per-call work is limited to setting
+     * buffer pointers/lengths and resetting the fields the kernel writes back.
+     */
+    struct MsgRing {
+        std::vector<iovec>       iov;   ///< One scatter/gather entry per message.
+        std::vector<mmsghdr>     msgs;  ///< Headers passed to @c recvmmsg/@c sendmmsg.
+        std::vector<sockaddr_in> addrs; ///< Per-message peer address storage.
+        std::vector<char>        ctrl;  ///< Per-message ancillary data (@ref kCtrlLen bytes each).
+ 
+        /// @brief Grow (never shrink) to describe at least @p n messages.
+        void reserve(size_t n);
+ 
+        /// @brief Number of messages the ring can currently describe.
+        size_t capacity() const { return msgs.size(); }
+    };
+ 
+    static constexpr size_t kCtrlLen = 128; ///< Control bytes per message (timestamping + GRO cmsgs).
+ 
+    /// @brief GSO flavor of the slab send: one message per same-destination/same-size run.
+    ssize_t send_gso(const PacketSlab& slab, const sockaddr_in* addr);
+ 
+    /// @brief GRO receive: split queued coalesced reads into up to @p max views.
+    ssize_t take_gro(PacketView* out, size_t max);
+ 
+    /// @brief `sendmmsg` with the zero-copy flag and id accounting applied.
+    int send_msgs(mmsghdr* msgs, size_t n);
+ 
+    /// @brief Record completed zero-copy ids @c [lo, hi] and advance the watermark.
+    void complete_zc(uint32_t lo, uint32_t hi, bool copied);
+#endif
+ 
     int sockfd_;        ///< Underlying socket file descriptor.
-    int batch_hint_;    ///< Pre-allocation hint for batch I/O structures.
+    int batch_hint_;    ///< Initial capacity of the batch I/O header rings.
     bool connected_;    ///< Whether @ref connect has been successfully called.
+    bool gso_;          ///< Slab sends use @c UDP_SEGMENT (see @ref set_gso).
+    bool gro_;          ///< Receives are coalesced by @c UDP_GRO (see @ref set_gro).
+    bool zc_;           ///< Sends use @c MSG_ZEROCOPY (see @ref set_zerocopy).
+    int  ts_mode_;      ///< 0 = no RX timestamps, else the @c SCM_* type to parse.
+    int  rx_flags_;     ///< @c recvmmsg flags: @c MSG_WAITFORONE while receives block.
+    Steering steer_ = Steering::Kernel; ///< Reuseport program attached by @ref bind.
+    unsigned steer_group_ = 1;          ///< Group size the program steers over.
+    uint64_t zc_issued_ = 0;  ///< Zero-copy send messages issued.
+    TxCompletions zc_done_;   ///< Released watermark and completion counters.
     sockaddr_in peer_{};///< Connected peer (valid only if @ref connected_ is true).
+#if defined(__linux__)
+    MsgRing rx_ring_;   ///< Headers reused by every @ref recv_batch call.
+    MsgRing tx_ring_;   ///< Headers reused by every @ref send_batch call.
+    std::vector<uint8_t>    gro_buf_;     ///< @ref kGroBufSize bytes per GRO read.
+    std::vector<PacketView> gro_scratch_; ///< Views used by the vector receive flavor under GRO.
+    size_t   gro_msgs_ = 0;  ///< Reads returned by the last GRO @c recvmmsg.
+    size_t   gro_next_ = 0;  ///< Read currently being split.
+    uint32_t gro_off_  = 0;  ///< Byte offset of the next segment in that read.
+    uint32_t gro_seg_  = 0;  ///< Segment size of that read.
+    uint64_t gro_ts_   = 0;  ///< RX timestamp of that read (steady-clock ns).
+    std::vector<std::pair<uint64_t, uint64_t>> zc_ooo_; ///< Completed id ranges above the watermark.
+#endif
 };
  
 /**
 * @brief In-memory test double for @ref ISocket (no real network I/O).
 *
 * @details
-* - @ref recv_batch pulls preloaded datagrams from an internal queue (@ref preload_recv).
+* - @ref recv_batch pulls preloaded datagrams from an internal queue (@ref preload_recv);
+*   the slab flavor also reports each datagram's preloaded source address.
 * - @ref send_batch appends buffers to an internal "sent" store for later inspection.
 * - Methods do not set @c errno; return values model success counts in a simplified way.
 *
@@ -181,7 +555,7 @@ private:
 class MockSocket : public ISocket {
 public:
     /// @brief Construct an empty mock with no preloaded datagrams.
-    MockSocket() : recv_cursor_(0) {}
+    MockSocket() : recv_cursor_(0), gso_(false) {}
  
     /// @copydoc ISocket::fd()
     int fd() const override { return -1; }
@@ -199,19 +573,47 @@ public:
     ssize_t send_batch(const std::vector<std::vector<uint8_t>>& bufs,
                        const sockaddr_in* addr = nullptr) override;
  
+    /// @copydoc ISocket::recv_batch(PacketSlab&)
+    ssize_t recv_batch(PacketSlab& slab) override;
+ 
+    /// @copydoc ISocket::send_batch(const PacketSlab&,const sockaddr_in*)
+    ssize_t send_batch(const PacketSlab& slab, const sockaddr_in* addr = nullptr) override;
+ 
     /// @copydoc ISocket::set_rcvbuf(int)
     void set_rcvbuf(int) override {}
  
     /// @copydoc ISocket::set_sndbuf(int)
     void set_sndbuf(int) override {}
  
+    /// @brief Always succeeds; only recorded so callers' GSO-specific logic can be tested.
+    bool set_gso(bool enable) override { gso_ = enable; return gso_; }
+ 
+    /// @copydoc ISocket::gso()
+    bool gso() const override { return gso_; }
+ 
+    /// @brief Always succeeds; views then carry the timestamps given to @ref preload_recv.
+    bool set_rx_timestamps(bool enable) override { rx_ts_on_ = enable; return rx_ts_on_; }
+ 
+    /// @copydoc ISocket::rx_timestamps()
+    bool rx_timestamps() const override { return rx_ts_on_; }
+ 
+    /// @brief True: receives read only the preloaded store, sends only append to the sent store.
+    bool split_io() const override { return true; }
+ 
     // ---------------------- Test hooks ----------------------
  
     /**
      * @brief Enqueue a datagram to be returned by the next @ref recv_batch call(s).
-     * @param pkt A full datagram payload to be copied into caller-provided buffers.
+     * @param pkt  A full datagram payload to be copied into caller-provided buffers.
+     * @param from Source address reported by the slab receive path (default: all zero).
+     * @param rx_ts_ns "Kernel" RX timestamp reported once RX timestamps are enabled.
      */
-    void preload_recv(const std::vector<uint8_t>& pkt) { rx_store_.push_back(pkt); }
+    void preload_recv(const std::vector<uint8_t>& pkt, const sockaddr_in& from = sockaddr_in{},
+                      uint64_t rx_ts_ns = 0) {
+        rx_store_.push_back(pkt);
+        rx_addrs_.push_back(from);
+        rx_ts_.push_back(rx_ts_ns);
+    }
  
     /**
      * @brief Total number of datagrams "sent" via @ref send_batch so far.
@@ -225,10 +627,49 @@ public:
      */
     const std::vector<std::vector<uint8_t>>& sent() const { return tx_store_; }
  
+    /**
+     * @brief Destination of each "sent" datagram, parallel to @ref sent().
+     *
+     * @details Entries are the per-call address, or the per-view address for
+     * slab sends without one, or all-zero when neither was supplied.
+     */
+    const std::vector<sockaddr_in>& sent_addrs() const { return tx_addrs_; }
+ 
 private:
     std::vector<std::vector<uint8_t>> rx_store_; ///< Preloaded incoming datagrams.
+    std::vector<sockaddr_in>          rx_addrs_; ///< Source address per preloaded datagram.
+    std::vector<uint64_t>             rx_ts_;    ///< RX timestamp per preloaded datagram.
     std::vector<std::vector<uint8_t>> tx_store_; ///< Captured outgoing datagrams.
+    std::vector<sockaddr_in>          tx_addrs_; ///< Destination per captured datagram.
     size_t recv_cursor_;                          ///< Read cursor into @ref rx_store_.
+    bool   gso_;                                  ///< Last value passed to @ref set_gso.
+    bool   rx_ts_on_ = false;                     ///< Last value passed to @ref set_rx_timestamps.
+};
+ 
+/// @brief Kernel I/O backend used by @ref create_socket.
+enum class SocketBackend {
+    Mmsg,   ///< @ref UdpSocket (@c recvmmsg/@c sendmmsg).
+    IoUring ///< @ref IoUringSocket (multishot receive, batched send SQEs).
 };
  
+/**
+* @brief Parse a CLI backend name ("mmsg" or "io_uring").
+* @return false if @p name is not a known backend (@p out is left untouched).
+*/
+bool parse_backend(const std::string& name, SocketBackend& out);
+ 
+/**
+* @brief Create a socket for the requested backend.
+*
+* @details If @ref SocketBackend::IoUring is requested but the kernel (or the build)
+* lacks support, a note is printed to @c stderr and a @ref UdpSocket is returned
+* instead, so callers never have to handle the fallback themselves.
+*
+* @param backend    Requested backend.
+* @param batch_hint Expected messages per batch (sizes header rings / submission queue).
+* @param sqpoll     io_uring only: request a kernel SQ polling thread, so sends and
+*                   re-arms need no @c io_uring_enter. Ignored by @ref SocketBackend::Mmsg.
+*/
+std::unique_ptr<ISocket> create_socket(SocketBackend backend, int batch_hint, bool sqpoll = false);
+ 
 } // namespace udp
\ No newline at end of file
@@ -1,28 +1,52 @@
 #pragma once
+#include <array>
 #include <atomic>
-#include <unordered_map>
-#include <mutex>
+#include <memory>
 #include <netinet/in.h>
 #include <string>
 #include <sstream>
+#include <vector>
+#include "udp/common.hpp"
+#include "udp/histogram.hpp"
+#include "udp/seq_window.hpp"
  
 /**
 * @file
-* @brief Lightweight, thread-safe counters and client tracking for UDP throughput tests.
+* @brief Lightweight, sharded counters and client tracking for UDP throughput tests.
 *
 * This header exposes:
 *  - @ref udp::ClientKey : a compact (IPv4 address, port) tuple with equality.
 *  - @ref udp::ClientKeyHash : hash functor for @c unordered_map keys.
-*  - @ref udp::Stats : hot-path friendly counters (lock-free atomics) and an optional
-*    unique-client tracker guarded by a short-lived mutex.
+*  - @ref udp::ClientTable : single-writer, lock-free per-client hit table that
+*    readers can scan while it is being written.
+*  - @ref udp::Stats : hot-path friendly counters (lock-free atomics), latency
+*    histograms (@ref udp::Latency) and a unique-client tracker
+*    (@ref udp::ClientTable).
 *
 * @note The atomic counters use @c memory_order_relaxed because we only care about
 *       numerical accuracy, not cross-counter ordering. Reads may observe slightly
 *       skewed snapshots across different counters; this is acceptable for metrics.
+*
+* @note A @ref udp::Stats is one thread's shard: each counter group has a single
+*       writer, which adds with a relaxed load and store (no locked instruction).
+*       Threads keep their own shard and readers sum shards with
+*       @ref udp::Stats::merge_from.
 */
  
 namespace udp {
  
+/// @brief Latency distributions kept by @ref Stats (one @ref LatencyHistogram each).
+enum class Latency {
+    OneWay,   ///< Server: @ref PacketHeader::send_ts_ns to kernel RX timestamp.
+    Rtt,      ///< Client: intended send time to echo RX timestamp (coordinated-omission corrected).
+    RttRaw,   ///< Client: @ref PacketHeader::send_ts_ns to echo RX timestamp.
+    RecvCall, ///< Duration of batch receive calls that returned data.
+    SendCall  ///< Duration of batch send calls.
+};
+ 
+/// @brief Number of @ref Latency kinds.
+static constexpr size_t kLatencyKinds = 5;
+ 
 /**
 * @brief Key type representing a client as (IPv4 address, UDP port).
 *
@@ -57,20 +81,156 @@ struct ClientKeyHash {
     }
 };
  
+/**
+* @brief Per-client hit counts: written by one thread, read by any, no locks.
+*
+* @details Open addressing with linear probing over slots of two atomics (packed
+* key, hits). The writer fills a slot's hits, then publishes its key with a
+* release store. A reader that sees the key therefore sees a valid entry. Keys
+* are never removed.
+*
+* Growth works like read-copy-update. At half load the writer copies every
+* entry into a table twice the size, then publishes that table with one
+* release store of @ref cur_. Readers that still walk the old table see a
+* complete, slightly stale copy. Retired tables are freed only with the
+* object, and the geometric growth bounds them to the size of the live table.
+*
+* So the receive loop never waits for a reader: an insert or update is a
+* hash, a short probe and relaxed stores. A reader never waits for the
+* writer either.
+*
+* @note Thread-safety: @ref add (and @ref merge_from) from one writer thread
+*       only; @ref size, @ref hits and @ref for_each from any thread.
+*/
+class ClientTable {
+public:
+    ClientTable() { publish(8); }
+ 
+    ClientTable(const ClientTable&) = delete;
+    ClientTable& operator=(const ClientTable&) = delete;
+ 
+    /// @brief Count @p n hits for @p k, inserting it if new (single writer).
+    void add(const ClientKey& k, uint64_t n = 1) {
+        Table* t = cur_.load(std::memory_order_relaxed); // only this thread stores it
+        const uint64_t key = pack(k);
+        Slot* s = probe(*t, key);
+        if (s->key.load(std::memory_order_relaxed) == key) {
+            s->hits.store(s->hits.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            return;
+        }
+        const size_t used = size_.load(std::memory_order_relaxed);
+        if ((used + 1) * 2 > t->mask + 1) {
+            t = publish((t->mask + 1) * 2);
+            s = probe(*t, key);
+        }
+        s->hits.store(n, std::memory_order_relaxed);
+        s->key.store(key, std::memory_order_release);
+        size_.store(used + 1, std::memory_order_release);
+    }
+ 
+    /// @brief Add every entry of @p o (a reader of @p o, the writer of this table).
+    void merge_from(const ClientTable& o) {
+        o.for_each([this](const ClientKey& k, uint64_t n) { add(k, n); });
+    }
+ 
+    /// @brief Distinct clients seen.
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+ 
+    /// @brief Hits counted for @p k (0 if unknown).
+    uint64_t hits(const ClientKey& k) const {
+        const Slot* s = probe(*cur_.load(std::memory_order_acquire), pack(k));
+        return s->key.load(std::memory_order_acquire) == pack(k) ? s->hits.load(std::memory_order_relaxed) : 0;
+    }
+ 
+    /// @brief Call `f(ClientKey, hits)` for every client in the current table.
+    template <typename F>
+    void for_each(F&& f) const {
+        const Table* t = cur_.load(std::memory_order_acquire);
+        for (size_t i=0; i<=t->mask; ++i) {
+            const uint64_t key = t->slots[i].key.load(std::memory_order_acquire);
+            if (key) f(unpack(key), t->slots[i].hits.load(std::memory_order_relaxed));
+        }
+    }
+ 
+private:
+    struct Slot {
+        std::atomic<uint64_t> key{0};  ///< @ref pack of the client; 0 = empty.
+        std::atomic<uint64_t> hits{0};
+    };
+    struct Table {
+        std::unique_ptr<Slot[]> slots;
+        size_t                  mask = 0; ///< Capacity - 1 (capacity is a power of two).
+    };
+ 
+    /// @brief Address, port and a presence bit, so no client packs to 0.
+    static uint64_t pack(const ClientKey& k) {
+        return uint64_t{1} << 48 | static_cast<uint64_t>(k.addr) << 16 | k.port;
+    }
+    static ClientKey unpack(uint64_t key) {
+        return ClientKey{ static_cast<uint32_t>(key >> 16), static_cast<uint16_t>(key) };
+    }
+ 
+    /// @brief Slot holding @p key, or the empty slot where it would go.
+    static Slot* probe(const Table& t, uint64_t key) {
+        size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & t.mask;
+        for (;; i = (i + 1) & t.mask) {
+            const uint64_t k = t.slots[i].key.load(std::memory_order_relaxed);
+            if (k == key || k == 0) return &t.slots[i];
+        }
+    }
+ 
+    /// @brief Copy the live entries into a new table of @p capacity slots and make it current.
+    Table* publish(size_t capacity) {
+        auto t = std::make_unique<Table>();
+        t->slots.reset(new Slot[capacity]);
+        t->mask = capacity - 1;
+        if (const Table* old = cur_.load(std::memory_order_relaxed)) {
+            for (size_t i=0; i<=old->mask; ++i) {
+                const uint64_t key = old->slots[i].key.load(std::memory_order_relaxed);
+                if (!key) continue;
+                Slot* s = probe(*t, key);
+                s->hits.store(old->slots[i].hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                s->key.store(key, std::memory_order_relaxed);
+            }
+        }
+        tables_.push_back(std::move(t));
+        cur_.store(tables_.back().get(), std::memory_order_release);
+        return tables_.back().get();
+    }
+ 
+    std::atomic<Table*>                 cur_{nullptr}; ///< Table readers walk.
+    std::atomic<size_t>                 size_{0};
+    std::vector<std::unique_ptr<Table>> tables_;       ///< Every generation (writer only).
+};
+ 
 /**
 * @brief Aggregated counters and (optional) unique-client tracking.
 *
 * @details
-* - **Hot path:** packet/byte counters are @c std::atomic and updated with
-*   @c memory_order_relaxed to avoid locks and minimize contention.
-* - **Unique clients:** tracked in an @c unordered_map guarded by a small
-*   @c std::mutex. This should be called less frequently than the hot-path
-*   counters to avoid contention in tight loops.
+* - **Hot path:** packet/byte counters are @c std::atomic, but each has a single
+*   writer, so an add is a relaxed load plus a relaxed store rather than a
+*   locked read-modify-write. Callers add once per batch, not per datagram.
+* - **Layout:** counters are grouped by the thread that writes them (receive
+*   processing, send path, receive loop, client map), and each group starts on
+*   its own cache line, so e.g. a pipeline's RX thread and processing thread
+*   never false-share a line.
+* - **Unique clients:** tracked in a @ref ClientTable owned by the shard's
+*   receive-processing thread. Updates take no lock, and scrapes read the
+*   published table without blocking that thread.
+*
+* - **Latency:** one log-linear @ref LatencyHistogram per @ref Latency kind.
+*   Recording is constant time (bucket index plus relaxed stores, no
+*   read-modify-write), so each kind must have a single writer: the thread that
+*   owns the shard. Readers merge shards on scrape.
 *
 * @par Thread-safety
-* - @ref inc_sent, @ref inc_recv, @ref add_rx_bytes, @ref add_tx_bytes and the
-*   getters are lock-free and thread-safe.
-* - @ref note_client and @ref unique_clients acquire an internal mutex.
+* - Getters are lock-free and may run on any thread.
+* - @ref inc_sent, @ref inc_recv, @ref add_rx_bytes, @ref add_tx_bytes, the other
+*   @c add_* members and @ref record_latency are lock-free but single-writer:
+*   concurrent calls for the same counter (or latency kind) on one object can
+*   lose updates. Give each writing thread its own shard.
+* - @ref note_client is lock-free, single-writer; @ref unique_clients is
+*   lock-free from any thread.
 *
 * @par Consistency
 * Reads of different counters are not atomic as a group; a single @ref to_string
@@ -88,29 +248,112 @@ struct ClientKeyHash {
 
 class Stats {
 public:
+    Stats() = default;
+ 
+    /**
+     * @brief Snapshot copy: counters are loaded one by one, clients from the published table.
+     * @see merge_from
+     */
+    Stats(const Stats& o) { merge_from(o); }
+ 
+    Stats& operator=(const Stats&) = delete;
+ 
+    /**
+     * @brief Add every counter of @p o into this object and union the client tables.
+     *
+     * @details Used to combine per-worker shards at scrape time: each shard is
+     * written by one thread only, and the (cold) merge is the only cross-shard read.
+     * A client present in several shards is counted once in @ref unique_clients.
+     *
+     * @warning @p o must not be this object, and this object must have no
+     *          other writer meanwhile (it is the merging thread's shard).
+     */
+    void merge_from(const Stats& o);
+ 
     /**
      * @brief Increase the number of sent packets by @p n (lock-free).
      * @param n Number of packets to add.
      */
-    void inc_sent(uint64_t n) { sent_.fetch_add(n, std::memory_order_relaxed); }
+    void inc_sent(uint64_t n) { bump(sent_, n); }
  
     /**
      * @brief Increase the number of received packets by @p n (lock-free).
      * @param n Number of packets to add.
      */
-    void inc_recv(uint64_t n) { recv_.fetch_add(n, std::memory_order_relaxed); }
+    void inc_recv(uint64_t n) { bump(recv_, n); }
  
     /**
      * @brief Increase the total received bytes by @p n (lock-free).
      * @param n Number of bytes to add.
      */
-    void add_rx_bytes(uint64_t n) { rx_bytes_.fetch_add(n, std::memory_order_relaxed); }
+    void add_rx_bytes(uint64_t n) { bump(rx_bytes_, n); }
  
     /**
      * @brief Increase the total transmitted bytes by @p n (lock-free).
      * @param n Number of bytes to add.
      */
-    void add_tx_bytes(uint64_t n) { tx_bytes_.fetch_add(n, std::memory_order_relaxed); }
+    void add_tx_bytes(uint64_t n) { bump(tx_bytes_, n); }
+ 
+    /**
+     * @brief Account zero-copy send completions (lock-free).
+     * @param zerocopy Completions transmitted straight from user pages.
+     * @param copied   Completions where the kernel fell back to copying.
+     */
+    void add_zc_completions(uint64_t zerocopy, uint64_t copied) {
+        bump(zc_sends_, zerocopy);
+        bump(zc_copied_, copied);
+    }
+ 
+    /**
+     * @brief Account socket-queueing delay: kernel RX timestamp to user-space pickup (lock-free).
+     * @param ns Sum of the per-datagram delays, in nanoseconds.
+     * @param n  Number of datagrams the sum covers.
+     */
+    void add_queue_delay(uint64_t ns, uint64_t n) {
+        bump(queue_ns_, ns);
+        bump(queue_n_, n);
+    }
+ 
+    /**
+     * @brief Account user-space processing delay: pickup to end of batch handling (lock-free).
+     * @param ns Sum of the per-datagram delays, in nanoseconds.
+     * @param n  Number of datagrams the sum covers.
+     */
+    void add_proc_delay(uint64_t ns, uint64_t n) {
+        bump(proc_ns_, ns);
+        bump(proc_n_, n);
+    }
+ 
+    /**
+     * @brief Record one latency sample of kind @p k (lock-free, single writer per kind).
+     * @param ns Latency in nanoseconds.
+     */
+    void record_latency(Latency k, uint64_t ns) { lat_[static_cast<size_t>(k)].record(ns); }
+ 
+    /// @brief Distribution of kind @p k (live; copy it for a stable snapshot).
+    const LatencyHistogram& latency(Latency k) const { return lat_[static_cast<size_t>(k)]; }
+ 
+    /**
+     * @brief Account sequence tracking results (lock-free; see @ref SeqWindow).
+     * @param d Changes accumulated over a batch.
+     */
+    void add_seq(const SeqCounts& d) {
+        // Two's-complement wrap turns a negative delta into a decrement.
+        bump(seq_lost_, static_cast<uint64_t>(d.lost));
+        bump(seq_reordered_, d.reordered);
+        bump(seq_duplicate_, d.duplicate);
+        bump(seq_invalid_, d.invalid);
+    }
+ 
+    /**
+     * @brief Account receive loop iterations (lock-free).
+     * @param idle Iterations whose receive returned nothing.
+     * @param busy Iterations that received at least one datagram.
+     */
+    void add_loop_iters(uint64_t idle, uint64_t busy) {
+        bump(loop_idle_, idle);
+        bump(loop_busy_, busy);
+    }
  
     /**
      * @brief Record (or update) activity for a specific client (addr, port).
@@ -118,23 +361,15 @@ public:
      * @details Increments an internal hit counter for the given @ref ClientKey.
      * If the key was not present, inserts it with a count of 1.
      *
-     * @note This method acquires a short-lived mutex to protect the map.
-     * Prefer calling it at a reduced frequency (e.g., sampling) in very hot loops.
+     * @note Lock-free, single writer (see @ref ClientTable).
      */
-    void note_client(uint32_t addr, uint16_t port) {
-        std::lock_guard<std::mutex> lg(mu_);
-        clients_[ClientKey{addr, port}]++;
-    }
+    void note_client(uint32_t addr, uint16_t port) { clients_.add(ClientKey{addr, port}); }
  
-    /**
-     * @brief Return the current number of unique clients observed.
-     *
-     * @note Acquires the internal mutex to read the map size.
-     */
-    size_t unique_clients() const {
-        std::lock_guard<std::mutex> lg(mu_);
-        return clients_.size();
-    }
+    /// @brief Return the current number of unique clients observed (lock-free).
+    size_t unique_clients() const { return clients_.size(); }
+ 
+    /// @brief Per-client hit counts (readable from any thread).
+    const ClientTable& clients() const { return clients_; }
  
     /// @brief Read the total number of sent packets (lock-free).
     uint64_t sent() const { return sent_.load(std::memory_order_relaxed); }
@@ -148,6 +383,42 @@ public:
     /// @brief Read the total number of transmitted bytes (lock-free).
     uint64_t tx_bytes() const { return tx_bytes_.load(std::memory_order_relaxed); }
  
+    /// @brief Read the number of zero-copy completions without copy (lock-free).
+    uint64_t zc_sends() const { return zc_sends_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Read the number of zero-copy completions that fell back to copying (lock-free).
+    uint64_t zc_copied() const { return zc_copied_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Read the number of idle (empty) receive loop iterations (lock-free).
+    uint64_t loop_idle() const { return loop_idle_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Read the number of busy (non-empty) receive loop iterations (lock-free).
+    uint64_t loop_busy() const { return loop_busy_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Sequences currently counted lost, summed over senders (can go down as late datagrams arrive).
+    uint64_t seq_lost() const { return seq_lost_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Datagrams that arrived after a higher sequence from the same sender.
+    uint64_t seq_reordered() const { return seq_reordered_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Datagrams whose sequence had already arrived.
+    uint64_t seq_duplicate() const { return seq_duplicate_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Datagrams too short for a @ref PacketHeader or with the wrong magic.
+    uint64_t seq_invalid() const { return seq_invalid_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Total socket-queueing delay in ns, and the number of datagrams it covers.
+    uint64_t queue_delay_ns() const { return queue_ns_.load(std::memory_order_relaxed); }
+    uint64_t queue_delay_count() const { return queue_n_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Total user-space processing delay in ns, and the number of datagrams it covers.
+    uint64_t proc_delay_ns() const { return proc_ns_.load(std::memory_order_relaxed); }
+    uint64_t proc_delay_count() const { return proc_n_.load(std::memory_order_relaxed); }
+ 
+    /// @brief Total one-way latency in ns, and the number of datagrams it covers.
+    uint64_t one_way_ns() const { return latency(Latency::OneWay).sum(); }
+    uint64_t one_way_count() const { return latency(Latency::OneWay).count(); }
+ 
     /**
      * @brief Produce a single-line human-readable snapshot of all counters.
      *
@@ -163,23 +434,48 @@ public:
     }
  
 private:
-    /// @name Hot-path counters (lock-free)
+    /// @brief Single-writer add: relaxed load and store, no read-modify-write.
+    static void bump(std::atomic<uint64_t>& a, uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+ 
+    /// @name Receive processing (written by the thread that handles received batches)
     ///@{
-    std::atomic<uint64_t> sent_{0};     ///< Total packets sent.
-    std::atomic<uint64_t> recv_{0};     ///< Total packets received.
+    alignas(kCacheLine) std::atomic<uint64_t> recv_{0}; ///< Total packets received.
     std::atomic<uint64_t> rx_bytes_{0}; ///< Total bytes received.
+    std::atomic<uint64_t> queue_ns_{0};   ///< Sum of RX-timestamp-to-pickup delays.
+    std::atomic<uint64_t> queue_n_{0};    ///< Datagrams in @ref queue_ns_.
+    std::atomic<uint64_t> proc_ns_{0};    ///< Sum of pickup-to-done delays.
+    std::atomic<uint64_t> proc_n_{0};     ///< Datagrams in @ref proc_ns_.
+    std::atomic<uint64_t> seq_lost_{0};   ///< Skipped sequences not seen since.
+    std::atomic<uint64_t> seq_reordered_{0};
+    std::atomic<uint64_t> seq_duplicate_{0};
+    std::atomic<uint64_t> seq_invalid_{0};
+    ///@}
+ 
+    /// @name Send path (the sending thread: client sender, server echo)
+    ///@{
+    alignas(kCacheLine) std::atomic<uint64_t> sent_{0}; ///< Total packets sent.
     std::atomic<uint64_t> tx_bytes_{0}; ///< Total bytes transmitted.
+    std::atomic<uint64_t> zc_sends_{0}; ///< Zero-copy sends completed without copy.
+    std::atomic<uint64_t> zc_copied_{0};///< Zero-copy sends completed as copies.
+    ///@}
+ 
+    /// @name Receive loop (the thread calling the socket; the RX thread in pipeline mode)
+    ///@{
+    alignas(kCacheLine) std::atomic<uint64_t> loop_idle_{0}; ///< Receive loop iterations with nothing received.
+    std::atomic<uint64_t> loop_busy_{0};  ///< Receive loop iterations with data.
     ///@}
  
-    mutable std::mutex mu_;  ///< Protects @ref clients_ for insert/size operations.
+    std::array<LatencyHistogram, kLatencyKinds> lat_; ///< Indexed by @ref Latency (each cache-line aligned).
  
     /**
-     * @brief Map from client key to a simple hit count.
+     * @brief Client key to hit count, written by the receive-processing thread.
      *
      * @details The count is not used for logic in this class beyond existence;
      * it can be helpful if you later want to know per-client packet tallies.
      */
-    std::unordered_map<ClientKey, uint64_t, ClientKeyHash> clients_;
+    alignas(kCacheLine) ClientTable clients_;
 };
  
 } // namespace udp
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+ 
+/**
+* @file
+* @brief Time-varying send schedules for the load generator (@ref udp::TrafficProfile).
+*
+* A profile is a list of phases played back to back. Each phase is written as
+* `kind:arg:arg...`; phases are separated by commas on the command line
+* (`--profile`) or by newlines in a schedule file (`--schedule`, where `#` starts
+* a comment). Rates accept `k`/`M`/`G` suffixes, durations `us`/`ms`/`s` (default s).
+*
+* | Phase                        | Rate during the phase                                   |
+* |------------------------------|---------------------------------------------------------|
+* | `const:RATE:DUR`             | @c RATE, evenly spaced                                  |
+* | `poisson:RATE:DUR`           | @c RATE on average, exponential gaps (Poisson arrivals) |
+* | `warmup:RATE:DUR`            | @c RATE; packets are sent but excluded from stats       |
+* | `ramp:FROM:TO:DUR`           | linear from @c FROM to @c TO                            |
+* | `step:FROM:TO:STEPS:DUR`     | @c STEPS equal levels from @c FROM to @c TO (inclusive) |
+* | `onoff:RATE:ON:OFF:DUR`      | @c RATE for @c ON, silent for @c OFF, repeating         |
+*
+* Example: `warmup:10k:2s,const:50k:10s,step:50k:200k:4:20s,onoff:500k:50ms:450ms:5s`.
+*/
+ 
+namespace udp {
+ 
+/// @brief Shape of one @ref Phase.
+enum class PhaseKind { Constant, Poisson, Warmup, Ramp, Step, OnOff };
+ 
+/// @brief One segment of a @ref TrafficProfile (see the file comment for the syntax).
+struct Phase {
+    PhaseKind kind = PhaseKind::Constant;
+    double    seconds = 0;  ///< Length of the phase.
+    double    pps = 0;      ///< Rate, or start rate (Ramp, Step), or on-rate (OnOff).
+    double    pps_end = 0;  ///< End rate (Ramp, Step).
+    unsigned  steps = 1;    ///< Levels (Step).
+    double    on_s = 0;     ///< Sending part of each period (OnOff).
+    double    off_s = 0;    ///< Silent part of each period (OnOff).
+};
+ 
+/**
+* @brief Rate schedule over time, as a sequence of @ref Phase.
+*
+* @details A sender samples @ref at with the time since it started and feeds the
+* rate into its @ref Pacer. An empty profile has no phases; the client then runs
+* @ref ClientConfig::pps for @ref ClientConfig::seconds.
+*
+* @note Immutable after parsing; safe to share between sender threads.
+*/
+class TrafficProfile {
+public:
+    /// @brief Target at one instant.
+    struct Point {
+        double pps = 0;        ///< Total target rate (0 while silent).
+        bool   poisson = false;///< Exponential gaps instead of even spacing.
+        bool   warmup = false; ///< Packets sent now are not counted in stats.
+        bool   done = false;   ///< Past the last phase.
+    };
+ 
+    /**
+     * @brief Parse a comma- (or newline-) separated phase list.
+     * @throws std::invalid_argument naming the offending phase.
+     */
+    static TrafficProfile parse(const std::string& spec);
+ 
+    /**
+     * @brief Read a schedule file: one phase per line, @c # comments, blank lines ignored.
+     * @throws std::runtime_error if the file cannot be read; std::invalid_argument on syntax errors.
+     */
+    static TrafficProfile load(const std::string& path);
+ 
+    /// @brief Whether there are no phases.
+    bool empty() const { return phases_.empty(); }
+ 
+    /// @brief Phases in playback order.
+    const std::vector<Phase>& phases() const { return phases_; }
+ 
+    /// @brief Total length in seconds.
+    double duration() const { return starts_.empty() ? 0 : starts_.back(); }
+ 
+    /// @brief Highest rate any phase asks for.
+    double peak() const;
+ 
+    /// @brief Target at @p t seconds after the start.
+    Point at(double t) const;
+ 
+    /// @brief Canonical spec (parses back to the same profile).
+    std::string to_string() const;
+ 
+private:
+    void add(const Phase& p);
+ 
+    std::vector<Phase>  phases_;
+    std::vector<double> starts_; ///< Start of phase i, then the total duration (size = phases + 1).
+};
+ 
+/// @brief Parse a rate such as "250000", "250k" or "1.5M". @return false if malformed or negative.
+bool parse_rate(const std::string& s, double& out);
+ 
+/// @brief Parse a duration such as "10", "10s", "250ms" or "500us" into seconds. @return false if malformed or negative.
+bool parse_duration(const std::string& s, double& out);
+ 
+} // namespace udp
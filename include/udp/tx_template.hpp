@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "udp/common.hpp"
+#include "udp/packet_slab.hpp"
+ 
+/**
+* @file
+* @brief Pre-built transmit batches: format every datagram once, patch two fields per send.
+*
+* A load generator sends the same datagram shape millions of times per second.
+* @ref udp::TxTemplate formats each slot of a @ref udp::PacketSlab once (header
+* magic, payload bytes, view length) and afterwards only writes
+* @ref udp::PacketHeader::seq and @ref udp::PacketHeader::send_ts_ns before each
+* send, so preparing a batch is one short loop of two stores per packet with no
+* allocation, no zero-filling and one clock read.
+*/
+ 
+namespace udp {
+ 
+/**
+* @brief Fixed-size datagrams laid out in a slab, ready to send.
+*
+* @details The slab's views keep pointing at their own slots with length
+* @ref packet_size; @ref stamp only touches the headers and the slab size.
+*
+* @note Not thread-safe; one sender thread owns a template and its slab.
+*/
+class TxTemplate {
+public:
+    /**
+     * @brief Format every slot of @p slab as a @p pkt_len-byte datagram.
+     * @param slab    Slab to format; must outlive the template. Its slot size must
+     *                be at least @p pkt_len.
+     * @param pkt_len Datagram size, at least `sizeof(PacketHeader)`.
+     * @param fill    Byte written to the payload after the header.
+     */
+    TxTemplate(PacketSlab& slab, size_t pkt_len, uint8_t fill = 0)
+    : slab_(slab), len_(pkt_len) {
+        hdrs_.reserve(slab.capacity());
+        for (size_t i=0; i<slab.capacity(); ++i) {
+            uint8_t* p = slab.slot(i);
+            std::memset(p + sizeof(PacketHeader), fill, pkt_len - sizeof(PacketHeader));
+            PacketHeader h{};
+            h.magic = kMagic;
+            std::memcpy(p, &h, sizeof(h));
+            slab[i].data = p;
+            slab[i].len = static_cast<uint32_t>(pkt_len);
+            hdrs_.push_back(reinterpret_cast<PacketHeader*>(p));
+        }
+        slab.set_size(slab.capacity());
+    }
+ 
+    /**
+     * @brief Stamp the first @p n datagrams and make them the slab's batch.
+     * @param seq First sequence number; datagram @c i gets `seq + i`.
+     * @param ts  Send timestamp (@ref now_ns) written to every datagram.
+     * @return The sequence number following the batch.
+     */
+    uint64_t stamp(size_t n, uint64_t seq, uint64_t ts) {
+        if (n > hdrs_.size()) n = hdrs_.size();
+        for (size_t i=0; i<n; ++i) {
+            hdrs_[i]->seq = seq + i;
+            hdrs_[i]->send_ts_ns = ts;
+        }
+        slab_.set_size(n);
+        return seq + n;
+    }
+ 
+    /// @brief Slab the datagrams live in (pass it to @ref ISocket::send_batch).
+    PacketSlab& slab() { return slab_; }
+ 
+    /// @brief Bytes per datagram.
+    size_t packet_size() const { return len_; }
+ 
+    /// @brief Datagrams per batch (the slab capacity).
+    size_t capacity() const { return hdrs_.size(); }
+ 
+private:
+    PacketSlab&                slab_;
+    size_t                     len_;
+    std::vector<PacketHeader*> hdrs_; ///< Header of slot @c i (unaligned, packed).
+};
+ 
+} // namespace udp
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include "udp/socket.hpp"
+ 
+/**
+* @file
+* @brief Idle policies for receive loops (@ref udp::WaitStrategy).
+*
+* A receive loop calls @ref udp::WaitStrategy::after_recv with every batch result.
+* Non-empty batches return immediately; empty ones are handled per @ref udp::WaitKind:
+*  - **Spin:** retry at once. Lowest wake-up latency, one full core even when idle.
+*  - **SpinYield:** after @ref udp::WaitConfig::spin empty receives, @c sched_yield
+*    between retries. Still ~100% CPU, but gives the core to other runnable threads.
+*  - **SpinEpoll:** after @ref udp::WaitConfig::spin empty receives, sleep in
+*    @c epoll_wait on @ref udp::ISocket::wait_fd until data arrives or
+*    @ref udp::WaitConfig::timeout_ms passes. Near-zero idle CPU, one wake-up of
+*    latency after a quiet period.
+*  - **Block:** the socket itself blocks in @c recvmmsg (@c MSG_WAITFORONE, receive
+*    timeout @ref udp::WaitConfig::timeout_ms); the strategy only counts.
+*
+* Each strategy counts idle (empty) and busy (non-empty) iterations, so the CPU cost
+* of a policy can be read next to its latency.
+*
+* @note Thread-safety: owned and driven by the receive loop's thread.
+*/
+ 
+namespace udp {
+ 
+/// @brief How a receive loop waits when a batch receive comes back empty.
+enum class WaitKind {
+    Spin,      ///< Retry immediately.
+    SpinYield, ///< Spin, then @c sched_yield between retries.
+    SpinEpoll, ///< Spin, then @c epoll_wait on the socket (bounded by a timeout).
+    Block      ///< Blocking @c recvmmsg with @c MSG_WAITFORONE and a receive timeout.
+};
+ 
+/**
+* @brief Parse a CLI wait name ("spin", "spin-yield", "spin-epoll" or "block").
+* @return false if @p name is unknown (@p out is left untouched).
+*/
+bool parse_wait(const std::string& name, WaitKind& out);
+ 
+/// @brief CLI name of @p kind (inverse of @ref parse_wait).
+const char* wait_name(WaitKind kind);
+ 
+/// @brief Wait strategy knobs.
+struct WaitConfig {
+    WaitKind kind = WaitKind::Spin; ///< Idle policy.
+    unsigned spin = 1000;           ///< Empty receives before yielding/sleeping (SpinYield, SpinEpoll).
+    int      timeout_ms = 10;       ///< Longest single sleep (SpinEpoll, Block); bounds stop latency.
+};
+ 
+/**
+* @brief Idle policy plus idle/busy iteration counters for one receive loop.
+*
+* @details Construction prepares the socket: @ref WaitKind::Block switches it to
+* blocking receives through @ref ISocket::set_recv_wait, @ref WaitKind::SpinEpoll
+* registers @ref ISocket::wait_fd with a private epoll instance. If the socket cannot
+* support the requested kind, a note is printed to @c stderr and the strategy
+* degrades (Block to SpinEpoll to SpinYield); @ref kind reports the effective one.
+*/
+class WaitStrategy {
+public:
+    /**
+     * @brief Bind a strategy to @p sock, which must outlive it.
+     * @param sock Socket the loop receives from.
+     * @param cfg  Requested policy.
+     */
+    WaitStrategy(ISocket& sock, const WaitConfig& cfg);
+ 
+    /// @brief Restore non-blocking receives (Block) and close the epoll instance.
+    ~WaitStrategy();
+ 
+    WaitStrategy(const WaitStrategy&) = delete;
+    WaitStrategy& operator=(const WaitStrategy&) = delete;
+ 
+    /**
+     * @brief Account one receive result and, if it was empty, wait per policy.
+     * @param r Return value of `recv_batch` (errors count as idle).
+     */
+    void after_recv(ssize_t r) {
+        if (r > 0) {
+            busy_++;
+            empty_ = 0;
+            return;
+        }
+        idle_++;
+        if (kind_ == WaitKind::Spin || kind_ == WaitKind::Block) return;
+        if (empty_ < cfg_.spin) {
+            empty_++;
+            return;
+        }
+        backoff();
+    }
+ 
+    /// @brief Effective policy (after any fallback).
+    WaitKind kind() const { return kind_; }
+ 
+    /// @brief Iterations whose receive returned no datagrams.
+    uint64_t idle_iters() const { return idle_; }
+ 
+    /// @brief Iterations whose receive returned at least one datagram.
+    uint64_t busy_iters() const { return busy_; }
+ 
+private:
+    /// @brief Slow path once the spin budget is spent: yield or sleep in epoll.
+    void backoff();
+ 
+    ISocket&   sock_;
+    WaitConfig cfg_;
+    WaitKind   kind_;
+    int        epfd_ = -1;   ///< epoll instance (SpinEpoll only).
+    unsigned   empty_ = 0;   ///< Consecutive empty receives.
+    uint64_t   idle_ = 0;
+    uint64_t   busy_ = 0;
+};
+ 
+} // namespace udp
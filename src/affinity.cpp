@@ -0,0 +1,187 @@
+/**
+* @file
+* @brief CPU affinity (`sched_getaffinity` / `pthread_setaffinity_np`) and sysfs/mbind NUMA helpers.
+*/
+#include "udp/affinity.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+ 
+namespace udp {
+ 
+/// \copydoc udp::allowed_cpus
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &set)) cpus.push_back(c);
+#endif
+    return cpus;
+}
+ 
+/// \copydoc udp::pin_current_thread
+bool pin_current_thread(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        errno = EINVAL;
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) errno = rc;
+    return rc == 0;
+#else
+    (void)cpu;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+ 
+/// \copydoc udp::set_current_thread_fifo
+bool set_current_thread_fifo(int priority) {
+#if defined(__linux__)
+    if (priority < sched_get_priority_min(SCHED_FIFO) || priority > sched_get_priority_max(SCHED_FIFO)) {
+        errno = EINVAL;
+        return false;
+    }
+    sched_param sp{};
+    sp.sched_priority = priority;
+    const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+    if (rc != 0) errno = rc;
+    return rc == 0;
+#else
+    (void)priority;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+ 
+/// \cond INTERNAL
+/// @brief First line of a sysfs file (empty if unreadable).
+static std::string read_line(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    std::getline(f, line);
+    return line;
+}
+/// \endcond
+ 
+/// \copydoc udp::parse_cpu_list
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> out;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        int lo = 0, hi = 0;
+        char dash = 0;
+        std::istringstream is(item);
+        if (!(is >> lo)) return {};
+        hi = lo;
+        if (is >> dash && (dash != '-' || !(is >> hi))) return {};
+        if (lo < 0 || hi < lo) return {};
+        for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    return out;
+}
+ 
+/// \copydoc udp::numa_nodes
+std::vector<int> numa_nodes() {
+    return parse_cpu_list(read_line("/sys/devices/system/node/online"));
+}
+ 
+/// \copydoc udp::node_cpus
+std::vector<int> node_cpus(int node) {
+    if (node < 0) return {};
+    return parse_cpu_list(read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+}
+ 
+/// \copydoc udp::cpu_numa_node
+int cpu_numa_node(int cpu) {
+    for (int node : numa_nodes()) {
+        const std::vector<int> cpus = node_cpus(node);
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) return node;
+    }
+    return -1;
+}
+ 
+/// \copydoc udp::nic_numa_node
+int nic_numa_node(const std::string& ifname) {
+    if (ifname.empty() || ifname.find('/') != std::string::npos) return -1;
+    const std::string v = read_line("/sys/class/net/" + ifname + "/device/numa_node");
+    return v.empty() ? -1 : std::atoi(v.c_str());
+}
+ 
+/// \copydoc udp::pin_current_thread_to_node
+bool pin_current_thread_to_node(int node) {
+#if defined(__linux__)
+    const std::vector<int> cpus = node_cpus(node);
+    if (cpus.empty()) {
+        errno = ENOENT;
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) errno = rc;
+    return rc == 0;
+#else
+    (void)node;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+ 
+/// \copydoc udp::bind_memory_to_node
+bool bind_memory_to_node(void* addr, size_t len, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kBits = 8 * static_cast<int>(sizeof(unsigned long));
+    if (node < 0 || node >= 16 * kBits) {
+        errno = EINVAL;
+        return false;
+    }
+    unsigned long mask[16] = {};
+    mask[node / kBits] = 1ul << (node % kBits);
+    return syscall(SYS_mbind, addr, len, MPOL_PREFERRED, mask, 16 * kBits, 0) == 0;
+#else
+    (void)addr; (void)len; (void)node;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+ 
+/**
+* @details Anonymous mapping, preferred node set before the first touch, then
+* zero-filled by the caller's thread so every page is faulted in on that node.
+*/
+void* alloc_on_node(size_t bytes, int node) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    if (node >= 0) bind_memory_to_node(p, bytes, node);
+    std::memset(p, 0, bytes);
+    return p;
+}
+ 
+/// \copydoc udp::free_on_node
+void free_on_node(void* p, size_t bytes) {
+    if (p) munmap(p, bytes);
+}
+ 
+} // namespace udp
@@ -18,13 +18,17 @@
 
 *  - Maintain hot-path counters (`udp::Stats`) without locks.
 
+*  - In closed-loop mode, read echoes back and record round-trip times.
+
 *
 
 * Concurrency model:
 
-*  - One worker thread created by `start()` runs `run_loop()` until `stop()` or
+*  - `start()` creates one sender thread per socket; each runs `run_loop()` on its
+
+*    own socket, sequence space and stats shard until `stop()` or the configured
 
-*    the configured duration elapses.
+*    duration elapses.
 
 *  - Public getters (`stats()`) are safe to call from other threads.
 
@@ -32,9 +36,11 @@
 
 * Notes:
 
-*  - Pacing is best-effort and depends on OS scheduler granularity. We use
+*  - Pacing (`udp::Pacer`) sleeps with `clock_nanosleep(CLOCK_MONOTONIC, ...)`
+
+*    and spins the last stretch, so it is immune to wall-clock adjustments and
 
-*    `clock_nanosleep(CLOCK_MONOTONIC, ...)` to avoid wall-clock adjustments.
+*    to most of the scheduler's wake-up jitter.
 
 *  - Batch size amortizes syscall overhead (`send_batch` favors `sendmmsg`).
 
@@ -42,6 +48,10 @@
  
 #include "udp/client.hpp"
 
+#include "udp/affinity.hpp"
+
+#include "udp/tx_template.hpp"
+
 #include <iostream>
 
 #include <thread>
@@ -52,47 +62,204 @@
 
 #include <cstring>
 
+#include <cerrno>
+
+#include <algorithm>
+
+#include <cmath>
+
+#include <sstream>
+
+#include <stdexcept>
+
 #include <sys/time.h>
  
 namespace udp {
  
+/// \cond INTERNAL
+
+static std::vector<std::unique_ptr<ISocket>> one_socket(std::unique_ptr<ISocket> sock) {
+
+    std::vector<std::unique_ptr<ISocket>> v;
+
+    v.push_back(std::move(sock));
+
+    return v;
+
+}
+
+/// \endcond
+ 
+UdpClient::UdpClient(std::unique_ptr<ISocket> sock, ClientConfig cfg)
+
+: UdpClient(one_socket(std::move(sock)), cfg) {}
+ 
 /**
 
-* @brief Construct a UdpClient, connect the socket, and prepare for high-rate TX.
+* @brief Construct a UdpClient, connect every socket, and prepare for high-rate TX.
 
 *
 
 * @details
 
-* - Connects to `cfg_.server_ip:cfg_.port` so the socket can use the connected
+* - Connects each socket to `cfg_.server_ip:cfg_.port` so it can use the connected
+
+*   peer without per-send destination; every socket gets its own ephemeral
 
-*   peer without per-send destination.
+*   source port, so the server sees one client per sender thread.
 
 * - Requests a 1 MiB send buffer (`SO_SNDBUF`) as a reasonable default for bursty
 
 *   traffic.
 
+* - With `cfg_.gso`, enables UDP GSO on the socket: every batch is fixed-size and
+
+*   goes to one peer, so it leaves as one `UDP_SEGMENT` super-buffer per
+
+*   64 packets. Unsupported kernels keep plain batch sends (a note is printed).
+
+* - With `cfg_.zerocopy`, enables `MSG_ZEROCOPY` sends (same fallback behavior).
+
+* - With `cfg_.busy_poll`, applies the busy-poll options and logs the values read
+
+*   back from the socket.
+
+* - Splits `cfg_.pps` over the senders (the first ones take the remainder) and
+
+*   assigns their CPUs. Fallback notes are printed once, for the first socket.
+
 *
 
-* @param sock Socket strategy injected by the caller (ownership transferred).
+* @param socks Socket strategies injected by the caller (ownership transferred).
+
+* @param cfg   Client configuration (server endpoint, PPS, duration, payload, batch, etc.).
 
-* @param cfg  Client configuration (server endpoint, PPS, duration, payload, batch, etc.).
+* @throws std::invalid_argument if @p socks is empty.
 
 */
 
-UdpClient::UdpClient(std::unique_ptr<ISocket> sock, ClientConfig cfg)
+UdpClient::UdpClient(std::vector<std::unique_ptr<ISocket>> socks, ClientConfig cfg)
+
+: cfg_(cfg) {
+
+    if (socks.empty()) throw std::invalid_argument("UdpClient needs at least one socket");
+
+    const size_t n = socks.size();
+
+    cfg_.threads = static_cast<int>(n);
+
+    if (!cfg_.profile.empty()) cfg_.pps = std::max<uint64_t>(static_cast<uint64_t>(std::llround(cfg_.profile.peak())), 1);
+
+    std::vector<int> cpus = cfg_.cpu_list;
+
+    if (cpus.empty() && n > 1) {
+
+        cpus = allowed_cpus();
+
+        const int node = cfg_.nic.empty() ? -1 : nic_numa_node(cfg_.nic);
+
+        const std::vector<int> local = node_cpus(node);
+
+        std::vector<int> keep;
+
+        for (int c : cpus)
+
+            if (std::find(local.begin(), local.end(), c) != local.end()) keep.push_back(c);
+
+        if (!keep.empty()) cpus = keep;
+
+    }
+
+    for (size_t t=0; t<n; ++t) {
+
+        auto s = std::make_unique<Sender>();
+
+        s->sock = std::move(socks[t]);
+
+        s->index = t;
+
+        s->pps = std::max<uint64_t>(cfg_.pps / n + (t < cfg_.pps % n ? 1 : 0), 1);
+
+        if (!cpus.empty()) s->cpu = cpus[t % cpus.size()];
+
+        PacerConfig pc;
+
+        pc.pps = static_cast<double>(s->pps);
+
+        pc.chunk = cfg_.pace_chunk;
+
+        pc.max_chunk = static_cast<size_t>(std::max(cfg_.batch, 1));
+
+        pc.spin_ns = static_cast<uint64_t>(std::max(cfg_.pace_spin_us, 0)) * 1000;
+
+        pc.catch_up = cfg_.catch_up;
+
+        if (!cfg_.profile.empty()) {
+
+            const TrafficProfile::Point pt = cfg_.profile.at(0);
+
+            pc.pps = pt.pps * static_cast<double>(s->pps) / static_cast<double>(cfg_.pps);
+
+            pc.poisson = pt.poisson;
+
+        }
+
+        s->pacer = std::make_unique<Pacer>(pc);
+
+        ISocket& sock = *s->sock;
+
+        const bool log = t == 0;
+
+        sock.connect(cfg_.server_ip, cfg_.port);
+
+        sock.set_sndbuf(1<<20);
+
+        if (cfg_.gso && !sock.set_gso(true) && log) {
+
+            std::cerr << "[client " << cfg_.id << "] UDP GSO unavailable, using plain batch sends\n";
+
+        }
+
+        if (cfg_.zerocopy && !sock.set_zerocopy(true) && log) {
+
+            std::cerr << "[client " << cfg_.id << "] MSG_ZEROCOPY unavailable, using copying sends\n";
+
+        }
+
+        if (cfg_.rtt) {
+
+            sock.set_rcvbuf(4<<20);
+
+            if (!sock.set_rx_timestamps(true) && log) {
+
+                std::cerr << "[client " << cfg_.id << "] kernel RX timestamps unavailable, RTT includes echo pickup delay\n";
+
+            }
+
+        }
+
+        if (cfg_.busy_poll.enabled()) {
+
+            BusyPoll got = sock.set_busy_poll(cfg_.busy_poll);
 
-: sock_(std::move(sock)), cfg_(cfg) {
+            if (log) {
 
-    sock_->connect(cfg_.server_ip, cfg_.port);
+                std::cerr << "[client " << cfg_.id << "] busy poll requested " << cfg_.busy_poll.to_string()
+                          << ", effective " << got.to_string() << "\n";
+
+            }
+
+        }
 
-    sock_->set_sndbuf(1<<20);
+        senders_.push_back(std::move(s));
+
+    }
 
 }
  
 /**
 
-* @brief Destructor; ensures the worker thread is stopped and joined.
+* @brief Destructor; ensures the sender threads are stopped and joined.
 
 */
 
@@ -100,7 +267,7 @@ UdpClient::~UdpClient() { stop(); }
  
 /**
 
-* @brief Start the client: spawn the worker thread that performs paced sending.
+* @brief Start the client: spawn one sender thread per socket.
 
 */
 
@@ -108,31 +275,27 @@ void UdpClient::start() {
 
     running_ = true;
 
-    th_ = std::thread(&UdpClient::run_loop, this);
+    for (auto& s : senders_) s->th = std::thread(&UdpClient::run_loop, this, std::ref(*s));
 
 }
  
 /**
 
-* @brief Stop the client: request loop exit and join the worker thread (idempotent).
+* @brief Stop the client: request loop exit and join the sender threads (idempotent).
 
 */
 
 void UdpClient::stop() {
 
-    if (th_.joinable()) {
-
-        running_ = false;
+    running_ = false;
 
-        th_.join();
-
-    }
+    join();
 
 }
  
 /**
 
-* @brief Join the worker thread without forcing an early stop.
+* @brief Join the sender threads without forcing an early stop.
 
 *
 
@@ -146,19 +309,159 @@ void UdpClient::stop() {
 
 void UdpClient::join() {
 
-    // Wait until the worker thread exits naturally (e.g., after --seconds duration)
+    // Wait until the sender threads exit naturally (e.g., after --seconds duration)
+
+    for (auto& s : senders_) {
+
+        if (s->th.joinable()) s->th.join();
+
+    }
+
+}
+ 
+Stats UdpClient::stats() const {
+
+    Stats out;
+
+    for (const auto& s : senders_) out.merge_from(s->stats);
+
+    return out;
+
+}
+ 
+LatencyHistogram UdpClient::pacing_error() const {
+
+    LatencyHistogram out;
+
+    for (const auto& s : senders_) out.merge_from(s->pacer->error());
+
+    return out;
+
+}
+ 
+LatencyHistogram UdpClient::rtt() const {
+
+    LatencyHistogram out;
+
+    for (const auto& s : senders_) out.merge_from(s->stats.latency(Latency::RttRaw));
+
+    return out;
+
+}
+ 
+LatencyHistogram UdpClient::rtt_corrected() const {
+
+    LatencyHistogram out;
+
+    for (const auto& s : senders_) out.merge_from(s->stats.latency(Latency::Rtt));
+
+    return out;
+
+}
+ 
+uint64_t UdpClient::echoes() const {
+
+    uint64_t n = 0;
+
+    for (const auto& s : senders_) n += s->echoes.load(std::memory_order_relaxed);
+
+    return n;
+
+}
+ 
+uint64_t UdpClient::unmatched_echoes() const {
+
+    uint64_t n = 0;
+
+    for (const auto& s : senders_) n += s->unmatched.load(std::memory_order_relaxed);
+
+    return n;
+
+}
+ 
+double UdpClient::achieved_pps() const {
+
+    const uint64_t now = now_ns();
+
+    double pps = 0;
+
+    for (const auto& s : senders_) {
+
+        const uint64_t b = s->t_begin.load(std::memory_order_relaxed);
+
+        uint64_t e = s->t_end.load(std::memory_order_relaxed);
+
+        if (!e) e = now;
+
+        if (b && e > b) pps += static_cast<double>(s->stats.sent()) * 1e9 / static_cast<double>(e - b);
+
+    }
+
+    return pps;
+
+}
+ 
+uint64_t UdpClient::warmup_sent() const {
+
+    uint64_t n = 0;
+
+    for (const auto& s : senders_) n += s->warmup_sent.load(std::memory_order_relaxed);
+
+    return n;
+
+}
+ 
+uint64_t UdpClient::pacing_skipped() const {
+
+    uint64_t n = 0;
+
+    for (const auto& s : senders_) n += s->pacer->skipped();
+
+    return n;
+
+}
+ 
+std::string UdpClient::summary() const {
+
+    Stats all = stats();
+
+    LatencyHistogram err = pacing_error();
+
+    std::ostringstream oss;
+
+    oss << "sent=" << all.sent() << " tx_bytes=" << all.tx_bytes();
+
+    if (senders_.size() > 1) oss << " threads=" << senders_.size();
+
+    oss.setf(std::ios::fixed);
 
-    if (th_.joinable()) {
+    oss.precision(1);
 
-        th_.join();
+    oss << " pace_err_us p50=" << err.percentile(50) / 1e3 << " p99=" << err.percentile(99) / 1e3
+        << " max=" << err.max() / 1e3 << " skipped=" << pacing_skipped();
+
+    if (const uint64_t w = warmup_sent()) oss << " warmup=" << w;
+
+    oss << " achieved=" << human_rate(achieved_pps());
+
+    if (cfg_.rtt) {
+
+        LatencyHistogram co = rtt_corrected();
+
+        oss << " rtt_us p50=" << co.percentile(50) / 1e3 << " p99=" << co.percentile(99) / 1e3
+            << " p99.9=" << co.percentile(99.9) / 1e3 << " max=" << co.max() / 1e3
+            << " raw_p99=" << rtt().percentile(99) / 1e3
+            << " echoes=" << echoes() << " unmatched=" << unmatched_echoes();
 
     }
 
+    return oss.str();
+
 }
  
 /**
 
-* @brief Main worker loop: build batches, send, update stats, and pace to target PPS.
+* @brief Sender loop: build batches, send, update stats, and pace to the sender's PPS.
 
 *
 
@@ -166,115 +469,401 @@ void UdpClient::join() {
 
 * Pacing:
 
-* - `interval_ns = 1e9 / PPS` is the nominal spacing between packets.
+* - The sender's @ref Pacer schedules one packet every `1e9 / pps` ns, with `pps`
+
+*   this sender's share of `cfg_.pps`, and releases them in chunks of
+
+*   `cfg_.pace_chunk` (auto: ~10 µs worth, at most one slab), so a batch is
+
+*   spread over its slot instead of leaving as one line-rate burst.
+
+* - After a stall, `cfg_.catch_up` decides between bursting the backlog, capping
+
+*   it, or skipping it; the pacer records its release error for @ref summary.
 
-* - We send `batch` packets together and then advance the next target timestamp by
+* - With `cfg_.profile`, the target (rate, Poisson gaps, warm-up) is looked up
 
-*   `interval_ns * batch`, sleeping the difference if we're early.
+*   before every send from the time since the loop started, scaled by this
+
+*   sender's share, and the loop ends with the profile. Warm-up sends go to
+
+*   `warmup_sent` instead of the stats shard.
+
+*
+
+* Closed loop (`cfg_.rtt`):
+
+* - Each send remembers its packets' intended send times (pacer schedule) in a
+
+*   @ref kRttWindow ring indexed by `seq`; warm-up packets are remembered as
+
+*   not measured. Right after the send, @ref drain_echoes reads what came back.
+
+* - After the loop, echoes are drained until all counted packets are answered
+
+*   or `cfg_.rtt_linger_ms` passes.
 
 *
 
 * Payload:
 
-* - Each packet contains a `PacketHeader` at the start: incrementing `seq_`,
+* - Packets live in one @ref PacketSlab carved from a @ref PacketPool before the
+
+*   loop, on hugepages when `cfg_.hugepages` allows, and formatted once by a
 
-*   `send_ts_ns = now_ns()`, and `kMagic` for basic sanity checks.
+*   @ref TxTemplate (magic, payload, length). Per send only the released chunk's
+
+*   `seq` and `send_ts_ns` are patched, right before the send: no allocation,
+
+*   no zero-filling, one clock read.
+
+* - Placement comes first: the thread pins itself to its CPU, or else (with
+
+*   `cfg_.nic` on a known NUMA node) to that node's CPUs, switches to
+
+*   `SCHED_FIFO` if `cfg_.rt_priority` asks for it, and the pool is placed on the
+
+*   resulting node.
+
+* - Each packet contains a `PacketHeader` at the start: the sender's incrementing
+
+*   `seq`, the chunk's `send_ts_ns = now_ns()`, and `kMagic` for basic sanity checks.
 
 * - The total payload size is `max(cfg_.payload, sizeof(PacketHeader))`.
 
+* - In zero-copy mode the loop rotates through @ref kZeroCopySlabs slabs and only
+
+*   rewrites a slab once the kernel released every send issued from it.
+
 *
 
 * Counters:
 
 * - On successful `send_batch`, we increment `sent` by the number of messages and
 
-*   add all payload sizes to `tx_bytes`.
+*   add their payload sizes to `tx_bytes` (in this sender's shard).
+
+* - Outside warm-up, each `send_batch` duration goes into the shard's
+
+*   @ref Latency::SendCall histogram; echo receives into @ref Latency::RecvCall
+
+*   and round-trip times into @ref Latency::Rtt / @ref Latency::RttRaw.
 
 *
 
 * Verbose logging:
 
-* - Once per second (approx), prints cumulative `sent` and `tx_bytes` for this client.
+* - Once per second (approx), sender 0 prints the cumulative totals of all senders.
 
 */
 
-void UdpClient::run_loop() {
+void UdpClient::run_loop(Sender& s) {
 
-    const uint64_t interval_ns = 1'000'000'000ull / (cfg_.pps ? cfg_.pps : 1);
+    int node = -1;
 
-    uint64_t next_ts = now_ns();
+    if (s.cpu >= 0) {
 
-    auto start = std::chrono::steady_clock::now();
+        if (pin_current_thread(s.cpu)) node = cpu_numa_node(s.cpu);
+
+        else std::cerr << "[client " << cfg_.id << "] could not pin sender " << s.index << " to CPU " << s.cpu
+                       << ": " << std::strerror(errno) << "\n";
+
+    } else if (!cfg_.nic.empty() && (node = nic_numa_node(cfg_.nic)) >= 0 && !pin_current_thread_to_node(node)) {
+
+        std::cerr << "[client " << cfg_.id << "] could not pin to NUMA node " << node << ": " << std::strerror(errno) << "\n";
+
+        node = -1;
+
+    }
+
+    if (cfg_.rt_priority > 0 && !set_current_thread_fifo(cfg_.rt_priority)) {
 
-    auto end = start + std::chrono::seconds(cfg_.seconds);
+        std::cerr << "[client " << cfg_.id << "] could not set SCHED_FIFO priority " << cfg_.rt_priority
+                  << ": " << std::strerror(errno) << "\n";
+
+    }
+ 
+    ISocket& sock = *s.sock;
+
+    const size_t pkt_len = std::max(cfg_.payload, (int)sizeof(PacketHeader));
+
+    const size_t nslabs = sock.zerocopy() ? kZeroCopySlabs : 1;
+
+    PacketPool pool((nslabs + (cfg_.rtt ? 1 : 0)) * static_cast<size_t>(std::max(cfg_.batch, 1)), pkt_len, cfg_.hugepages, node);
+
+    if (cfg_.verbose && (!cfg_.nic.empty() || s.cpu >= 0)) {
+
+        std::cout << "[client " << cfg_.id << "] sender " << s.index << " cpu " << s.cpu << " node " << node
+                  << ", pool " << pool.to_string() << "\n";
+
+    }
+
+    std::vector<std::unique_ptr<PacketSlab>> slabs;
+
+    std::vector<TxTemplate> templates;
+
+    templates.reserve(nslabs);
+
+    for (size_t i=0; i<nslabs; ++i) {
+
+        slabs.push_back(std::make_unique<PacketSlab>(pool, cfg_.batch));
+
+        templates.emplace_back(*slabs.back(), pkt_len);
+
+    }
+
+    std::vector<uint64_t> released_at(nslabs, 0); // tx_issued() after the slab's last send
+
+    std::unique_ptr<PacketSlab> rx;
+
+    std::vector<Intended> intended;
+
+    if (cfg_.rtt) {
+
+        rx = std::make_unique<PacketSlab>(pool, cfg_.batch);
+
+        intended.resize(kRttWindow);
+
+    }
+
+    size_t cur = 0;
  
-    std::vector<std::vector<uint8_t>> batch;
+    Pacer& pacer = *s.pacer;
+
+    const TrafficProfile& prof = cfg_.profile;
+
+    const double share = static_cast<double>(s.pps) / static_cast<double>(cfg_.pps);
+
+    bool warmup = false;
+
+    const uint64_t t0 = now_ns();
+
+    uint64_t last_print_ns = t0;
 
-    batch.reserve(cfg_.batch);
+    auto start = std::chrono::steady_clock::now();
+
+    auto end = start + (prof.empty() ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(cfg_.seconds))
+
+                                     : std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(prof.duration())));
+
+    s.t_begin.store(t0, std::memory_order_relaxed);
+
+    pacer.start(t0);
  
     while (running_ && std::chrono::steady_clock::now() < end) {
 
-        // Prepare a batch of packets with header
+        TxTemplate& tpl = templates[cur];
+
+        if (nslabs > 1) reclaim_tx(s, released_at[cur]);
+
+        if (!prof.empty()) {
+
+            const TrafficProfile::Point pt = prof.at(static_cast<double>(now_ns() - t0) / 1e9);
+
+            if (pt.done) break;
+
+            if (pt.pps * share != pacer.rate()) pacer.set_rate(pt.pps * share);
 
-        batch.clear();
+            pacer.set_poisson(pt.poisson);
 
-        for (int i=0; i<cfg_.batch; ++i) {
+            if (pt.warmup != warmup) {
 
-            std::vector<uint8_t> pkt(std::max(cfg_.payload, (int)sizeof(PacketHeader)), 0);
+                pacer.set_measuring(!(warmup = pt.warmup));
 
-            PacketHeader* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+                if (!warmup) s.t_begin.store(now_ns(), std::memory_order_relaxed);
 
-            hdr->seq = ++seq_;
+            }
 
-            hdr->send_ts_ns = now_ns();
+        }
+
+        const size_t n = pacer.wait();
+
+        if (n == 0) continue;
+ 
+        // Patch the pre-built datagrams: sequence numbers and one send timestamp
+
+        const uint64_t first = s.seq + 1;
+
+        const uint64_t t_send = now_ns();
+
+        s.seq = tpl.stamp(n, first, t_send) - 1;
+
+        auto r = sock.send_batch(tpl.slab(), nullptr);
+
+        if (!warmup) s.stats.record_latency(Latency::SendCall, now_ns() - t_send);
+
+        if (r > 0 && warmup) {
+
+            s.warmup_sent.fetch_add(static_cast<uint64_t>(r), std::memory_order_relaxed);
 
-            hdr->magic = kMagic;
+        } else if (r > 0) {
 
-            batch.push_back(std::move(pkt));
+            s.stats.inc_sent(r);
+
+            s.stats.add_tx_bytes(static_cast<uint64_t>(r) * pkt_len);
 
         }
 
-        auto s = sock_->send_batch(batch, nullptr);
+        released_at[cur] = sock.tx_issued();
+
+        cur = (cur + 1) % nslabs;
+
+        if (rx) {
+
+            const double due = static_cast<double>(pacer.released_due());
+
+            for (size_t i=0; i<n; ++i) {
+
+                Intended& in = intended[(first + i) & (kRttWindow - 1)];
 
-        if (s > 0) {
+                in.seq = first + i;
 
-            stats_.inc_sent(s);
+                in.due = warmup ? 0 : static_cast<uint64_t>(due + static_cast<double>(i) * pacer.interval_ns());
 
-            size_t total_bytes = 0; for (auto& b: batch) total_bytes += b.size();
+            }
 
-            stats_.add_tx_bytes(total_bytes);
+            drain_echoes(s, *rx, intended);
 
         }
  
-        // Pace to target pps
+        const uint64_t now = now_ns();
 
-        next_ts += interval_ns * cfg_.batch;
+        if (cfg_.verbose && s.index == 0 && now - last_print_ns > 1'000'000'000ull) {
 
-        uint64_t now = now_ns();
+            std::cout << "[client " << cfg_.id << "] " << summary();
 
-        if (next_ts > now) {
+            if (!prof.empty()) {
 
-            uint64_t sleep_ns = next_ts - now;
+                double target = 0;
 
-            timespec ts{ (time_t)(sleep_ns/1'000'000'000ull), (long)(sleep_ns%1'000'000'000ull) };
+                for (const auto& o : senders_) target += o->pacer->rate();
 
-            clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, nullptr);
+                std::cout << " target=" << human_rate(target);
+
+            }
+
+            std::cout << "\n";
+
+            last_print_ns = now;
 
         }
+
+    }
+
+    s.t_end.store(now_ns(), std::memory_order_relaxed);
+
+    if (nslabs > 1) reclaim_tx(s, sock.tx_issued());
+
+    if (rx) {
+
+        const uint64_t linger_end = now_ns() + static_cast<uint64_t>(std::max(cfg_.rtt_linger_ms, 0)) * 1'000'000ull;
+
+        while (s.echoes.load(std::memory_order_relaxed) < s.stats.sent() && now_ns() < linger_end) {
+
+            if (!drain_echoes(s, *rx, intended)) Pacer::sleep_until(now_ns() + 100'000, 0);
+
+        }
+
+    }
+
+}
  
-        static uint64_t last_print_ns = now_ns();
+/**
 
-        if (cfg_.verbose && now - last_print_ns > 1'000'000'000ull) {
+* @brief Match pending echoes to sent packets and record both round-trip times.
 
-            std::cout << "[client " << cfg_.id << "] sent=" << stats_.sent()
-<< " tx_bytes=" << stats_.tx_bytes() << "\n";
+*
 
-            last_print_ns = now;
+* @details Up to four non-blocking receives per call. An echo counts once: its
+
+* window slot is cleared on the first match, so a duplicate (or a stale echo
+
+* whose slot was reused by a newer packet) is unmatched. Echoes of warm-up
+
+* packets match but are not measured.
+
+*/
+
+size_t UdpClient::drain_echoes(Sender& s, PacketSlab& rx, std::vector<Intended>& sent) {
+
+    size_t matched = 0;
+
+    uint64_t unmatched = 0;
+
+    for (int k=0; k<4; ++k) {
+
+        const uint64_t t0 = now_ns();
+
+        const ssize_t r = s.sock->recv_batch(rx);
+
+        if (r <= 0) break;
+
+        const uint64_t pickup = now_ns();
+
+        s.stats.record_latency(Latency::RecvCall, pickup - t0);
+
+        for (ssize_t i=0; i<r; ++i) {
+
+            const PacketView& v = rx[static_cast<size_t>(i)];
+
+            PacketHeader h;
+
+            if (v.len < sizeof(h)) { ++unmatched; continue; }
+
+            std::memcpy(&h, v.data, sizeof(h));
+
+            Intended& in = sent[h.seq & (kRttWindow - 1)];
+
+            if (h.magic != kMagic || in.seq != h.seq || h.seq == 0) { ++unmatched; continue; }
+
+            in.seq = 0;
+
+            if (!in.due) continue;
+
+            const uint64_t at = v.rx_ts_ns ? v.rx_ts_ns : pickup;
+
+            s.stats.record_latency(Latency::RttRaw, at > h.send_ts_ns ? at - h.send_ts_ns : 0);
+
+            s.stats.record_latency(Latency::Rtt, at > in.due ? at - in.due : 0);
+
+            ++matched;
 
         }
 
     }
 
+    if (matched) s.echoes.fetch_add(matched, std::memory_order_relaxed);
+
+    if (unmatched) s.unmatched.fetch_add(unmatched, std::memory_order_relaxed);
+
+    return matched;
+
+}
+ 
+/**
+
+* @brief Wait (yielding) until the socket released send `token`, folding new
+
+* zero-copy completions into the sender's stats as they are reaped.
+
+*/
+
+void UdpClient::reclaim_tx(Sender& s, uint64_t token) {
+
+    for (;;) {
+
+        TxCompletions c = s.sock->reap_tx();
+
+        s.stats.add_zc_completions(c.zerocopy - s.tx_seen.zerocopy, c.copied - s.tx_seen.copied);
+
+        s.tx_seen = c;
+
+        if (c.released >= token || !running_) return;
+
+        std::this_thread::yield();
+
+    }
+
 }
  
 } // namespace udp
@@ -0,0 +1,575 @@
+/**
+* @file
+* @brief IoUringSocket implementation on top of the raw io_uring syscalls.
+*
+* @details
+* Ring layout follows the kernel ABI directly (see `linux/io_uring.h`):
+*  - The SQ/CQ rings and the SQE array are mmap'ed from the ring fd once. The SQ
+*    index array is filled with the identity mapping at setup, so preparing an SQE
+*    is just "write `sqes_[tail & mask]`, bump the tail".
+*  - Receive uses a single multishot `IORING_OP_RECVMSG` with `IOSQE_BUFFER_SELECT`
+*    on buffer group @ref kBufGroup. Each completion names a provided buffer laid out
+*    as `io_uring_recvmsg_out | sockaddr_in | payload`.
+*  - Buffers handed to the caller are remembered in `rx_recycle_` and pushed back to
+*    the buffer ring (one release store of the tail) on the next receive.
+*  - Sends are one SQE each, published together and waited for with a single
+*    `io_uring_enter(GETEVENTS)` (or by spinning on the CQ when SQPOLL is active), so
+*    the caller may reuse its buffers as soon as `send_batch` returns.
+*
+* Shared indices are accessed with GCC/Clang `__atomic` builtins: acquire loads of
+* kernel-owned indices, release stores of user-owned ones.
+*
+* When the build has no io_uring headers (`UDP_HAVE_IO_URING` undefined) the class
+* still links, but its constructor throws so callers fall back to `UdpSocket`.
+*/
+#include "udp/io_uring_socket.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(UDP_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#endif
+ 
+namespace udp {
+ 
+#if defined(UDP_HAVE_IO_URING)
+ 
+/// \cond INTERNAL
+namespace {
+constexpr uint64_t kRecvTag   = 1; ///< user_data of the multishot receive.
+constexpr uint64_t kSendTag   = 2; ///< user_data of every send SQE.
+constexpr uint64_t kCancelTag = 3; ///< user_data of the shutdown cancel request.
+constexpr uint16_t kBufGroup  = 7; ///< Provided buffer group id.
+constexpr unsigned kSqpollSpins = 4096; ///< CQ polls per send batch before blocking (SQPOLL).
+ 
+/// @brief Smallest power of two >= v (v >= 1).
+unsigned next_pow2(unsigned v) {
+    unsigned p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+ 
+std::runtime_error sys_error(const char* what) {
+    return std::runtime_error(std::string(what) + ": " + strerror(errno));
+}
+} // namespace
+/// \endcond
+ 
+/**
+* @brief Create the UDP socket, the ring and the provided buffers, then arm receive.
+*
+* @details The socket is left in blocking mode: io_uring issues every request
+* non-blocking internally and parks it on the socket's poll queue when it would
+* block, instead of failing it with `EAGAIN`. Arming the multishot receive here
+* doubles as the feature probe — kernels without multishot `recvmsg` fail the
+* request with `EINVAL` immediately.
+*/
+IoUringSocket::IoUringSocket(int batch_hint, bool sqpoll)
+    : sockfd_(-1), ring_fd_(-1), connected_(false), sqpoll_(false), rx_armed_(false),
+      sq_ring_(nullptr), cq_ring_(nullptr), sq_ring_sz_(0), cq_ring_sz_(0),
+      sqes_(nullptr), sqes_sz_(0), sq_head_(nullptr), sq_tail_(nullptr), sq_flags_(nullptr),
+      sq_mask_(0), sq_entries_(0), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(0),
+      cqes_(nullptr), sq_local_tail_(0), sq_pending_(0),
+      br_(nullptr), br_sz_(0), rx_bufs_(nullptr),
+      rx_ready_(kRxBuffers), rx_ready_head_(0), rx_ready_count_(0), rx_error_(0),
+      tx_inflight_(0), tx_ok_(0), enter_calls_(0) {
+    const unsigned hint = batch_hint > 0 ? static_cast<unsigned>(batch_hint) : 1;
+    rx_recycle_.reserve(kRxBuffers);
+    rx_scratch_.resize(hint);
+    tx_msgs_.resize(hint);
+    tx_iov_.resize(hint);
+    try {
+        sockfd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (sockfd_ < 0) throw sys_error("socket() failed");
+        int one = 1;
+        setsockopt(sockfd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        setup_ring(next_pow2(hint < 8 ? 8 : hint), sqpoll);
+        setup_buffers();
+        arm_recv();
+        if (submit(0) < 0) throw sys_error("io_uring_enter() failed");
+        reap();
+        if (!rx_armed_ && rx_error_ == EINVAL)
+            throw std::runtime_error("multishot recvmsg not supported (needs Linux 6.0+)");
+    } catch (...) {
+        teardown();
+        throw;
+    }
+}
+ 
+/**
+* @brief Cancel the armed receive, wait for its final completion, then release everything.
+*
+* @details Waiting for the terminating receive CQE guarantees the kernel no longer
+* writes into `rx_bufs_` when it is unmapped.
+*/
+IoUringSocket::~IoUringSocket() {
+    if (ring_fd_ >= 0 && rx_armed_) {
+        io_uring_sqe* sqe = next_sqe();
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = kRecvTag;
+        sqe->user_data = kCancelTag;
+        submit(0);
+        for (int i = 0; i < 100 && rx_armed_; ++i) {
+            enter(0, 1, IORING_ENTER_GETEVENTS);
+            reap();
+        }
+    }
+    teardown();
+}
+ 
+/// @brief Unmap all ring memory and close both fds (safe on partially built objects).
+void IoUringSocket::teardown() {
+    if (ring_fd_ >= 0) ::close(ring_fd_);
+    ring_fd_ = -1;
+    if (sqes_) munmap(sqes_, sqes_sz_);
+    if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_sz_);
+    if (sq_ring_) munmap(sq_ring_, sq_ring_sz_);
+    if (br_) munmap(br_, br_sz_);
+    if (rx_bufs_) munmap(rx_bufs_, size_t(kRxBuffers) * kRxBufSize);
+    sqes_ = nullptr; cq_ring_ = sq_ring_ = nullptr; br_ = nullptr; rx_bufs_ = nullptr;
+    if (sockfd_ >= 0) ::close(sockfd_);
+    sockfd_ = -1;
+}
+ 
+/**
+* @brief `io_uring_setup` + mmap of the SQ/CQ rings and SQE array.
+*
+* @details The CQ is sized for every provided buffer to complete between two
+* receive calls, plus one full send batch. SQPOLL is retried without if refused.
+*/
+void IoUringSocket::setup_ring(unsigned entries, bool sqpoll) {
+    io_uring_params p{};
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = 2 * kRxBuffers + entries;
+    if (sqpoll) {
+        p.flags |= IORING_SETUP_SQPOLL;
+        p.sq_thread_idle = 1000; // ms before the kernel thread sleeps
+    }
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+    if (ring_fd_ < 0 && sqpoll) {
+        p = io_uring_params{};
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = 2 * kRxBuffers + entries;
+        ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+    }
+    if (ring_fd_ < 0) throw sys_error("io_uring_setup() failed");
+    sqpoll_ = (p.flags & IORING_SETUP_SQPOLL) != 0;
+ 
+    sq_ring_sz_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_ring_sz_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) sq_ring_sz_ = cq_ring_sz_ = std::max(sq_ring_sz_, cq_ring_sz_);
+    sq_ring_ = mmap(nullptr, sq_ring_sz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) { sq_ring_ = nullptr; throw sys_error("mmap(SQ ring) failed"); }
+    if (single) {
+        cq_ring_ = sq_ring_;
+    } else {
+        cq_ring_ = mmap(nullptr, cq_ring_sz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) { cq_ring_ = nullptr; throw sys_error("mmap(CQ ring) failed"); }
+    }
+    sqes_sz_ = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_sz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) throw sys_error("mmap(SQEs) failed");
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+ 
+    auto* sq = static_cast<uint8_t*>(sq_ring_);
+    auto* cq = static_cast<uint8_t*>(cq_ring_);
+    sq_head_    = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail_    = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_flags_   = reinterpret_cast<unsigned*>(sq + p.sq_off.flags);
+    sq_mask_    = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_entries_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_entries);
+    cq_head_    = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail_    = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cq_mask_    = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_       = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    auto* array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    for (unsigned i = 0; i < sq_entries_; ++i) array[i] = i;
+    sq_local_tail_ = *sq_tail_;
+}
+ 
+/**
+* @brief Allocate and register the provided buffer ring, then hand every buffer to it.
+* @throws std::runtime_error on kernels without `IORING_REGISTER_PBUF_RING` (< 5.19).
+*/
+void IoUringSocket::setup_buffers() {
+    br_sz_ = kRxBuffers * sizeof(io_uring_buf);
+    void* br = mmap(nullptr, br_sz_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (br == MAP_FAILED) throw sys_error("mmap(buffer ring) failed");
+    br_ = static_cast<io_uring_buf_ring*>(br);
+    void* bufs = mmap(nullptr, size_t(kRxBuffers) * kRxBufSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (bufs == MAP_FAILED) throw sys_error("mmap(receive buffers) failed");
+    rx_bufs_ = static_cast<uint8_t*>(bufs);
+ 
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(br_);
+    reg.ring_entries = kRxBuffers;
+    reg.bgid = kBufGroup;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        throw std::runtime_error("provided buffer rings not supported (needs Linux 5.19+): "
+                                 + std::string(strerror(errno)));
+    for (unsigned i = 0; i < kRxBuffers; ++i) rx_recycle_.push_back(static_cast<uint16_t>(i));
+    recycle_buffers();
+ 
+    rx_msg_.msg_namelen = sizeof(sockaddr_in);
+    rx_msg_.msg_controllen = 0;
+}
+ 
+/// @brief Raw `io_uring_enter`, retried on `EINTR`; counts calls.
+int IoUringSocket::enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    int r;
+    do {
+        ++enter_calls_;
+        r = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                                     flags, nullptr, 0));
+    } while (r < 0 && errno == EINTR);
+    return r;
+}
+ 
+/**
+* @brief Reserve the next SQE slot, submitting what is queued if the SQ is full.
+*/
+io_uring_sqe* IoUringSocket::next_sqe() {
+    while (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        if (submit(0) < 0 && !sqpoll_) break;
+    }
+    return &sqes_[sq_local_tail_++ & sq_mask_];
+}
+ 
+/**
+* @brief Publish prepared SQEs and, unless SQPOLL is active, submit them.
+*
+* @param min_complete Completions to wait for inside the same syscall (0 = don't wait).
+* @return Result of `io_uring_enter`, or 0 if no syscall was needed.
+*/
+int IoUringSocket::submit(unsigned min_complete) {
+    const unsigned published = __atomic_load_n(sq_tail_, __ATOMIC_RELAXED);
+    sq_pending_ += sq_local_tail_ - published;
+    __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+    if (sqpoll_) {
+        sq_pending_ = 0;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        unsigned flags = 0;
+        if (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        if (min_complete) flags |= IORING_ENTER_GETEVENTS;
+        return flags ? enter(0, min_complete, flags) : 0;
+    }
+    if (sq_pending_ == 0 && min_complete == 0) return 0;
+    int r = enter(sq_pending_, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0);
+    if (r > 0) sq_pending_ -= std::min<unsigned>(sq_pending_, static_cast<unsigned>(r));
+    return r;
+}
+ 
+/// @brief Queue the multishot recvmsg SQE (submitted by the caller).
+void IoUringSocket::arm_recv() {
+    io_uring_sqe* sqe = next_sqe();
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = sockfd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&rx_msg_);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufGroup;
+    sqe->user_data = kRecvTag;
+    rx_armed_ = true;
+    rx_error_ = 0;
+}
+ 
+/**
+* @brief Drain the CQ: receive completions go to `rx_ready_`, send completions
+* update the in-flight counters. Advances the CQ head once at the end.
+*/
+void IoUringSocket::reap() {
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        if (cqe.user_data == kRecvTag) {
+            if (cqe.res >= 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+                size_t at = (rx_ready_head_ + rx_ready_count_) % rx_ready_.size();
+                rx_ready_[at] = RxCompletion{static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT),
+                                             cqe.res};
+                rx_ready_count_++;
+            } else if (cqe.res < 0) { 
+                rx_error_ = -cqe.res;
+            }
+            if (!(cqe.flags & IORING_CQE_F_MORE)) rx_armed_ = false;
+        } else if (cqe.user_data == kSendTag) {
+            if (tx_inflight_) tx_inflight_--;
+            if (cqe.res >= 0) tx_ok_++;
+        }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+ 
+/**
+* @brief Return buffers consumed by the previous receive to the kernel.
+*
+* @details Entries are addressed from the ring base rather than through
+* `io_uring_buf_ring::bufs`: in C++ the uapi flex-array wrapper contains an empty
+* struct of size 1, which shifts `bufs` by 8 bytes away from the kernel layout.
+*/
+void IoUringSocket::recycle_buffers() {
+    if (rx_recycle_.empty()) return;
+    const unsigned mask = kRxBuffers - 1;
+    auto* bufs = reinterpret_cast<io_uring_buf*>(static_cast<void*>(br_));
+    unsigned short tail = br_->tail;
+    for (uint16_t bid : rx_recycle_) {
+        io_uring_buf& b = bufs[tail & mask];
+        b.addr = reinterpret_cast<uint64_t>(rx_bufs_ + size_t(bid) * kRxBufSize);
+        b.len = kRxBufSize;
+        b.bid = bid;
+        ++tail;
+    }
+    __atomic_store_n(&br_->tail, tail, __ATOMIC_RELEASE);
+    rx_recycle_.clear();
+}
+ 
+/**
+* @brief Common receive path: recycle, (re)arm if needed, reap, and fill up to @p max views.
+*
+* @details In the steady state (receive armed, completions already in the CQ) this
+* makes no syscall. CQ overflow (kernel-side backlog) is flushed with one
+* `io_uring_enter(GETEVENTS)`.
+*/
+ssize_t IoUringSocket::take_rx(PacketView* out, size_t max) {
+    recycle_buffers();
+    if (!rx_armed_) {
+        if (rx_error_ && rx_error_ != ENOBUFS) {
+            errno = rx_error_;
+            rx_error_ = 0;
+            arm_recv();
+            submit(0);
+            return -1;
+        }
+        arm_recv();
+    }
+    if (sq_local_tail_ != __atomic_load_n(sq_tail_, __ATOMIC_RELAXED) || sq_pending_) submit(0);
+    reap();
+    if (rx_ready_count_ == 0 && (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW)) {
+        enter(0, 0, IORING_ENTER_GETEVENTS);
+        reap();
+    }
+ 
+    size_t n = 0;
+    const size_t hdr = sizeof(io_uring_recvmsg_out) + rx_msg_.msg_namelen + rx_msg_.msg_controllen;
+    while (n < max && rx_ready_count_ > 0) {
+        const RxCompletion c = rx_ready_[rx_ready_head_];
+        rx_ready_head_ = (rx_ready_head_ + 1) % rx_ready_.size();
+        rx_ready_count_--;
+        rx_recycle_.push_back(c.bid);
+ 
+        uint8_t* buf = rx_bufs_ + size_t(c.bid) * kRxBufSize;
+        const auto* meta = reinterpret_cast<const io_uring_recvmsg_out*>(buf);
+        PacketView& v = out[n++];
+        v.data = buf + hdr;
+        v.len = static_cast<size_t>(c.res) > hdr ? static_cast<uint32_t>(c.res - hdr) : 0;
+        if (meta->namelen >= sizeof(sockaddr_in))
+            std::memcpy(&v.addr, buf + sizeof(io_uring_recvmsg_out), sizeof(sockaddr_in));
+        else
+            v.addr = sockaddr_in{};
+    }
+    return static_cast<ssize_t>(n);
+}
+ 
+/**
+* \copydoc udp::ISocket::recv_batch(PacketSlab&)
+*
+* @details Views point into the socket's provided buffers (no payload copy); they
+* stay valid until the next receive call on this socket.
+*/
+ssize_t IoUringSocket::recv_batch(PacketSlab& slab) {
+    slab.reset_views();
+    ssize_t n = take_rx(slab.begin(), slab.capacity());
+    if (n > 0) slab.set_size(static_cast<size_t>(n));
+    return n;
+}
+ 
+/**
+* \copydoc udp::ISocket::recv_batch(std::vector<std::vector<uint8_t>>&)
+*
+* @details Copies each datagram into the caller's buffer (truncating like `recvfrom`).
+*/
+ssize_t IoUringSocket::recv_batch(std::vector<std::vector<uint8_t>>& bufs) {
+    if (rx_scratch_.size() < bufs.size()) rx_scratch_.resize(bufs.size());
+    ssize_t n = take_rx(rx_scratch_.data(), bufs.size());
+    for (ssize_t i = 0; i < n; ++i) {
+        size_t len = std::min<size_t>(rx_scratch_[i].len, bufs[i].size());
+        std::memcpy(bufs[i].data(), rx_scratch_[i].data, len);
+    }
+    return n;
+}
+ 
+/**
+* @brief Fill one send SQE: `IORING_OP_SEND` when connected, else `IORING_OP_SENDMSG`
+* with @p dst as the destination.
+*/
+io_uring_sqe* IoUringSocket::prep_send(size_t i, const uint8_t* data, uint32_t len,
+                                       const sockaddr_in* dst) {
+    io_uring_sqe* sqe = next_sqe();
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = sockfd_;
+    sqe->user_data = kSendTag;
+    if (connected_) {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = len;
+        return sqe;
+    }
+    tx_iov_[i].iov_base = const_cast<uint8_t*>(data);
+    tx_iov_[i].iov_len = len;
+    msghdr& m = tx_msgs_[i];
+    std::memset(&m, 0, sizeof(m));
+    m.msg_name = const_cast<sockaddr_in*>(dst);
+    m.msg_namelen = sizeof(sockaddr_in);
+    m.msg_iov = &tx_iov_[i];
+    m.msg_iovlen = 1;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->addr = reinterpret_cast<uint64_t>(&m);
+    sqe->len = 1;
+    return sqe;
+}
+ 
+/**
+* @brief Submit @p n prepared sends and wait until all of them completed.
+*
+* @details With SQPOLL the CQ is polled for up to @ref kSqpollSpins rounds before
+* falling back to `io_uring_enter(GETEVENTS)`: when the kernel poller shares the
+* sender's core, spinning would only delay it until the next preemption.
+* @return Number of successful sends, or -1 if the ring could not be entered.
+*/
+ssize_t IoUringSocket::finish_sends(unsigned n) {
+    tx_inflight_ += n;
+    if (submit(sqpoll_ ? 0 : n) < 0) {
+        tx_inflight_ = 0;
+        return -1;
+    }
+    reap();
+    for (unsigned spins = 0; tx_inflight_ > 0; ++spins) {
+        if ((!sqpoll_ || spins >= kSqpollSpins) && enter(0, 1, IORING_ENTER_GETEVENTS) < 0) return -1;
+        reap();
+    }
+    return static_cast<ssize_t>(tx_ok_);
+}
+ 
+/**
+* \copydoc udp::ISocket::send_batch(const PacketSlab&,const sockaddr_in*)
+*
+* @details One SQE per view, one `io_uring_enter` for the whole batch (none with
+* SQPOLL while the poller keeps up). Returns after every send completed, so the
+* slab can be reused at once.
+*/
+ssize_t IoUringSocket::send_batch(const PacketSlab& slab, const sockaddr_in* addr) {
+    const size_t n = slab.size();
+    if (n == 0) return 0;
+    if (tx_msgs_.size() < n) { tx_msgs_.resize(n); tx_iov_.resize(n); }
+    tx_ok_ = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const PacketView& v = slab[i];
+        prep_send(i, v.data, v.len, addr ? addr : &v.addr);
+    }
+    return finish_sends(static_cast<unsigned>(n));
+}
+ 
+/// \copydoc udp::ISocket::send_batch(const std::vector<std::vector<uint8_t>>&,const sockaddr_in*)
+ssize_t IoUringSocket::send_batch(const std::vector<std::vector<uint8_t>>& bufs, const sockaddr_in* addr) {
+    const size_t n = bufs.size();
+    if (n == 0) return 0;
+    if (tx_msgs_.size() < n) { tx_msgs_.resize(n); tx_iov_.resize(n); }
+    tx_ok_ = 0;
+    for (size_t i = 0; i < n; ++i)
+        prep_send(i, bufs[i].data(), static_cast<uint32_t>(bufs[i].size()), addr);
+    return finish_sends(static_cast<unsigned>(n));
+}
+ 
+#else // !UDP_HAVE_IO_URING
+ 
+IoUringSocket::IoUringSocket(int, bool)
+    : sockfd_(-1), ring_fd_(-1), connected_(false), sqpoll_(false), rx_armed_(false),
+      sq_ring_(nullptr), cq_ring_(nullptr), sq_ring_sz_(0), cq_ring_sz_(0),
+      sqes_(nullptr), sqes_sz_(0), sq_head_(nullptr), sq_tail_(nullptr), sq_flags_(nullptr),
+      sq_mask_(0), sq_entries_(0), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(0),
+      cqes_(nullptr), sq_local_tail_(0), sq_pending_(0),
+      br_(nullptr), br_sz_(0), rx_bufs_(nullptr),
+      rx_ready_head_(0), rx_ready_count_(0), rx_error_(0),
+      tx_inflight_(0), tx_ok_(0), enter_calls_(0) {
+    throw std::runtime_error("io_uring support not compiled in");
+}
+IoUringSocket::~IoUringSocket() = default;
+ssize_t IoUringSocket::recv_batch(std::vector<std::vector<uint8_t>>&) { return -1; }
+ssize_t IoUringSocket::send_batch(const std::vector<std::vector<uint8_t>>&, const sockaddr_in*) { return -1; }
+ssize_t IoUringSocket::recv_batch(PacketSlab&) { return -1; }
+ssize_t IoUringSocket::send_batch(const PacketSlab&, const sockaddr_in*) { return -1; }
+ 
+#endif // UDP_HAVE_IO_URING
+ 
+/**
+* \copydoc udp::ISocket::bind
+*
+* @details Same semantics as `UdpSocket::bind` (optional `SO_REUSEPORT`, `INADDR_ANY`).
+*/
+void IoUringSocket::bind(uint16_t port, bool reuseport) {
+    if (reuseport) {
+#ifdef SO_REUSEPORT
+        int one = 1;
+        setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+    if (::bind(sockfd_, (sockaddr*)&addr, sizeof(addr)) < 0)
+        throw std::runtime_error("bind() failed: " + std::string(strerror(errno)));
+}
+ 
+/**
+* \copydoc udp::ISocket::connect
+*
+* @details After connecting, sends use `IORING_OP_SEND` (no per-packet msghdr).
+*/
+void IoUringSocket::connect(const std::string& ip, uint16_t port) {
+    std::memset(&peer_, 0, sizeof(peer_));
+    peer_.sin_family = AF_INET;
+    inet_pton(AF_INET, ip.c_str(), &peer_.sin_addr);
+    peer_.sin_port = htons(port);
+    if (::connect(sockfd_, (sockaddr*)&peer_, sizeof(peer_)) < 0)
+        throw std::runtime_error("connect() failed: " + std::string(strerror(errno)));
+    connected_ = true;
+}
+ 
+/// \copydoc udp::ISocket::set_rcvbuf
+void IoUringSocket::set_rcvbuf(int bytes) {
+    setsockopt(sockfd_, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+}
+ 
+/// \copydoc udp::ISocket::set_sndbuf
+void IoUringSocket::set_sndbuf(int bytes) {
+    setsockopt(sockfd_, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes));
+}
+ 
+/**
+* @brief Build a throwaway instance; any construction failure means "unsupported".
+*/
+bool IoUringSocket::supported(std::string* why) {
+    try {
+        IoUringSocket probe(8, false);
+        return true;
+    } catch (const std::exception& e) {
+        if (why) *why = e.what();
+        return false;
+    }
+}
+ 
+} // namespace udp
@@ -12,7 +12,7 @@
 
 *  - Parse command-line options into @ref udp::ClientConfig.
 
-*  - Construct a concrete socket (@ref udp::UdpSocket) and the @ref udp::UdpClient.
+*  - Construct a concrete socket (via @ref udp::create_socket) and the @ref udp::UdpClient.
 
 *  - Start the client worker thread and wait for natural completion (based on `--seconds`).
 
@@ -32,6 +32,58 @@
 
 *  - `--batch <n>`    : Messages per `send_batch` call (amortizes syscalls).
 
+*  - `--backend <b>`  : Socket backend, `mmsg` (default) or `io_uring`.
+
+*  - `--io-uring-sqpoll` : With `--backend io_uring`, submit through a kernel SQ polling thread.
+
+*  - `--gso`          : Send through UDP GSO (`UDP_SEGMENT`) when the kernel supports it.
+
+*  - `--zerocopy`     : Send with `MSG_ZEROCOPY` when supported (pays off for large payloads).
+
+*  - `--no-hugepages` : Keep the send slabs on regular pages.
+
+*  - `--nic <if>`     : Interface the traffic leaves on; the send thread and its buffers
+
+*                       stay on that interface's NUMA node.
+
+*  - `--threads <n>` : Sender threads in this process, each with its own socket
+
+*                       (source port), sequence space and stats; `--pps` is split
+
+*                       between them (default: 1).
+
+*  - `--cpu-list <list>`: CPUs for the sender threads in order, e.g. `2-5` (wrapping).
+
+*  - `--rt-priority <p>`: Run the sender threads under `SCHED_FIFO` priority @c p (1-99).
+
+*  - `--pace-chunk <n>`: Packets per paced send (default 0 = auto, ~10 µs of traffic).
+
+*  - `--pace-spin-us <n>`: Busy-wait window before each send deadline (default 20).
+
+*  - `--catch-up <p>` : After falling behind schedule, `burst` the backlog, `cap` it
+
+*                       at one batch (default) or `skip` it.
+
+*  - `--profile <spec>`: Time-varying schedule replacing `--pps`/`--seconds`, e.g.
+
+*                       `warmup:10k:2s,ramp:10k:200k:10s,onoff:500k:50ms:450ms:5s`
+
+*                       (see udp/traffic_profile.hpp).
+
+*  - `--schedule <file>`: Same, one phase per line (`#` comments).
+
+*  - `--rtt`          : Closed loop against `udp_server --echo`: match echoes by
+
+*                       sequence number and report round-trip percentiles
+
+*                       (coordinated-omission corrected) in the final line.
+
+*  - `--rtt-linger-ms <n>`: Wait at most this long for echoes after the last send (default 200).
+
+*  - `--busy-poll <us>`, `--busy-poll-budget <n>`, `--prefer-busy-poll` : Kernel busy
+
+*                       polling for receives on the client socket.
+
 *  - `--id <n>`       : Client identifier for verbose logs.
 
 *  - `--verbose`      : Print periodic transmit stats (approx once per second).
@@ -52,9 +104,15 @@
 
 #include "udp/socket.hpp"
 
+#include "udp/affinity.hpp"
+
 #include <iostream>
 
 #include <cstring>
+
+#include <algorithm>
+
+#include <vector>
  
 using namespace udp;
  
@@ -78,13 +136,15 @@ using namespace udp;
 
 *  1. Parse CLI flags into @ref udp::ClientConfig.
 
-*  2. Create a @ref udp::UdpSocket with the batch hint and pass it (via `std::unique_ptr`)
+*  2. Create one socket per `--threads` with the selected backend and the batch hint
+
+*     (@ref udp::create_socket falls back to @ref udp::UdpSocket if io_uring is
 
-*     to @ref udp::UdpClient.
+*     unavailable) and pass them to @ref udp::UdpClient.
 
-*  3. Start the client's worker thread and `join()` to wait for natural completion
+*  3. Start the sender threads and `join()` to wait for natural completion
 
-*     (driven by `--seconds`).
+*     (driven by `--seconds`), then print one summary line for all threads.
 
 *  4. Catch and report any exception to `stderr`, returning a non-zero exit code.
 
@@ -94,6 +154,12 @@ int main(int argc, char** argv) {
 
     ClientConfig cfg;
 
+    SocketBackend backend = SocketBackend::Mmsg;
+
+    bool sqpoll = false;
+
+    int threads = 1;
+
     for (int i=1;i<argc;i++){
 
         if (!strcmp(argv[i],"--server") && i+1<argc) cfg.server_ip = argv[++i];
@@ -108,13 +174,99 @@ int main(int argc, char** argv) {
 
         else if (!strcmp(argv[i],"--batch") && i+1<argc) cfg.batch = atoi(argv[++i]);
 
+        else if (!strcmp(argv[i],"--backend") && i+1<argc) {
+
+            if (!parse_backend(argv[++i], backend)) {
+
+                std::cerr << "Unknown backend: " << argv[i] << " (expected mmsg|io_uring)\n";
+
+                return 1;
+
+            }
+
+        }
+
+        else if (!strcmp(argv[i],"--io-uring-sqpoll")) sqpoll = true;
+
         else if (!strcmp(argv[i],"--id") && i+1<argc) cfg.id = atoi(argv[++i]);
 
+        else if (!strcmp(argv[i],"--cpu-list") && i+1<argc) {
+
+            std::vector<int> cpus = parse_cpu_list(argv[++i]);
+
+            if (cpus.empty()) {
+
+                std::cerr << "Bad CPU list: " << argv[i] << " (expected e.g. 2-5,8)\n";
+
+                return 1;
+
+            }
+
+            cfg.cpu_list = cpus;
+
+        }
+
+        else if (!strcmp(argv[i],"--threads") && i+1<argc) threads = std::max(1, atoi(argv[++i]));
+
+        else if (!strcmp(argv[i],"--rt-priority") && i+1<argc) cfg.rt_priority = std::max(0, atoi(argv[++i]));
+
+        else if (!strcmp(argv[i],"--pace-chunk") && i+1<argc) cfg.pace_chunk = (size_t)std::max(0, atoi(argv[++i]));
+
+        else if (!strcmp(argv[i],"--pace-spin-us") && i+1<argc) cfg.pace_spin_us = std::max(0, atoi(argv[++i]));
+
+        else if (!strcmp(argv[i],"--catch-up") && i+1<argc) {
+
+            if (!parse_catch_up(argv[++i], cfg.catch_up)) {
+
+                std::cerr << "Unknown catch-up policy: " << argv[i] << " (expected burst|cap|skip)\n";
+
+                return 1;
+
+            }
+
+        }
+
+        else if ((!strcmp(argv[i],"--profile") || !strcmp(argv[i],"--schedule")) && i+1<argc) {
+
+            const bool file = !strcmp(argv[i],"--schedule");
+
+            try {
+
+                cfg.profile = file ? TrafficProfile::load(argv[++i]) : TrafficProfile::parse(argv[++i]);
+
+            } catch (const std::exception& e) {
+
+                std::cerr << "Bad traffic profile: " << e.what() << "\n";
+
+                return 1;
+
+            }
+
+        }
+
+        else if (!strcmp(argv[i],"--busy-poll") && i+1<argc) cfg.busy_poll.usecs = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i],"--busy-poll-budget") && i+1<argc) cfg.busy_poll.budget = atoi(argv[++i]);
+
+        else if (!strcmp(argv[i],"--prefer-busy-poll")) cfg.busy_poll.prefer = true;
+
+        else if (!strcmp(argv[i],"--rtt")) cfg.rtt = true;
+
+        else if (!strcmp(argv[i],"--rtt-linger-ms") && i+1<argc) cfg.rtt_linger_ms = std::max(0, atoi(argv[++i]));
+
+        else if (!strcmp(argv[i],"--gso")) cfg.gso = true;
+
+        else if (!strcmp(argv[i],"--zerocopy")) cfg.zerocopy = true;
+
+        else if (!strcmp(argv[i],"--no-hugepages")) cfg.hugepages = false;
+
+        else if (!strcmp(argv[i],"--nic") && i+1<argc) cfg.nic = argv[++i];
+
         else if (!strcmp(argv[i],"--verbose")) cfg.verbose = true;
 
         else if (!strcmp(argv[i],"--help")) {
 
-            std::cout << "udp_client --server <ip> --port <p> --pps <n> --seconds <n> --payload <n> --batch <n> --id <n> [--verbose]\n";
+            std::cout << "udp_client --server <ip> --port <p> --pps <n> --seconds <n> --payload <n> --batch <n> --backend <mmsg|io_uring> [--io-uring-sqpoll] --id <n> --threads <n> --cpu-list <list> --rt-priority <p> --pace-chunk <n> --pace-spin-us <n> --catch-up <burst|cap|skip> --profile <spec> --schedule <file> [--rtt] --rtt-linger-ms <n> --busy-poll <us> --busy-poll-budget <n> [--prefer-busy-poll] [--gso] [--zerocopy] [--no-hugepages] [--nic <if>] [--verbose]\n";
 
             return 0;
 
@@ -124,16 +276,27 @@ int main(int argc, char** argv) {
 
     try {
 
-        auto sock = std::make_unique<UdpSocket>(cfg.batch);
+        std::vector<std::unique_ptr<ISocket>> socks;
+
+        for (int t = 0; t < threads; ++t) socks.push_back(create_socket(backend, cfg.batch, sqpoll));
 
-        UdpClient client(std::move(sock), cfg);
+        UdpClient client(std::move(socks), cfg);
+
+        if (cfg.verbose && !cfg.profile.empty()) {
+
+            std::cout << "[client " << cfg.id << "] profile " << cfg.profile.to_string()
+                      << " (" << cfg.profile.duration() << " s)\n";
+
+        }
 
         client.start();
 
-        // Wait for the client run loop to finish based on --seconds.
+        // Wait for the sender threads to finish based on --seconds.
 
         client.join();
 
+        std::cout << "[client " << cfg.id << "] done " << client.summary() << "\n";
+
         return 0;
 
     } catch (const std::exception& e) {
@@ -12,7 +12,9 @@
 
 *  - Parse command-line options into @ref udp::ServerConfig.
 
-*  - Construct a concrete socket (@ref udp::UdpSocket) and the @ref udp::UdpServer.
+*  - Construct the concrete sockets (via @ref udp::create_socket, one per worker) and
+
+*    the @ref udp::UdpServer.
 
 *  - Start the server worker thread, install signal handlers, and idle until termination.
 
@@ -26,6 +28,22 @@
 
 *  - `--batch <n>`          : Batch size for recv/send operations (default: 64).
 
+*  - `--workers <n>`        : Receive loops, each pinned to its own core with its own
+
+*                             socket in one `SO_REUSEPORT` group (default: 1).
+
+*  - `--steering <s>`       : How `--workers` split flows: `kernel` (4-tuple hash, default),
+
+*                             `cpu` (receive softirq CPU), `src-ip`, `src-port` or `flow`.
+
+*  - `--pipeline`           : Split each worker into an RX thread and a processing thread.
+
+*  - `--ring-depth <n>`     : Receive batches buffered per `--pipeline` worker (default: 256).
+
+*  - `--backend <b>`        : Socket backend, `mmsg` (default) or `io_uring`.
+
+*  - `--io-uring-sqpoll`    : With `--backend io_uring`, submit through a kernel SQ polling thread.
+
 *  - `--metrics-port <p>`   : Loopback HTTP port for /metrics (0 disables; default: 9100).
 
 *  - `--max-clients <n>`    : **Admission cap** for distinct clients (default: 100).
@@ -34,6 +52,42 @@
 
 *  - `--reuseport`          : Request SO_REUSEPORT (if supported by the platform).
 
+*  - `--gso`                : Echo through UDP GSO (`UDP_SEGMENT`) when supported.
+
+*  - `--gro`                : Receive through UDP GRO (`UDP_GRO`) when supported.
+
+*  - `--zerocopy`           : Echo with `MSG_ZEROCOPY` when supported (not with `--gro`).
+
+*  - `--no-rx-timestamps`   : Disable kernel RX timestamps (and the delay metrics).
+
+*  - `--no-hugepages`       : Keep the packet pool on regular pages.
+
+*  - `--nic <if>`           : Interface traffic arrives on; workers, their stats and
+
+*                             packet pools are placed on its NUMA node.
+
+*  - `--cpu-list <list>`    : Explicit CPUs for worker threads, e.g. `2-5,8`, taken in
+
+*                             order (RX then processing thread with `--pipeline`).
+
+*  - `--metrics-cpu <c>`    : Pin the `/metrics` thread to CPU @c c.
+
+*  - `--rt-priority <p>`    : Run worker threads under `SCHED_FIFO` priority @c p (1-99).
+
+*  - `--busy-poll <us>`     : `SO_BUSY_POLL` microseconds (switches `--wait spin` to `block`).
+
+*  - `--busy-poll-budget <n>`: `SO_BUSY_POLL_BUDGET` packets per poll.
+
+*  - `--prefer-busy-poll`   : `SO_PREFER_BUSY_POLL`.
+
+*  - `--wait <w>`           : Idle policy: `spin` (default), `spin-yield`, `spin-epoll`
+
+*                             or `block` (blocking `recvmmsg` with `MSG_WAITFORONE`).
+
+*  - `--wait-spin <n>`      : Empty receives before yielding/sleeping (default: 1000).
+
+*  - `--wait-timeout-ms <n>`: Longest single sleep for `spin-epoll`/`block` (default: 10).
+
 *  - `--verbose | --quiet`  : Toggle periodic server stats logging.
 
 *  - `--help`               : Print usage and exit.
@@ -60,6 +114,8 @@
 
 #include "udp/socket.hpp"
 
+#include "udp/affinity.hpp"
+
 #include <iostream>
 
 #include <cstring>
@@ -73,6 +129,10 @@
 #include <csignal>
 
 #include <cstdlib>  // for strtoull
+
+#include <algorithm>
+
+#include <vector>
  
 using namespace udp;
  
@@ -90,6 +150,10 @@ int main(int argc, char** argv) {
 
     ServerConfig cfg;
 
+    SocketBackend backend = SocketBackend::Mmsg;
+
+    bool sqpoll = false;
+
     for (int i = 1; i < argc; i++) {
 
         if (!std::strcmp(argv[i], "--port") && i + 1 < argc) {
@@ -100,6 +164,62 @@ int main(int argc, char** argv) {
 
             cfg.batch = std::atoi(argv[++i]);
 
+        } else if (!std::strcmp(argv[i], "--workers") && i + 1 < argc) {
+
+            cfg.workers = std::max(1, std::atoi(argv[++i]));
+
+        } else if (!std::strcmp(argv[i], "--steering") && i + 1 < argc) {
+
+            if (!parse_steering(argv[++i], cfg.steering)) {
+
+                std::cerr << "Unknown steering: " << argv[i] << " (expected kernel|cpu|src-ip|src-port|flow)\n";
+
+                return 1;
+
+            }
+
+        } else if (!std::strcmp(argv[i], "--cpu-list") && i + 1 < argc) {
+
+            cfg.cpu_list = parse_cpu_list(argv[++i]);
+
+            if (cfg.cpu_list.empty()) {
+
+                std::cerr << "Bad CPU list: " << argv[i] << " (expected e.g. 2-5,8)\n";
+
+                return 1;
+
+            }
+
+        } else if (!std::strcmp(argv[i], "--metrics-cpu") && i + 1 < argc) {
+
+            cfg.metrics_cpu = std::atoi(argv[++i]);
+
+        } else if (!std::strcmp(argv[i], "--rt-priority") && i + 1 < argc) {
+
+            cfg.rt_priority = std::max(0, std::atoi(argv[++i]));
+
+        } else if (!std::strcmp(argv[i], "--pipeline")) {
+
+            cfg.pipeline = true;
+
+        } else if (!std::strcmp(argv[i], "--ring-depth") && i + 1 < argc) {
+
+            cfg.ring_depth = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+
+        } else if (!std::strcmp(argv[i], "--backend") && i + 1 < argc) {
+
+            if (!parse_backend(argv[++i], backend)) {
+
+                std::cerr << "Unknown backend: " << argv[i] << " (expected mmsg|io_uring)\n";
+
+                return 1;
+
+            }
+
+        } else if (!std::strcmp(argv[i], "--io-uring-sqpoll")) {
+
+            sqpoll = true;
+
         } else if (!std::strcmp(argv[i], "--metrics-port") && i + 1 < argc) {
 
             cfg.metrics_port = static_cast<uint16_t>(std::atoi(argv[++i]));
@@ -116,6 +236,60 @@ int main(int argc, char** argv) {
 
             cfg.reuseport = true;
 
+        } else if (!std::strcmp(argv[i], "--gso")) {
+
+            cfg.gso = true;
+
+        } else if (!std::strcmp(argv[i], "--gro")) {
+
+            cfg.gro = true;
+
+        } else if (!std::strcmp(argv[i], "--zerocopy")) {
+
+            cfg.zerocopy = true;
+
+        } else if (!std::strcmp(argv[i], "--wait") && i + 1 < argc) {
+
+            if (!parse_wait(argv[++i], cfg.wait.kind)) {
+
+                std::cerr << "Unknown wait strategy: " << argv[i] << " (expected spin|spin-yield|spin-epoll|block)\n";
+
+                return 1;
+
+            }
+
+        } else if (!std::strcmp(argv[i], "--wait-spin") && i + 1 < argc) {
+
+            cfg.wait.spin = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+
+        } else if (!std::strcmp(argv[i], "--wait-timeout-ms") && i + 1 < argc) {
+
+            cfg.wait.timeout_ms = std::atoi(argv[++i]);
+
+        } else if (!std::strcmp(argv[i], "--busy-poll") && i + 1 < argc) {
+
+            cfg.busy_poll.usecs = std::atoi(argv[++i]);
+
+        } else if (!std::strcmp(argv[i], "--busy-poll-budget") && i + 1 < argc) {
+
+            cfg.busy_poll.budget = std::atoi(argv[++i]);
+
+        } else if (!std::strcmp(argv[i], "--prefer-busy-poll")) {
+
+            cfg.busy_poll.prefer = true;
+
+        } else if (!std::strcmp(argv[i], "--no-hugepages")) {
+
+            cfg.hugepages = false;
+
+        } else if (!std::strcmp(argv[i], "--nic") && i + 1 < argc) {
+
+            cfg.nic = argv[++i];
+
+        } else if (!std::strcmp(argv[i], "--no-rx-timestamps")) {
+
+            cfg.rx_timestamps = false;
+
         } else if (!std::strcmp(argv[i], "--verbose")) {
 
             cfg.verbose = true;
@@ -130,9 +304,16 @@ int main(int argc, char** argv) {
 << "udp_server "
 << "--port <p> "
 << "--batch <n> "
+<< "--workers <n> "
+<< "--cpu-list <list> --metrics-cpu <c> --rt-priority <p> "
+<< "--steering <kernel|cpu|src-ip|src-port|flow> "
+<< "[--pipeline] --ring-depth <n> "
+<< "--backend <mmsg|io_uring> [--io-uring-sqpoll] "
 << "--metrics-port <p> "
 << "--max-clients <n> "
-<< "[--echo] [--reuseport] [--verbose|--quiet]\n";
+<< "--wait <spin|spin-yield|spin-epoll|block> --wait-spin <n> --wait-timeout-ms <n> "
+<< "--busy-poll <us> --busy-poll-budget <n> [--prefer-busy-poll] "
+<< "[--echo] [--reuseport] [--gso] [--gro] [--zerocopy] [--no-rx-timestamps] [--no-hugepages] [--nic <if>] [--verbose|--quiet]\n";
 
             return 0;
 
@@ -142,9 +323,11 @@ int main(int argc, char** argv) {
  
     try {
 
-        auto sock = std::make_unique<UdpSocket>(cfg.batch);
+        std::vector<std::unique_ptr<ISocket>> socks;
+
+        for (int w = 0; w < cfg.workers; ++w) socks.push_back(create_socket(backend, cfg.batch, sqpoll));
 
-        UdpServer server(std::move(sock), cfg);
+        UdpServer server(std::move(socks), cfg);
 
         server.start();
  
@@ -38,6 +38,8 @@
  
 #include "udp/metrics_http.hpp"
 
+#include "udp/affinity.hpp"
+
 #include <sys/socket.h>
 
 #include <netinet/in.h>
@@ -48,6 +50,10 @@
 
 #include <cstring>
 
+#include <cerrno>
+
+#include <iostream>
+
 #include <sstream>
 
 #include <thread>
@@ -68,7 +74,25 @@ namespace udp {
 
 MetricsHttpServer::MetricsHttpServer(Stats& stats, uint16_t port)
 
-: stats_(stats), port_(port) {}
+: collect_([&stats](Stats& out) { out.merge_from(stats); }), port_(port) {}
+ 
+/**
+
+* @brief Construct a metrics server that assembles its counters on every scrape.
+
+* @param collect Called with an empty @ref udp::Stats to merge the live shards into.
+
+* @param port    TCP port to listen on (0 disables the server).
+
+* @param extra   Optional source of additional exposition lines.
+
+*/
+
+MetricsHttpServer::MetricsHttpServer(std::function<void(Stats&)> collect, uint16_t port,
+
+                                     std::function<std::string()> extra)
+
+: collect_(std::move(collect)), extra_(std::move(extra)), port_(port) {}
  
 /**
 
@@ -134,6 +158,42 @@ void MetricsHttpServer::stop() {
 
 *  - `udp_tx_bytes_total` (counter)
 
+*  - `udp_tx_zerocopy_total` (counter)
+
+*  - `udp_tx_zerocopy_copied_total` (counter)
+
+*  - `udp_rx_loop_idle_total`, `udp_rx_loop_busy_total` (counters)
+
+*  - `udp_packets_lost` (gauge: may fall as late datagrams arrive),
+
+*    `udp_packets_reordered_total`, `udp_packets_duplicate_total`,
+
+*    `udp_packets_invalid_total` (counters; see @ref udp::SeqWindow). Tracked per
+
+*    worker, so overstated when a flow is split across workers (`--steering cpu`).
+
+*  - `udp_rx_queue_delay_seconds`, `udp_rx_processing_delay_seconds`
+
+*    (summaries: `_sum` and `_count` only; need kernel RX timestamps)
+
+*  - `udp_one_way_latency_seconds` (needs kernel RX timestamps),
+
+*    `udp_rtt_seconds`, `udp_rtt_raw_seconds`, `udp_recv_call_seconds`,
+
+*    `udp_send_call_seconds` (histograms, one per @ref udp::Latency kind, with
+
+*    cumulative `le` buckets from 1 µs to 1 s; bucket edges are exact to the
+
+*    ~3% resolution of @ref udp::LatencyHistogram). Kinds nothing records into
+
+*    (e.g. RTT on the server) are omitted.
+
+*
+
+* Counters come from a fresh snapshot filled by the collect callback, so sharded
+
+* sources are summed here, on the scrape path, rather than on the hot path.
+
 *
 
 * @return Plaintext body including HELP/TYPE lines and current values.
@@ -142,37 +202,165 @@ void MetricsHttpServer::stop() {
 
 std::string MetricsHttpServer::render() {
 
+    Stats snap;
+
+    collect_(snap);
+
     std::ostringstream oss;
 
     oss << "# HELP udp_packets_received_total Total UDP packets received\n";
 
     oss << "# TYPE udp_packets_received_total counter\n";
 
-    oss << "udp_packets_received_total " << stats_.recv() << "\n";
+    oss << "udp_packets_received_total " << snap.recv() << "\n";
 
     oss << "# HELP udp_packets_sent_total Total UDP packets sent\n";
 
     oss << "# TYPE udp_packets_sent_total counter\n";
 
-    oss << "udp_packets_sent_total " << stats_.sent() << "\n";
+    oss << "udp_packets_sent_total " << snap.sent() << "\n";
 
     oss << "# HELP udp_unique_clients Unique client count\n";
 
     oss << "# TYPE udp_unique_clients gauge\n";
 
-    oss << "udp_unique_clients " << stats_.unique_clients() << "\n";
+    oss << "udp_unique_clients " << snap.unique_clients() << "\n";
 
     oss << "# HELP udp_rx_bytes_total Total received bytes\n";
 
     oss << "# TYPE udp_rx_bytes_total counter\n";
 
-    oss << "udp_rx_bytes_total " << stats_.rx_bytes() << "\n";
+    oss << "udp_rx_bytes_total " << snap.rx_bytes() << "\n";
 
     oss << "# HELP udp_tx_bytes_total Total sent bytes\n";
 
     oss << "# TYPE udp_tx_bytes_total counter\n";
 
-    oss << "udp_tx_bytes_total " << stats_.tx_bytes() << "\n";
+    oss << "udp_tx_bytes_total " << snap.tx_bytes() << "\n";
+
+    oss << "# HELP udp_tx_zerocopy_total Zero-copy sends completed without copying\n";
+
+    oss << "# TYPE udp_tx_zerocopy_total counter\n";
+
+    oss << "udp_tx_zerocopy_total " << snap.zc_sends() << "\n";
+
+    oss << "# HELP udp_tx_zerocopy_copied_total Zero-copy sends the kernel completed by copying\n";
+
+    oss << "# TYPE udp_tx_zerocopy_copied_total counter\n";
+
+    oss << "udp_tx_zerocopy_copied_total " << snap.zc_copied() << "\n";
+
+    oss << "# HELP udp_rx_loop_idle_total Receive loop iterations that found no datagrams\n";
+
+    oss << "# TYPE udp_rx_loop_idle_total counter\n";
+
+    oss << "udp_rx_loop_idle_total " << snap.loop_idle() << "\n";
+
+    oss << "# HELP udp_rx_loop_busy_total Receive loop iterations that received datagrams\n";
+
+    oss << "# TYPE udp_rx_loop_busy_total counter\n";
+
+    oss << "udp_rx_loop_busy_total " << snap.loop_busy() << "\n";
+
+    oss << "# HELP udp_packets_lost Skipped sequence numbers not received since (per worker; overstated if a flow spans workers)\n";
+
+    oss << "# TYPE udp_packets_lost gauge\n";
+
+    oss << "udp_packets_lost " << snap.seq_lost() << "\n";
+
+    oss << "# HELP udp_packets_reordered_total Packets that arrived after a higher sequence number (per worker; overstated if a flow spans workers)\n";
+
+    oss << "# TYPE udp_packets_reordered_total counter\n";
+
+    oss << "udp_packets_reordered_total " << snap.seq_reordered() << "\n";
+
+    oss << "# HELP udp_packets_duplicate_total Packets whose sequence number had already arrived\n";
+
+    oss << "# TYPE udp_packets_duplicate_total counter\n";
+
+    oss << "udp_packets_duplicate_total " << snap.seq_duplicate() << "\n";
+
+    oss << "# HELP udp_packets_invalid_total Packets too short for a header or with the wrong magic\n";
+
+    oss << "# TYPE udp_packets_invalid_total counter\n";
+
+    oss << "udp_packets_invalid_total " << snap.seq_invalid() << "\n";
+
+    auto summary = [&oss](const char* name, const char* help, uint64_t ns, uint64_t n) {
+
+        oss << "# HELP " << name << " " << help << "\n";
+
+        oss << "# TYPE " << name << " summary\n";
+
+        oss << name << "_sum " << static_cast<double>(ns) / 1e9 << "\n";
+
+        oss << name << "_count " << n << "\n";
+
+    };
+
+    summary("udp_rx_queue_delay_seconds", "Kernel RX timestamp to user-space pickup",
+
+            snap.queue_delay_ns(), snap.queue_delay_count());
+
+    summary("udp_rx_processing_delay_seconds", "User-space pickup to end of batch handling",
+
+            snap.proc_delay_ns(), snap.proc_delay_count());
+
+    auto histogram = [&oss, &snap](Latency k, const char* name, const char* help) {
+
+        static constexpr uint64_t kBoundsNs[] = {
+
+            1'000, 2'000, 5'000, 10'000, 20'000, 50'000, 100'000, 200'000, 500'000,
+
+            1'000'000, 2'000'000, 5'000'000, 10'000'000, 20'000'000, 50'000'000,
+
+            100'000'000, 200'000'000, 500'000'000, 1'000'000'000 };
+
+        const LatencyHistogram& h = snap.latency(k);
+
+        if (!h.count()) return;
+
+        oss << "# HELP " << name << " " << help << "\n";
+
+        oss << "# TYPE " << name << " histogram\n";
+
+        // One pass over the buckets; the +Inf bucket is their total so the
+
+        // series stays monotonic even if a record was half-applied at scrape.
+
+        uint64_t seen = 0;
+
+        size_t b = 0;
+
+        for (uint64_t le : kBoundsNs) {
+
+            for (const size_t last = LatencyHistogram::bucket_of(le); b <= last; ++b) seen += h.bucket_count(b);
+
+            oss << name << "_bucket{le=\"" << static_cast<double>(le) / 1e9 << "\"} " << seen << "\n";
+
+        }
+
+        for (; b < LatencyHistogram::kBuckets; ++b) seen += h.bucket_count(b);
+
+        oss << name << "_bucket{le=\"+Inf\"} " << seen << "\n";
+
+        oss << name << "_sum " << static_cast<double>(h.sum()) / 1e9 << "\n";
+
+        oss << name << "_count " << seen << "\n";
+
+    };
+
+    histogram(Latency::OneWay, "udp_one_way_latency_seconds", "Sender timestamp to kernel RX timestamp");
+
+    histogram(Latency::Rtt, "udp_rtt_seconds", "Intended send time to echo RX timestamp");
+
+    histogram(Latency::RttRaw, "udp_rtt_raw_seconds", "Sender timestamp to echo RX timestamp");
+
+    histogram(Latency::RecvCall, "udp_recv_call_seconds", "Duration of batch receive calls that returned data");
+
+    histogram(Latency::SendCall, "udp_send_call_seconds", "Duration of batch send calls");
+
+    if (extra_) oss << extra_();
 
     return oss.str();
 
@@ -192,6 +380,8 @@ std::string MetricsHttpServer::render() {
 
 *  - Binds to loopback (`127.0.0.1`) only; listens with a small backlog.
 
+*  - Pins itself to @ref cpu_ first when one is set.
+
 *
 
 * Loop semantics:
@@ -220,6 +410,12 @@ std::string MetricsHttpServer::render() {
 
 void MetricsHttpServer::run() {
 
+    if (cpu_ >= 0 && !pin_current_thread(cpu_)) {
+
+        std::cerr << "[metrics] could not pin to CPU " << cpu_ << ": " << std::strerror(errno) << "\n";
+
+    }
+
     int s = ::socket(AF_INET, SOCK_STREAM, 0);
 
     int one = 1;
@@ -0,0 +1,151 @@
+/**
+* @file
+* @brief Pacer schedule, hybrid sleep/spin wait and catch-up policies.
+*/
+#include "udp/pacer.hpp"
+#include "udp/common.hpp"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+ 
+namespace udp {
+ 
+/// \cond INTERNAL
+/// @brief Spin-loop hint: lets the sibling hyperthread run and saves power.
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+ 
+/// @brief Gap between on-time chunks that @ref Pacer::auto_chunk aims for.
+static constexpr double kChunkNs = 10'000.0;
+/// \endcond
+ 
+/// \copydoc udp::parse_catch_up
+bool parse_catch_up(const std::string& name, CatchUp& out) {
+    if (name == "burst") { out = CatchUp::Burst; return true; }
+    if (name == "cap") { out = CatchUp::Cap; return true; }
+    if (name == "skip") { out = CatchUp::Skip; return true; }
+    return false;
+}
+ 
+/// \copydoc udp::catch_up_name
+const char* catch_up_name(CatchUp c) {
+    switch (c) {
+    case CatchUp::Burst: return "burst";
+    case CatchUp::Cap:   return "cap";
+    case CatchUp::Skip:  return "skip";
+    }
+    return "?";
+}
+ 
+size_t Pacer::auto_chunk(double pps, size_t max_chunk) {
+    const size_t hi = std::max<size_t>(max_chunk, 1);
+    if (pps <= 0) return 1;
+    const double n = std::floor(pps * kChunkNs / 1e9);
+    return n < 1 ? 1 : std::min(hi, static_cast<size_t>(std::min(n, 1e9)));
+}
+ 
+void Pacer::sleep_until(uint64_t deadline, uint64_t spin_ns) {
+    uint64_t now = now_ns();
+    if (deadline > now + spin_ns) {
+        const uint64_t d = deadline - spin_ns - now;
+        timespec ts{ (time_t)(d / 1'000'000'000ull), (long)(d % 1'000'000'000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, nullptr);
+    }
+    while (now_ns() < deadline) cpu_relax();
+}
+ 
+Pacer::Pacer(const PacerConfig& cfg) : cfg_(cfg) {
+    rng_ = (now_ns() ^ reinterpret_cast<uintptr_t>(this)) | 1;
+    cfg_.max_chunk = std::max<size_t>(cfg_.max_chunk, 1);
+    backlog_ = cfg_.max_backlog ? cfg_.max_backlog : cfg_.max_chunk;
+    set_rate(cfg_.pps);
+}
+ 
+/**
+* @details @c PR_SET_TIMERSLACK applies to the calling thread only; the default
+* 50 µs slack would otherwise be added to every sleep and eat the spin window.
+*/
+void Pacer::start(uint64_t now_ns) {
+#if defined(__linux__)
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+    next_ = static_cast<double>(now_ns);
+}
+ 
+void Pacer::set_rate(double pps) {
+    const bool resume = interval_ <= 0 && pps > 0;
+    rate_.store(pps, std::memory_order_relaxed);
+    interval_ = pps > 0 ? 1e9 / pps : 0;
+    chunk_ = cfg_.chunk ? std::min(cfg_.chunk, cfg_.max_chunk) : auto_chunk(pps, cfg_.max_chunk);
+    if (resume && next_ > 0) next_ = static_cast<double>(now_ns());
+}
+ 
+double Pacer::gaps(size_t n) {
+    if (!cfg_.poisson) return static_cast<double>(n) * interval_;
+    double t = 0;
+    for (size_t i=0; i<n; ++i) {
+        rng_ ^= rng_ >> 12;
+        rng_ ^= rng_ << 25;
+        rng_ ^= rng_ >> 27;
+        // Uniform in (0, 1]: top 53 bits of the xorshift64* output, plus one.
+        const double u = static_cast<double>(((rng_ * 0x2545F4914F6CDD1Dull) >> 11) + 1) * 0x1.0p-53;
+        t -= std::log(u) * interval_;
+    }
+    return t;
+}
+ 
+void Pacer::skip(uint64_t n) {
+    next_ += static_cast<double>(n) * interval_;
+    skipped_.store(skipped_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+ 
+/**
+* @details @c owed counts the packets whose due time has passed at wake-up
+* (at least 1). The recorded error is the wake-up's lateness against the oldest
+* owed slot, before any slots are forgiven. Only when more than one chunk is
+* owed does the policy apply; a chunk that is merely a little late is sent
+* whole, and the next wake-up simply comes sooner.
+*/
+size_t Pacer::wait() {
+    if (interval_ <= 0) {
+        sleep_until(now_ns() + kIdleNs, 0);
+        return 0;
+    }
+    sleep_until(static_cast<uint64_t>(next_), cfg_.spin_ns);
+    const uint64_t now = now_ns();
+    const double late = static_cast<double>(now) - next_;
+    const double behind = late > 0 ? std::floor(late / interval_) : 0;
+    const uint64_t owed = 1 + static_cast<uint64_t>(std::min(behind, 1e15));
+    if (measure_) error_.record(late > 0 ? static_cast<uint64_t>(late) : 0);
+ 
+    size_t n = chunk_;
+    if (owed > chunk_) {
+        switch (cfg_.catch_up) {
+        case CatchUp::Burst:
+            n = static_cast<size_t>(std::min<uint64_t>(owed, cfg_.max_chunk));
+            break;
+        case CatchUp::Cap: {
+            const uint64_t keep = std::max<uint64_t>(backlog_, chunk_);
+            if (owed > keep) skip(owed - keep);
+            n = static_cast<size_t>(std::min<uint64_t>(std::min(owed, keep), cfg_.max_chunk));
+            break;
+        }
+        case CatchUp::Skip:
+            skip(owed - 1);
+            break;
+        }
+    }
+    due_ = static_cast<uint64_t>(next_);
+    next_ += gaps(n);
+    return n;
+}
+ 
+} // namespace udp
@@ -0,0 +1,165 @@
+/**
+* @file
+* @brief PacketPool mapping (hugetlb, THP or plain pages) and lock-free free list.
+*/
+#include "udp/packet_pool.hpp"
+#include "udp/affinity.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+ 
+namespace udp {
+ 
+/// \cond INTERNAL
+static size_t round_up(size_t n, size_t to) { return (n + to - 1) / to * to; }
+ 
+/// @brief Whether transparent hugepages are switched off system-wide.
+static bool thp_disabled() {
+    std::ifstream f("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string mode;
+    std::getline(f, mode);
+    return !f || mode.find("[never]") != std::string::npos;
+}
+/// \endcond
+ 
+/// \copydoc udp::backing_name
+const char* backing_name(PoolBacking b) {
+    switch (b) {
+    case PoolBacking::HugeTlb: return "hugetlb";
+    case PoolBacking::Thp:     return "thp";
+    case PoolBacking::Pages:   return "pages";
+    }
+    return "?";
+}
+ 
+/**
+* @details Tries the backings in order (see the file comment). Plain and hugetlb
+* mappings are prefaulted with @c MAP_POPULATE; the THP window is prefaulted by
+* zeroing it after the advice, so the receive path never takes a page fault.
+* With a NUMA @p node, @c MAP_POPULATE is dropped and every mapping is bound
+* first and zeroed afterwards, so the first touch already follows the policy.
+*/
+PacketPool::PacketPool(size_t slots, size_t slot_size, bool hugepages, int node) {
+    stride_ = round_up(slot_size ? slot_size : 1, 64);
+    const size_t want = (slots ? slots : 1) * stride_;
+    long sys_page = sysconf(_SC_PAGESIZE);
+    const size_t small = sys_page > 0 ? static_cast<size_t>(sys_page) : 4096;
+    int populate = 0;
+#if defined(MAP_POPULATE)
+    if (node < 0) populate = MAP_POPULATE;
+#endif
+ 
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (hugepages) {
+        const size_t len = round_up(want, kHugePage);
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        if (p != MAP_FAILED) {
+            map_ = base_ = static_cast<uint8_t*>(p);
+            map_len_ = bytes_ = len;
+            page_ = kHugePage;
+            backing_ = PoolBacking::HugeTlb;
+            if (node >= 0 && bind_memory_to_node(base_, len, node)) node_ = node;
+            if (!populate) std::memset(base_, 0, len);
+        } else if (!thp_disabled()) {
+            // Over-map by one hugepage and keep a 2 MiB-aligned window, so the
+            // kernel can back it with whole transparent hugepages.
+            const size_t over = len + kHugePage;
+            p = mmap(nullptr, over, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+                uint8_t* raw = static_cast<uint8_t*>(p);
+                uint8_t* aligned = reinterpret_cast<uint8_t*>(round_up(reinterpret_cast<uintptr_t>(raw), kHugePage));
+                const size_t head = static_cast<size_t>(aligned - raw);
+                if (head) munmap(raw, head);
+                if (over - head - len) munmap(aligned + len, over - head - len);
+                map_ = base_ = aligned;
+                map_len_ = bytes_ = len;
+                if (madvise(base_, len, MADV_HUGEPAGE) == 0) {
+                    page_ = kHugePage;
+                    backing_ = PoolBacking::Thp;
+                } else {
+                    page_ = small;
+                }
+                if (node >= 0 && bind_memory_to_node(base_, len, node)) node_ = node;
+                std::memset(base_, 0, len);
+            }
+        }
+    }
+#else
+    (void)hugepages;
+#endif
+    if (!map_) {
+        const size_t len = round_up(want, small);
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error(std::string("packet pool mmap failed: ") + std::strerror(errno));
+        map_ = base_ = static_cast<uint8_t*>(p);
+        map_len_ = bytes_ = len;
+        page_ = small;
+        backing_ = PoolBacking::Pages;
+        if (node >= 0 && bind_memory_to_node(base_, len, node)) node_ = node;
+        if (!populate) std::memset(base_, 0, len);
+    }
+ 
+    // Rounding slack becomes extra slots; indices must stay below kNil.
+    slots_ = bytes_ / stride_;
+    if (slots_ >= kNil) slots_ = kNil - 1;
+    next_.reset(new std::atomic<uint32_t>[slots_]);
+    refs_.reset(new std::atomic<uint32_t>[slots_]);
+    for (size_t i=0; i<slots_; ++i) {
+        next_[i].store(i + 1 < slots_ ? static_cast<uint32_t>(i + 1) : kNil, std::memory_order_relaxed);
+        refs_[i].store(0, std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_release); // tag 0, top = slot 0
+}
+ 
+PacketPool::~PacketPool() {
+    if (map_) munmap(map_, map_len_);
+}
+ 
+/**
+* @details Pops the free-list head. The next index is read before the
+* compare-and-swap; if another thread popped and pushed in between, the tag has
+* moved on and the swap retries with fresh values.
+*/
+PacketHandle PacketPool::alloc() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint32_t idx;
+    for (;;) {
+        idx = static_cast<uint32_t>(head);
+        if (idx == kNil) {
+            failures_.fetch_add(1, std::memory_order_relaxed);
+            return PacketHandle();
+        }
+        const uint64_t next = next_[idx].load(std::memory_order_relaxed);
+        const uint64_t desired = (((head >> 32) + 1) << 32) | next;
+        if (head_.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire)) break;
+    }
+    refs_[idx].store(1, std::memory_order_relaxed);
+    in_use_.fetch_add(1, std::memory_order_relaxed);
+    return PacketHandle(this, idx);
+}
+ 
+void PacketPool::release(uint32_t idx) {
+    in_use_.fetch_sub(1, std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+        next_[idx].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        desired = (((head >> 32) + 1) << 32) | idx;
+    } while (!head_.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed));
+}
+ 
+std::string PacketPool::to_string() const {
+    std::ostringstream oss;
+    oss << "slots=" << slots_ << " slot=" << stride_ << "B backing=" << backing_name(backing_)
+        << " pages=" << pages() << "x" << (page_ >= (1u << 20) ? page_ >> 20 : page_ >> 10)
+        << (page_ >= (1u << 20) ? "MiB" : "KiB");
+    if (node_ >= 0) oss << " node=" << node_;
+    return oss.str();
+}
+ 
+} // namespace udp
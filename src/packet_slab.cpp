@@ -0,0 +1,53 @@
+/**
+* @file
+* @brief PacketSlab allocation: one cache-line-aligned block, or slots borrowed from a PacketPool.
+*/
+#include "udp/packet_slab.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+ 
+namespace udp {
+ 
+/**
+* @brief Allocate the slot block and point each view at its slot.
+*
+* @details Uses @c std::aligned_alloc so the block starts on a cache line; the
+* total size is a multiple of the stride and therefore of the alignment, as
+* required by @c aligned_alloc. Memory is zero-filled once here so that unused
+* payload bytes are deterministic without per-batch clearing.
+*/
+PacketSlab::PacketSlab(size_t slots, size_t slot_size)
+    : base_(nullptr), slots_(slots ? slots : 1),
+      stride_((slot_size + kCacheLine - 1) / kCacheLine * kCacheLine), size_(0),
+      views_(slots_) {
+    if (stride_ == 0) stride_ = kCacheLine;
+    base_ = static_cast<uint8_t*>(std::aligned_alloc(kCacheLine, slots_ * stride_));
+    if (!base_) throw std::bad_alloc();
+    std::memset(base_, 0, slots_ * stride_);
+    for (size_t i = 0; i < slots_; ++i) slot_ptr_.push_back(base_ + i * stride_);
+    reset_views();
+}
+ 
+/**
+* @details Takes @p slots handles in one go; slots come from the pool's free
+* list, so a fresh pool yields adjacent slots. Pool memory is not cleared here
+* (pool mappings start zeroed; recycled slots keep their previous bytes).
+*/
+PacketSlab::PacketSlab(PacketPool& pool, size_t slots)
+    : base_(nullptr), slots_(slots ? slots : 1), stride_(pool.slot_size()), size_(0),
+      views_(slots_) {
+    for (size_t i = 0; i < slots_; ++i) {
+        handles_.push_back(pool.alloc());
+        if (!handles_.back()) throw std::bad_alloc();
+        slot_ptr_.push_back(handles_.back().data());
+    }
+    reset_views();
+}
+ 
+/// @brief Free the slot block.
+PacketSlab::~PacketSlab() {
+    std::free(base_);
+}
+ 
+} // namespace udp
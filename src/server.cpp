@@ -20,352 +20,1342 @@
 
 * Source address handling:
 
-*  - On Linux with a real socket fd, the server uses `recvmmsg` and reads per-message
+*  - The loop receives into one @ref udp::PacketSlab through
 
-*    `msg_name` to determine the sender address without extra syscalls.
+*    `ISocket::recv_batch(PacketSlab&)`; every @ref udp::PacketView carries the
 
-*  - If a raw fd is not available (e.g., @ref udp::MockSocket returns -1) the server
+*    sender address (on Linux straight from `recvmmsg`'s `msg_name`), so admission
 
-*    falls back to `ISocket::recv_batch()` which does not expose source addresses;
+*    works identically for @ref udp::UdpSocket and @ref udp::MockSocket.
 
-*    in that mode the admission limit cannot be enforced (documented limitation).
+*  - With @ref udp::ServerConfig::gro, the socket coalesces same-flow datagrams
+
+*    into single kernel reads and splits them back before returning, so admission
+
+*    and stats below still see one view per logical datagram.
+
+*
+
+* Echo:
+
+*  - Admitted views are compacted to the front of the slab (descriptors only, no
+
+*    payload copies) and sent back with one `send_batch`, using each view's source
+
+*    address as its destination (`sendmmsg` with per-message destinations on Linux).
+
+*  - With @ref udp::ServerConfig::gso, the echo views are first grouped by peer
+
+*    (stable, so each peer's packets keep their order) so that the socket can
+
+*    merge every peer's replies into `UDP_SEGMENT` super-buffers.
+
+*  - With @ref udp::ServerConfig::zerocopy, echoes are sent with `MSG_ZEROCOPY`
+
+*    straight from the receive slab. The loop then rotates through
+
+*    @ref udp::kZeroCopySlabs receive slabs and reuses one only after every echo
+
+*    sent from it has been released by the kernel.
+
+*
+
+* Busy polling (@ref udp::ServerConfig::busy_poll):
+
+*  - The requested options are applied and read back once at construction; the
+
+*    effective values are logged and available through @ref udp::UdpServer::busy_poll.
+
+*  - The kernel busy-polls only inside a receive that would otherwise wait, so with
+
+*    busy polling active a `spin` wait strategy is switched to `block`.
+
+*
+
+* Workers:
+
+*  - Each socket gets a @ref udp::UdpServer::Worker with its own thread, wait
+
+*    strategy, admission shard and stats shard; the loop below only touches its own
+
+*    worker. Several sockets share one `SO_REUSEPORT` group, so the kernel keeps
+
+*    every flow on one worker.
+
+*  - Merged views (@ref udp::UdpServer::stats, `/metrics`, the verbose line printed
+
+*    by the first worker) are assembled on read.
+
+*
+
+* Pipeline mode (@ref udp::ServerConfig::pipeline):
+
+*  - @ref udp::UdpServer::rx_loop receives into pooled slabs and queues them with
+
+*    their receive time; @ref udp::UdpServer::process_loop runs the same batch
+
+*    processing as the inline loop. Queueing delay therefore still ends when the
+
+*    batch left the socket, and the time spent in the ring counts as processing.
+
+*
+
+* Idle behaviour:
+
+*  - Every receive result goes through the @ref udp::WaitStrategy selected by
+
+*    @ref udp::ServerConfig::wait (spin, spin-yield, spin-epoll or blocking
+
+*    receive). Its idle/busy iteration counts are folded into the stats once per
+
+*    second and when the loop exits.
+
+*
+
+* Delay accounting (@ref udp::ServerConfig::rx_timestamps):
+
+*  - Each view's kernel RX timestamp splits the time a datagram spent in the
+
+*    socket queue (RX timestamp to `recv_batch` return) from the time user space
+
+*    spent on its batch (`recv_batch` return to end of echo).
+
+*  - For datagrams carrying a valid @ref udp::PacketHeader, the RX timestamp
+
+*    minus `send_ts_ns` is the one-way latency. It is only meaningful when
+
+*    sender and server share a clock (same host).
+
+*  - One-way latencies, and the duration of every `recv_batch` that returned
+
+*    data and every echo `send_batch`, go into the worker's
+
+*    @ref udp::Latency histograms. With the blocking wait strategy a receive
+
+*    call includes the time it slept.
+
+*/
+ 
+#include "udp/server.hpp"
+
+#include "udp/affinity.hpp"
+
+#include <iostream>
+
+#include <cstring>
+
+#include <arpa/inet.h>
+
+#include <sys/socket.h>
+
+#include <sys/types.h>
+
+#include <cerrno>
+
+#include <algorithm>
+
+#include <stdexcept>
+
+#include <sstream>
+
+#include <new>
+ 
+namespace udp {
+ 
+/// \cond INTERNAL
+
+/**
+
+* @brief Stable in-place grouping of views `[0, n)` by destination (address, port).
+
+*
+
+* @details Insertion sort: allocation-free, stable, and cheap for batch-sized
+
+* inputs that are usually already grouped (one peer's burst arrives together).
+
+*/
+
+static void group_by_peer(PacketSlab& slab, size_t n) {
+
+    auto key = [](const PacketView& v) {
+
+        return (static_cast<uint64_t>(v.addr.sin_addr.s_addr) << 16) | v.addr.sin_port;
+
+    };
+
+    for (size_t i=1; i<n; ++i) {
+
+        PacketView v = slab[i];
+
+        const uint64_t k = key(v);
+
+        size_t j = i;
+
+        for (; j>0 && key(slab[j-1]) > k; --j) slab[j] = slab[j-1];
+
+        if (j != i) slab[j] = v;
+
+    }
+
+}
+
+/// \endcond
+ 
+/// \cond INTERNAL
+
+static std::vector<std::unique_ptr<ISocket>> one_socket(std::unique_ptr<ISocket> sock) {
+
+    std::vector<std::unique_ptr<ISocket>> v;
+
+    v.push_back(std::move(sock));
+
+    return v;
+
+}
+ 
+/// @brief Locally bound port of @p fd (0 if unknown, e.g. for mock sockets).
+
+static uint16_t bound_port(int fd) {
+
+    sockaddr_in a{};
+
+    socklen_t len = sizeof(a);
+
+    if (fd < 0 || getsockname(fd, reinterpret_cast<sockaddr*>(&a), &len) != 0) return 0;
+
+    return ntohs(a.sin_port);
+
+}
+
+/// \endcond
+ 
+UdpServer::UdpServer(std::unique_ptr<ISocket> sock, ServerConfig cfg)
+
+: UdpServer(one_socket(std::move(sock)), cfg) {}
+ 
+/**
+
+* @details Binds every socket to `cfg.port`, with `SO_REUSEPORT` forced on when
+
+* there is more than one so they form a single group. For port 0 the first bind
+
+* picks the port and the others join it. Option fallbacks are logged once (for
+
+* the first worker).
+
+*
+
+* Placement is decided before anything is allocated: CPUs first (restricted to
+
+* the NIC's node when known), then each worker's node, then one packet pool per
+
+* node sized for the workers on it.
+
+*/
+
+UdpServer::UdpServer(std::vector<std::unique_ptr<ISocket>> socks, ServerConfig cfg)
+
+: cfg_(cfg) {
+
+    if (socks.empty()) throw std::invalid_argument("UdpServer needs at least one socket");
+
+    cfg_.workers = static_cast<int>(socks.size());
+
+    const bool reuse = cfg_.reuseport || socks.size() > 1;
+
+    const unsigned n = static_cast<unsigned>(socks.size());
+
+    const bool steer = n > 1 && cfg_.steering != Steering::Kernel;
+
+    if (steer && cfg_.steering == Steering::Cpu) {
+
+        std::cerr << "[server] warning: cpu steering can split a flow across workers; "
+                     "per-client lost/reordered counts will be overstated\n";
+
+    }
+
+    nic_node_ = cfg_.nic.empty() ? -1 : nic_numa_node(cfg_.nic);
+
+    const bool explicit_cpus = !cfg_.cpu_list.empty();
+
+    std::vector<int> cpus = explicit_cpus ? cfg_.cpu_list
+
+                          : n > 1 || nic_node_ >= 0 ? allowed_cpus() : std::vector<int>{};
+
+    if (nic_node_ >= 0 && !explicit_cpus) {
+
+        const std::vector<int> local = node_cpus(nic_node_);
+
+        std::vector<int> keep;
+
+        for (int c : cpus)
+
+            if (std::find(local.begin(), local.end(), c) != local.end()) keep.push_back(c);
+
+        if (keep.empty()) {
+
+            std::cerr << "[server] no allowed CPU on " << cfg_.nic << "'s NUMA node " << nic_node_ << ", using all allowed CPUs\n";
+
+        } else {
+
+            cpus = keep;
+
+        }
+
+    } else if (!cfg_.nic.empty() && cfg_.verbose) {
+
+        std::cerr << "[server] NUMA node of " << cfg_.nic << " unknown, placing workers by CPU only\n";
+
+    }
+
+    // An explicit list is consumed in thread order: RX, then processing when pipelined.
+
+    const size_t per_worker_cpus = explicit_cpus && cfg_.pipeline ? 2 : 1;
+
+    std::vector<int> cpu_of(n, -1), proc_of(n, -1), node_of(n, -1);
+
+    for (unsigned i=0; i<n; ++i) {
+
+        if (!cpus.empty()) {
+
+            cpu_of[i] = cpus[i * per_worker_cpus % cpus.size()];
+
+            if (per_worker_cpus == 2) proc_of[i] = cpus[(i * 2 + 1) % cpus.size()];
+
+            if (steer && cfg_.steering == Steering::Cpu) {
+
+                // Socket i receives what softirqs on CPUs c with c % n == i delivered.
+
+                auto it = std::find_if(cpus.begin(), cpus.end(), [&](int c) { return static_cast<unsigned>(c) % n == i; });
+
+                if (it != cpus.end()) cpu_of[i] = *it;
+
+            }
+
+        }
+
+        node_of[i] = cpu_of[i] >= 0 ? cpu_numa_node(cpu_of[i]) : nic_node_;
+
+    }
+ 
+    // Worst case per worker: the pipeline's pool plus spare, or the zero-copy rotation.
+
+    const size_t batch = static_cast<size_t>(std::max(cfg_.batch, 1));
+
+    size_t per_worker = (cfg_.zerocopy ? kZeroCopySlabs : 1) * batch;
+
+    if (cfg_.pipeline) per_worker = std::max(per_worker, (std::max<size_t>(cfg_.ring_depth, 1) + 1) * batch);
+
+    std::vector<int> pool_nodes; // node of pools_[k], in order of first use
+
+    std::vector<size_t> pool_of(n);
+
+    for (unsigned i=0; i<n; ++i) {
+
+        auto it = std::find(pool_nodes.begin(), pool_nodes.end(), node_of[i]);
+
+        pool_of[i] = static_cast<size_t>(it - pool_nodes.begin());
+
+        if (it == pool_nodes.end()) pool_nodes.push_back(node_of[i]);
+
+    }
+
+    for (size_t k=0; k<pool_nodes.size(); ++k) {
+
+        const size_t users = static_cast<size_t>(std::count(pool_of.begin(), pool_of.end(), k));
+
+        pools_.push_back(std::make_unique<PacketPool>(per_worker * users, 2048, cfg_.hugepages, pool_nodes[k]));
+
+        if (cfg_.verbose) std::cerr << "[server] packet pool " << k << " " << pools_.back()->to_string() << "\n";
+
+    }
+ 
+    uint16_t port = cfg_.port;
+
+    for (unsigned i=0; i<n; ++i) {
+
+        WorkerPtr w = make_worker(node_of[i]);
+
+        w->sock = std::move(socks[i]);
+
+        w->cpu = cpu_of[i];
+
+        w->proc_cpu = proc_of[i];
+
+        w->node = node_of[i];
+
+        w->pool = pools_[pool_of[i]].get();
+
+        if (steer && !w->sock->set_steering(cfg_.steering, n) && i == 0) {
+
+            std::cerr << "[server] reuseport steering unsupported by this socket, using the kernel hash\n";
+
+        }
+
+        w->sock->bind(port, reuse);
+
+        if (port == 0) port = bound_port(w->sock->fd());
+
+        setup_worker(*w, i == 0);
+
+        if (cfg_.verbose) {
+
+            std::cerr << "[server] worker " << i << " cpu " << w->cpu << " node " << w->node;
+
+            if (w->pipe && w->proc_cpu >= 0) std::cerr << " processing cpu " << w->proc_cpu;
+
+            if (!cfg_.nic.empty()) std::cerr << " (" << cfg_.nic << " node " << nic_node_ << ")";
+
+            std::cerr << "\n";
+
+        }
+
+        workers_.push_back(std::move(w));
+
+    }
+
+    cfg_.port = port;
+
+    if (cfg_.metrics_port) {
+
+        metrics_ = std::make_unique<MetricsHttpServer>(
+
+            [this](Stats& out) { for (const auto& w : workers_) out.merge_from(w->stats); },
+
+            cfg_.metrics_port,
+
+            [this] { return render_worker_metrics() + render_pool_metrics() + render_placement_metrics(); });
+
+        metrics_->set_cpu(cfg_.metrics_cpu);
+
+    }
+
+}
+ 
+/**
+
+* @details The worker is built in page-granular memory bound to @p node, so its
+
+* stats shard and the other hot fields sit on the node whose CPU updates them.
+
+* Containers inside it (admission set, slab lists) allocate from the heap, mostly
+
+* on first use by the pinned worker thread.
+
+*/
+
+UdpServer::WorkerPtr UdpServer::make_worker(int node) {
+
+    void* mem = alloc_on_node(sizeof(Worker), node);
+
+    if (!mem) throw std::bad_alloc();
+
+    return WorkerPtr(new (mem) Worker());
+
+}
+ 
+void UdpServer::WorkerDelete::operator()(Worker* w) const {
+
+    w->~Worker();
+
+    free_on_node(w, sizeof(Worker));
+
+}
+ 
+void UdpServer::setup_worker(Worker& w, bool log) {
+
+    ISocket& sock = *w.sock;
+
+    sock.set_rcvbuf(1<<20);
+
+    sock.set_sndbuf(1<<20);
+
+    if (cfg_.gso && !sock.set_gso(true) && log) {
+
+        std::cerr << "[server] UDP GSO unavailable, echo uses plain batch sends\n";
+
+    }
+
+    if (cfg_.pipeline) {
+
+        if (sock.split_io()) {
+
+            w.pipe = std::make_unique<Pipeline>(cfg_.ring_depth, *w.pool, cfg_.batch);
+
+        } else if (log) {
+
+            std::cerr << "[server] socket cannot receive and send from different threads, pipeline disabled\n";
+
+        }
+
+    }
+
+    if (cfg_.gro) {
+
+        // Pipelined views must stay valid after the next receive; GRO views do not.
+
+        if (w.pipe) {
+
+            if (log) std::cerr << "[server] GRO is not combined with pipeline mode, using plain batch receives\n";
+
+        } else if (!sock.set_gro(true) && log) {
+
+            std::cerr << "[server] UDP GRO unavailable, using plain batch receives\n";
+
+        }
+
+    }
+
+    if (cfg_.zerocopy) {
+
+        // GRO views point into socket-owned buffers that the next read overwrites,
+
+        // so a zero-copy echo from them would not be stable.
+
+        if (sock.gro()) {
+
+            if (log) std::cerr << "[server] MSG_ZEROCOPY is not combined with GRO, using copying sends\n";
+
+        } else if (w.pipe) {
+
+            if (log) std::cerr << "[server] MSG_ZEROCOPY is not combined with pipeline mode, using copying sends\n";
+
+        } else if (!sock.set_zerocopy(true) && log) {
+
+            std::cerr << "[server] MSG_ZEROCOPY unavailable, using copying sends\n";
+
+        }
+
+    }
+
+    if (cfg_.rx_timestamps && !sock.set_rx_timestamps(true) && log) {
+
+        std::cerr << "[server] kernel RX timestamps unavailable, delay stats disabled\n";
+
+    }
+
+    WaitConfig wait = cfg_.wait;
+
+    if (cfg_.busy_poll.enabled()) {
+
+        w.busy = sock.set_busy_poll(cfg_.busy_poll);
+
+        if (log) {
+
+            std::cerr << "[server] busy poll requested " << cfg_.busy_poll.to_string()
+                      << ", effective " << w.busy.to_string() << "\n";
+
+        }
+
+        if (w.busy.enabled() && wait.kind == WaitKind::Spin) {
+
+            // A non-blocking receive polls the device queue at most once.
+
+            wait.kind = WaitKind::Block;
+
+        }
+
+    }
+
+    w.wait = std::make_unique<WaitStrategy>(sock, wait);
+
+    if (!w.pipe) {
+
+        const size_t nslabs = sock.zerocopy() ? kZeroCopySlabs : 1;
+
+        for (size_t i=0; i<nslabs; ++i) w.slabs.push_back(std::make_unique<PacketSlab>(*w.pool, cfg_.batch));
+
+    }
+
+}
+ 
+UdpServer::Pipeline::Pipeline(size_t depth, PacketPool& pool, int batch)
+
+: full(std::max<size_t>(depth, 1)), empty(std::max<size_t>(depth, 1)) {
+
+    depth = std::max<size_t>(depth, 1);
+
+    std::vector<PacketSlab*> ptrs;
+
+    for (size_t i=0; i<=depth; ++i) {
+
+        slabs.push_back(std::make_unique<PacketSlab>(pool, batch));
+
+        ptrs.push_back(slabs.back().get());
+
+    }
+
+    spare = ptrs.back();
+
+    empty.push_n(ptrs.data(), depth);
+
+}
+ 
+UdpServer::~UdpServer() {
+
+    stop();
+
+}
+ 
+void UdpServer::start() {
+
+    if (metrics_) metrics_->start();
+
+    running_ = true;
+
+    for (auto& w : workers_) {
+
+        if (w->pipe) {
+
+            w->pipe->rx_done = false;
+
+            w->pipe->rx = std::thread(&UdpServer::rx_loop, this, std::ref(*w));
+
+            w->th = std::thread(&UdpServer::process_loop, this, std::ref(*w));
+
+        } else {
+
+            w->th = std::thread(&UdpServer::run_loop, this, std::ref(*w));
+
+        }
+
+    }
+
+}
+ 
+void UdpServer::stop() {
+
+    running_ = false;
+
+    for (auto& w : workers_) {
+
+        if (w->pipe && w->pipe->rx.joinable()) w->pipe->rx.join();
+
+        if (w->th.joinable()) w->th.join();
+
+    }
+
+    if (metrics_) metrics_->stop();
+
+}
+ 
+double UdpServer::last_rate_pps() const {
+
+    double sum = 0.0;
+
+    for (const auto& w : workers_) sum += w->rate_pps.load(std::memory_order_relaxed);
+
+    return sum;
+
+}
+ 
+size_t UdpServer::ring_occupancy(size_t i) const {
+
+    const Worker& w = *workers_.at(i);
+
+    return w.pipe ? w.pipe->full.size() : 0;
+
+}
+ 
+uint64_t UdpServer::ring_drops(size_t i) const {
+
+    const Worker& w = *workers_.at(i);
+
+    return w.pipe ? w.pipe->drops.load(std::memory_order_relaxed) : 0;
+
+}
+ 
+double UdpServer::imbalance_ratio() const {
+
+    double sum = 0.0, peak = 0.0;
+
+    for (const auto& w : workers_) {
+
+        const double r = w->rate_pps.load(std::memory_order_relaxed);
+
+        sum += r;
+
+        peak = std::max(peak, r);
+
+    }
+
+    if (sum <= 0.0) return 1.0;
+
+    return peak / (sum / static_cast<double>(workers_.size()));
+
+}
+ 
+/**
+
+* @details Exports, labelled by worker index:
+
+*  - `udp_worker_packets_received_total` (counter)
+
+*  - `udp_worker_rate_pps` (gauge, last one-second window)
 
 *
 
-* Echo:
+* plus the unlabelled `udp_worker_imbalance_ratio` gauge (@ref imbalance_ratio).
 
-*  - In the Linux/`recvmmsg` path, echo uses `sendmmsg` with per-message destinations.
+* Pipelined workers also get `udp_worker_ring_occupancy` (gauge, queued batches)
 
-*  - In the fallback path (no addresses), echo behavior remains best-effort or disabled.
+* and `udp_worker_ring_drops_total` (counter, datagrams dropped on a full ring).
 
 */
- 
-#include "udp/server.hpp"
 
-#include <iostream>
+std::string UdpServer::render_worker_metrics() const {
 
-#include <cstring>
+    std::ostringstream oss;
 
-#include <arpa/inet.h>
+    oss << "# HELP udp_worker_packets_received_total Packets received per worker\n";
 
-#include <sys/socket.h>
+    oss << "# TYPE udp_worker_packets_received_total counter\n";
 
-#include <sys/types.h>
+    for (size_t i=0; i<workers_.size(); ++i)
 
-#include <cerrno>
+        oss << "udp_worker_packets_received_total{worker=\"" << i << "\"} " << workers_[i]->stats.recv() << "\n";
 
-#include <algorithm>
+    oss << "# HELP udp_worker_rate_pps Per-worker receive rate over the last second\n";
+
+    oss << "# TYPE udp_worker_rate_pps gauge\n";
+
+    for (size_t i=0; i<workers_.size(); ++i)
+
+        oss << "udp_worker_rate_pps{worker=\"" << i << "\"} " << worker_rate_pps(i) << "\n";
+
+    oss << "# HELP udp_worker_imbalance_ratio Busiest worker rate over mean worker rate (1 = even)\n";
+
+    oss << "# TYPE udp_worker_imbalance_ratio gauge\n";
+
+    oss << "udp_worker_imbalance_ratio " << imbalance_ratio() << "\n";
+
+    if (std::none_of(workers_.begin(), workers_.end(), [](const auto& w) { return w->pipe != nullptr; })) return oss.str();
+
+    oss << "# HELP udp_worker_ring_occupancy Receive batches queued between RX and processing threads\n";
+
+    oss << "# TYPE udp_worker_ring_occupancy gauge\n";
+
+    for (size_t i=0; i<workers_.size(); ++i)
+
+        if (pipelined(i)) oss << "udp_worker_ring_occupancy{worker=\"" << i << "\"} " << ring_occupancy(i) << "\n";
+
+    oss << "# HELP udp_worker_ring_drops_total Datagrams dropped by RX threads because the ring was full\n";
+
+    oss << "# TYPE udp_worker_ring_drops_total counter\n";
+
+    for (size_t i=0; i<workers_.size(); ++i)
+
+        if (pipelined(i)) oss << "udp_worker_ring_drops_total{worker=\"" << i << "\"} " << ring_drops(i) << "\n";
+
+    return oss.str();
+
+}
  
-namespace udp {
+/**
+
+* @details Exports, labelled by pool index, `udp_pool_slots`, `udp_pool_slots_in_use`,
+
+* `udp_pool_bytes`, `udp_pool_page_bytes`, `udp_pool_pages` (gauges; pages is the
+
+* number of TLB entries covering the pool) and `udp_pool_numa_node` (gauge, -1 if
+
+* unplaced), `udp_pool_alloc_failures_total` (counter) and
+
+* `udp_pool_backing{pool="...",backing="..."}` (always 1).
+
+*/
+
+std::string UdpServer::render_pool_metrics() const {
+
+    std::ostringstream oss;
+
+    auto family = [&](const char* name, const char* type, const char* help, auto value) {
+
+        oss << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+
+        for (size_t k=0; k<pools_.size(); ++k) oss << name << "{pool=\"" << k << "\"} " << value(*pools_[k]) << "\n";
+
+    };
+
+    family("udp_pool_slots", "gauge", "Packet buffers in the pool", [](const PacketPool& p) { return p.slots(); });
+
+    family("udp_pool_slots_in_use", "gauge", "Packet buffers currently handed out", [](const PacketPool& p) { return p.in_use(); });
+
+    family("udp_pool_bytes", "gauge", "Bytes mapped for the packet pool", [](const PacketPool& p) { return p.bytes(); });
+
+    family("udp_pool_page_bytes", "gauge", "Page size backing the packet pool", [](const PacketPool& p) { return p.page_size(); });
+
+    family("udp_pool_pages", "gauge", "Pages (TLB entries) covering the packet pool", [](const PacketPool& p) { return p.pages(); });
+
+    family("udp_pool_numa_node", "gauge", "NUMA node the packet pool is placed on (-1 = no policy)", [](const PacketPool& p) { return p.node(); });
+
+    family("udp_pool_alloc_failures_total", "counter", "Packet buffer allocations that found the pool empty",
+
+           [](const PacketPool& p) { return p.alloc_failures(); });
+
+    oss << "# HELP udp_pool_backing Memory backing the packet pool\n";
+
+    oss << "# TYPE udp_pool_backing gauge\n";
+
+    for (size_t k=0; k<pools_.size(); ++k)
+
+        oss << "udp_pool_backing{pool=\"" << k << "\",backing=\"" << backing_name(pools_[k]->backing()) << "\"} 1\n";
+
+    return oss.str();
+
+}
  
-UdpServer::UdpServer(std::unique_ptr<ISocket> sock, ServerConfig cfg)
+/**
+
+* @details Exports `udp_worker_cpu` and `udp_worker_numa_node` (gauges labelled by
 
-: sock_(std::move(sock)), cfg_(cfg) {
+* worker, -1 when unpinned/unknown) and `udp_nic_numa_node{nic="..."}` when
 
-    sock_->bind(cfg_.port, cfg_.reuseport);
+* @ref ServerConfig::nic is set.
 
-    sock_->set_rcvbuf(1<<20);
+*/
 
-    sock_->set_sndbuf(1<<20);
+std::string UdpServer::render_placement_metrics() const {
 
-    if (cfg_.metrics_port) {
+    std::ostringstream oss;
+
+    oss << "# HELP udp_worker_cpu CPU the worker is pinned to (-1 = unpinned)\n";
+
+    oss << "# TYPE udp_worker_cpu gauge\n";
 
-        metrics_ = std::make_unique<MetricsHttpServer>(stats_, cfg_.metrics_port);
+    for (size_t i=0; i<workers_.size(); ++i) oss << "udp_worker_cpu{worker=\"" << i << "\"} " << worker_cpu(i) << "\n";
+
+    oss << "# HELP udp_worker_numa_node NUMA node of the worker's CPU, stats and buffers (-1 = unknown)\n";
+
+    oss << "# TYPE udp_worker_numa_node gauge\n";
+
+    for (size_t i=0; i<workers_.size(); ++i) oss << "udp_worker_numa_node{worker=\"" << i << "\"} " << worker_node(i) << "\n";
+
+    if (!cfg_.nic.empty()) {
+
+        oss << "# HELP udp_nic_numa_node NUMA node of the receiving interface (-1 = unknown)\n";
+
+        oss << "# TYPE udp_nic_numa_node gauge\n";
+
+        oss << "udp_nic_numa_node{nic=\"" << cfg_.nic << "\"} " << nic_node_ << "\n";
 
     }
 
+    return oss.str();
+
 }
  
-UdpServer::~UdpServer() {
+Stats UdpServer::stats() const {
 
-    stop();
+    Stats out;
+
+    for (const auto& w : workers_) out.merge_from(w->stats);
+
+    return out;
 
 }
  
-void UdpServer::start() {
+/**
 
-    if (metrics_) metrics_->start();
+* @details Called when a worker sees @p key for the first time, and on every
 
-    running_ = true;
+* datagram from a client that was turned away. Admission is never revoked, so
 
-    th_ = std::thread(&UdpServer::run_loop, this);
+* once @ref admitted_total_ reaches the cap the set is frozen: the lookup then runs
+
+* without the lock and a flood of rejected clients stays off @ref admit_mu_.
+
+* The set is shared because a flow may reach more than one worker (e.g. under
+
+* @ref Steering::Cpu); it must take a single slot however many workers serve it.
+
+*/
+
+bool UdpServer::try_admit(const ClientKey& key) {
+
+    // Acquire pairs with the release below: the last insert is visible once full.
+
+    if (admitted_total_.load(std::memory_order_acquire) >= cfg_.max_clients) return admitted_.count(key) != 0;
+
+    std::lock_guard<std::mutex> lk(admit_mu_);
+
+    if (admitted_.count(key)) return true;
+
+    if (admitted_.size() >= cfg_.max_clients) return false;
+
+    admitted_.insert(key);
+
+    admitted_total_.store(admitted_.size(), std::memory_order_release);
+
+    return true;
 
 }
  
-void UdpServer::stop() {
-
-    if (th_.joinable()) {
+void UdpServer::place_thread(int cpu, const char* what) const {
 
-        running_ = false;
+    if (cpu >= 0 && !pin_current_thread(cpu)) {
 
-        th_.join();
+        std::cerr << "[server] could not pin " << what << " to CPU " << cpu << ": " << std::strerror(errno) << "\n";
 
     }
 
-    if (metrics_) metrics_->stop();
+    if (cfg_.rt_priority > 0 && !set_current_thread_fifo(cfg_.rt_priority)) {
+
+        std::cerr << "[server] could not give " << what << " SCHED_FIFO priority " << cfg_.rt_priority
+                  << ": " << std::strerror(errno) << "\n";
+
+    }
 
 }
  
-void UdpServer::run_loop() {
+void UdpServer::run_loop(Worker& w) {
 
-    std::vector<std::vector<uint8_t>> bufs(cfg_.batch, std::vector<uint8_t>(2048));
+    place_thread(w.cpu, "worker");
 
-    uint64_t last_recv_total = 0;
+    ISocket& sock = *w.sock;
 
-    auto last_ts = std::chrono::steady_clock::now();
- 
-    const int fd = sock_->fd();
- 
-#if defined(__linux__)
+    WaitStrategy& wait = *w.wait;
 
-    // Fast path: we can access the raw fd and gather source addresses via recvmmsg.
+    std::vector<std::unique_ptr<PacketSlab>>& slabs = w.slabs;
 
-    const bool can_use_recvmmsg = (fd >= 0);
+    const size_t nslabs = slabs.size();
 
-#else
+    std::vector<uint64_t> released_at(nslabs, 0); // tx_issued() after the slab's last echo
 
-    const bool can_use_recvmmsg = false;
+    size_t cur = 0;
 
-#endif
+    Window win;
  
     while (running_) {
 
-        ssize_t r = 0;
+        PacketSlab& slab = *slabs[cur];
+
+        if (nslabs > 1) reclaim_tx(w, released_at[cur]);
+
+        const uint64_t t0 = now_ns();
+
+        ssize_t r = sock.recv_batch(slab);
+
+        const uint64_t done = now_ns();
+
+        wait.after_recv(r);
+
+        if (r < 0) {
+
+            // Error: continue best-effort
+
+            continue;
+
+        }
+
+        if (r > 0) w.stats.record_latency(Latency::RecvCall, done - t0);
+
+        if (process_batch(w, slab, static_cast<size_t>(r), done)) {
+
+            released_at[cur] = sock.tx_issued();
+
+            cur = (cur + 1) % nslabs;
+
+        }
+
+        tick(w, win, true);
+
+    }
+
+    publish_wait(w, win);
+
+}
  
-        if (can_use_recvmmsg) {
+/**
+
+* @details Never blocks on the processing thread: with no empty slab available
+
+* the batch goes into the spare slab and is counted as dropped.
+
+*/
 
-#if defined(__linux__)
+void UdpServer::rx_loop(Worker& w) {
 
-            const size_t n = bufs.size();
+    place_thread(w.cpu, "RX thread");
 
-            std::vector<iovec> iov(n);
+    Pipeline& pipe = *w.pipe;
 
-            std::vector<mmsghdr> msgs(n);
+    ISocket& sock = *w.sock;
 
-            std::vector<sockaddr_in> addrs(n);
+    WaitStrategy& wait = *w.wait;
 
-            std::vector<char> ctrl(64 * n);
+    Window win;
  
-            for (size_t i=0;i<n;i++) {
+    while (running_) {
 
-                iov[i].iov_base = bufs[i].data();
+        // An empty receive keeps its slab in `held`: only the processing thread
 
-                iov[i].iov_len  = bufs[i].size();
+        // may push onto the empty ring.
 
-                std::memset(&msgs[i], 0, sizeof(mmsghdr));
+        if (!pipe.held) pipe.empty.pop(pipe.held);
 
-                msgs[i].msg_hdr.msg_iov    = &iov[i];
+        PacketSlab& slab = pipe.held ? *pipe.held : *pipe.spare;
 
-                msgs[i].msg_hdr.msg_iovlen = 1;
+        const uint64_t t0 = now_ns();
 
-                msgs[i].msg_hdr.msg_name   = &addrs[i];
+        ssize_t r = sock.recv_batch(slab);
 
-                msgs[i].msg_hdr.msg_namelen= sizeof(sockaddr_in);
+        const uint64_t done = now_ns();
 
-                msgs[i].msg_hdr.msg_control= ctrl.data() + i*64;
+        wait.after_recv(r);
 
-                msgs[i].msg_hdr.msg_controllen = 64;
+        if (r > 0) {
 
-            }
- 
-            r = ::recvmmsg(fd, msgs.data(), n, 0, nullptr);
+            w.stats.record_latency(Latency::RecvCall, done - t0);
 
-            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) r = 0;
+            slab.set_size(static_cast<size_t>(r));
 
-            if (r < 0) {
+            if (!pipe.held) {
 
-                // Error: continue best-effort
+                pipe.drops.fetch_add(static_cast<uint64_t>(r), std::memory_order_relaxed);
 
-                continue;
+            } else {
+
+                // The full ring holds every pooled slab, so this push cannot fail.
+
+                pipe.full.push(Batch{pipe.held, done});
+
+                pipe.held = nullptr;
 
             }
+
+        }
  
-            // Process received messages with admission control.
+        auto now = std::chrono::steady_clock::now();
+
+        if (now - win.last >= std::chrono::seconds(1)) {
+
+            publish_wait(w, win);
 
-            ssize_t echoed = 0;
+            win.last = now;
+
+        }
+
+    }
 
-            std::vector<mmsghdr> echo_msgs; echo_msgs.reserve(r);
+    publish_wait(w, win);
 
-            std::vector<iovec>   echo_iov;  echo_iov.reserve(r);
+    pipe.rx_done.store(true, std::memory_order_release);
 
-            std::vector<sockaddr_in> echo_addrs; echo_addrs.reserve(r);
+}
  
-            for (ssize_t i=0; i<r; ++i) {
+/**
+
+* @details Drains what the RX thread queued before it stopped, so every counted
+
+* receive is also processed.
 
-                // Build client key (host-order fields)
+*/
+
+void UdpServer::process_loop(Worker& w) {
 
-                ClientKey key {
+    place_thread(w.proc_cpu, "processing thread");
 
-                    static_cast<uint32_t>(ntohl(addrs[i].sin_addr.s_addr)),
+    Pipeline& pipe = *w.pipe;
 
-                    static_cast<uint16_t>(ntohs(addrs[i].sin_port))
+    Window win;
 
-                };
+    unsigned empty_polls = 0;
  
-                // Admission check: admit if seen, otherwise admit only if capacity remains.
+    for (;;) {
+
+        Batch b;
+
+        if (!pipe.full.pop(b)) {
 
-                bool allowed = false;
+            if (pipe.rx_done.load(std::memory_order_acquire) && pipe.full.size() == 0) break;
 
-                auto it = admitted_.find(key);
+            if (++empty_polls > cfg_.wait.spin) std::this_thread::yield();
 
-                if (it != admitted_.end()) {
+            tick(w, win, false);
 
-                    allowed = true;
+            continue;
 
-                } else if (admitted_.size() < cfg_.max_clients) {
+        }
 
-                    admitted_.insert(key);
+        empty_polls = 0;
 
-                    allowed = true;
+        process_batch(w, *b.slab, b.slab->size(), b.recv_ns);
 
-                } else {
+        pipe.empty.push(b.slab);
 
-                    // Over capacity: drop this message from a new client.
+        tick(w, win, false);
 
-                    allowed = false;
+    }
 
-                }
+}
  
-                if (!allowed) {
+bool UdpServer::process_batch(Worker& w, PacketSlab& slab, size_t r, uint64_t pickup) {
+
+    ISocket& sock = *w.sock;
 
-                    // Skip counters for dropped packets to make metrics reflect served traffic.
+    Stats& stats = w.stats;
 
-                    continue;
+    uint64_t queue_ns = 0, stamped = 0, served = 0, served_bytes = 0;
 
-                }
+    SeqCounts seq;
  
-                // Metrics (served traffic)
+    // Process received messages with admission control. Admitted views are
+
+    // compacted to the front of the slab so the echo can send them in one call.
+
+    size_t echoed = 0;
+
+    for (size_t i=0; i<r; ++i) {
+
+        const PacketView& v = slab[i];
 
-                stats_.note_client(key.addr, key.port);
+        // Build client key (host-order fields)
 
-                stats_.inc_recv(1);
+        ClientKey key {
 
-                stats_.add_rx_bytes(msgs[i].msg_len);
+            static_cast<uint32_t>(ntohl(v.addr.sin_addr.s_addr)),
+
+            static_cast<uint16_t>(ntohs(v.addr.sin_port))
+
+        };
  
-                if (cfg_.echo) {
+        // Admission check: admit if seen, otherwise admit only if capacity remains.
+
+        bool allowed = false;
+
+        auto it = w.admitted.find(key);
+
+        if (it != w.admitted.end()) {
+
+            allowed = true;
+
+        } else if (try_admit(key)) {
+
+            it = w.admitted.emplace(key, SeqWindow{}).first;
 
-                    // Prepare echo mmsghdr referencing the same buffer back to sender.
+            allowed = true;
 
-                    echo_iov.push_back({});
+        } else {
+
+            // Over capacity: drop this message from a new client.
+
+            allowed = false;
+
+        }
+ 
+        if (!allowed) {
 
-                    echo_iov.back().iov_base = bufs[i].data();
+            // Skip counters for dropped packets to make metrics reflect served traffic.
 
-                    echo_iov.back().iov_len  = msgs[i].msg_len;
+            continue;
+
+        }
  
-                    echo_addrs.push_back(addrs[i]);
+        // Metrics (served traffic)
+
+        stats.note_client(key.addr, key.port);
+
+        served++;
+
+        served_bytes += v.len;
  
-                    echo_msgs.push_back({});
+        PacketHeader hdr{};
+
+        bool valid = false;
+
+        if (v.len >= sizeof(hdr)) {
+
+            std::memcpy(&hdr, v.data, sizeof(hdr));
+
+            valid = hdr.magic == kMagic;
+
+        }
+
+        if (valid) {
+
+            it->second.observe(hdr.seq, seq);
+
+        } else {
+
+            seq.invalid++;
 
-                    echo_msgs.back().msg_hdr.msg_iov    = &echo_iov.back();
+        }
 
-                    echo_msgs.back().msg_hdr.msg_iovlen = 1;
+        if (v.rx_ts_ns) {
 
-                    echo_msgs.back().msg_hdr.msg_name   = &echo_addrs.back();
+            if (pickup > v.rx_ts_ns) queue_ns += pickup - v.rx_ts_ns;
 
-                    echo_msgs.back().msg_hdr.msg_namelen= sizeof(sockaddr_in);
+            stamped++;
 
-                    echoed++;
+            if (valid && hdr.send_ts_ns && hdr.send_ts_ns <= v.rx_ts_ns) {
 
-                }
+                stats.record_latency(Latency::OneWay, v.rx_ts_ns - hdr.send_ts_ns);
 
             }
+
+        }
  
-            if (cfg_.echo && echoed > 0) {
+        if (cfg_.echo) {
+
+            // Keep the view (same slot, same length, source address as destination).
 
-                int w = ::sendmmsg(fd, echo_msgs.data(), echoed, 0);
+            if (i != echoed) slab[echoed] = v;
 
-                if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            echoed++;
+
+        }
 
-                    w = 0;
+    }
+ 
+    bool sent = false;
 
-                }
+    if (cfg_.echo && echoed > 0) {
 
-                if (w > 0) {
+        if (sock.gso()) group_by_peer(slab, echoed);
 
-                    stats_.inc_sent(static_cast<uint64_t>(w));
+        slab.set_size(echoed);
 
-                    size_t total_bytes = 0;
+        const uint64_t t0 = now_ns();
 
-                    for (int i=0; i<w; ++i) {
+        ssize_t w = sock.send_batch(slab, nullptr);
 
-                        // We used one buffer per message; msg_len not set by sendmmsg,
+        stats.record_latency(Latency::SendCall, now_ns() - t0);
 
-                        // so approximate with io vector length we queued.
+        if (w > 0) {
 
-                        total_bytes += echo_msgs[i].msg_hdr.msg_iov[0].iov_len;
+            stats.inc_sent(static_cast<uint64_t>(w));
 
-                    }
+            size_t total_bytes = 0;
 
-                    stats_.add_tx_bytes(total_bytes);
+            for (ssize_t i=0; i<w; ++i) total_bytes += slab[i].len;
 
-                }
+            stats.add_tx_bytes(total_bytes);
 
-            }
+        }
 
-#endif // __linux__
+        sent = true;
+
+    }
  
-        } else {
+    // Counters are added once per batch (see Stats: single-writer shard).
 
-            // Fallback: no access to per-message source address (e.g., MockSocket).
+    if (served) {
 
-            // We cannot enforce admission here; process as before.
+        stats.inc_recv(served);
 
-            r = sock_->recv_batch(bufs);
+        stats.add_rx_bytes(served_bytes);
 
-            if (r < 0) continue;
+    }
 
-            if (r > 0) {
+    if (!seq.empty()) stats.add_seq(seq);
 
-                for (ssize_t i=0;i<r;i++) {
+    if (stamped) {
 
-                    stats_.inc_recv(1);
+        stats.add_queue_delay(queue_ns, stamped);
 
-                    stats_.add_rx_bytes(bufs[i].size());
+        stats.add_proc_delay((now_ns() - pickup) * stamped, stamped);
 
-                }
+    }
 
-                if (cfg_.echo) {
+    return sent;
 
-                    // Best-effort: original ISocket::send_batch cannot target per-message addrs.
+}
+ 
+void UdpServer::publish_wait(Worker& w, Window& win) {
 
-                    // Leave as no-op or future improvement if needed.
+    const WaitStrategy& wait = *w.wait;
 
-                    // (Keeping behavior consistent with previous fallback path.)
+    w.stats.add_loop_iters(wait.idle_iters() - win.idle_seen, wait.busy_iters() - win.busy_seen);
 
-                }
+    win.idle_seen = wait.idle_iters();
 
-            }
+    win.busy_seen = wait.busy_iters();
 
-        }
+}
  
-        // Once per second: compute and log PPS.
+void UdpServer::tick(Worker& w, Window& win, bool with_wait) {
 
-        auto now = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+
+    if (now - win.last < std::chrono::seconds(1)) return;
 
-        if (now - last_ts >= std::chrono::seconds(1)) {
+    uint64_t recv_total = w.stats.recv();
 
-            uint64_t recv_total = stats_.recv();
+    uint64_t delta = recv_total - win.recv;
 
-            uint64_t delta = recv_total - last_recv_total;
+    w.rate_pps.store(static_cast<double>(delta), std::memory_order_relaxed);
 
-            last_rate_pps_ = static_cast<double>(delta);
+    if (with_wait) publish_wait(w, win);
 
-            if (cfg_.verbose) {
+    if (cfg_.verbose && &w == workers_.front().get()) { // the first worker prints the merged line
 
-                std::cout << "[server] " << stats_.to_string()
-<< " rate=" << human_rate(last_rate_pps_)
-<< " admitted=" << admitted_.size()
+        Stats all = this->stats();
+
+        std::cout << "[server] " << all.to_string()
+<< " rate=" << human_rate(last_rate_pps())
+<< " admitted=" << admitted_total_.load(std::memory_order_relaxed)
 << " cap=" << cfg_.max_clients
-<< "\n";
+<< " workers=" << workers_.size()
+<< " imbalance=" << imbalance_ratio()
+<< " idle=" << all.loop_idle()
+<< " busy=" << all.loop_busy()
+<< " lost=" << all.seq_lost()
+<< " reordered=" << all.seq_reordered()
+<< " dup=" << all.seq_duplicate()
+<< " invalid=" << all.seq_invalid();
 
-            }
+        if (w.pipe) {
+
+            size_t queued = 0;
+
+            uint64_t dropped = 0;
 
-            last_recv_total = recv_total;
+            for (size_t i=0; i<workers_.size(); ++i) {
 
-            last_ts = now;
+                queued += ring_occupancy(i);
+
+                dropped += ring_drops(i);
+
+            }
+
+            std::cout << " ring=" << queued << " ring_drops=" << dropped;
 
         }
 
+        std::cout << "\n";
+
+    }
+
+    win.recv = recv_total;
+
+    win.last = now;
+
+}
+ 
+/**
+
+* @brief Wait (yielding) until the socket released send `token`, folding new
+
+* zero-copy completions into the stats as they are reaped.
+
+*/
+
+void UdpServer::reclaim_tx(Worker& w, uint64_t token) {
+
+    for (;;) {
+
+        TxCompletions c = w.sock->reap_tx();
+
+        w.stats.add_zc_completions(c.zerocopy - w.tx_seen.zerocopy, c.copied - w.tx_seen.copied);
+
+        w.tx_seen = c;
+
+        if (c.released >= token || !running_) return;
+
+        std::this_thread::yield();
+
     }
 
 }
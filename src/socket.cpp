@@ -16,12 +16,18 @@
 
 *    (`recvmmsg`/`sendmmsg`) when available, and falls back to classic
 
-*    `recvfrom`/`sendto` loops otherwise.
+*    `recvfrom`/`sendto` loops otherwise. Both the vector and the
+
+*    `udp::PacketSlab` batch flavors share the socket's persistent header rings.
 
 *  - `udp::MockSocket`: a simple in-memory test double that can be preloaded
 
 *    with datagrams and captures sent buffers for assertions.
 
+*  - `udp::create_socket`: backend selection (`UdpSocket` or `IoUringSocket`)
+
+*    with a fallback to `UdpSocket` when io_uring is unavailable.
+
 *
 
 * Concurrency notes:
@@ -38,6 +44,10 @@
  
 #include "udp/socket.hpp"
 
+#include "udp/io_uring_socket.hpp"
+
+#include <algorithm>
+
 #include <arpa/inet.h>
 
 #include <cstring>
@@ -49,6 +59,24 @@
 #include <sys/types.h>
 
 #include <fcntl.h>
+
+#include <netinet/udp.h>
+
+#include <sys/time.h>
+
+#include <time.h>
+
+#if defined(__linux__)
+
+#include <linux/errqueue.h>
+
+#include <linux/filter.h>
+
+#include <linux/net_tstamp.h>
+
+#endif
+
+#include <iostream>
  
 namespace udp {
  
@@ -68,209 +96,249 @@ void ISocket::set_sndbuf(int bytes) {
 
 }
  
-/// \cond INTERNAL
-
-/**
+/// \copydoc udp::ISocket::set_gso
 
-* @brief Create a non-blocking UDP socket (IPv4).
+bool ISocket::set_gso(bool enable) {
 
-*
+    (void)enable; // default: no GSO support
 
-* @details
+    return false;
 
-* - Uses `AF_INET`/`SOCK_DGRAM` with protocol 0.
+}
+ 
+/// \copydoc udp::ISocket::set_gro
 
-* - Sets `O_NONBLOCK` so that hot paths can poll and treat `EAGAIN`/`EWOULDBLOCK`
+bool ISocket::set_gro(bool enable) {
 
-*   as "no messages" (return 0) rather than blocking the thread.
+    (void)enable; // default: no GRO support
 
-*
+    return false;
 
-* @throws std::runtime_error if `socket()` fails.
+}
+ 
+/// \copydoc udp::ISocket::set_rx_timestamps
 
-*/
+bool ISocket::set_rx_timestamps(bool enable) {
 
-static int make_socket() {
+    (void)enable; // default: no kernel timestamps
 
-    int s = ::socket(AF_INET, SOCK_DGRAM, 0);
+    return false;
 
-    if (s < 0) throw std::runtime_error("socket() failed");
+}
+ 
+/// \copydoc udp::ISocket::set_steering
 
-    int flags = fcntl(s, F_GETFL, 0);
+bool ISocket::set_steering(Steering steering, unsigned group_size) {
 
-    fcntl(s, F_SETFL, flags | O_NONBLOCK);
+    (void)group_size; // default: kernel 4-tuple hash only
 
-    return s;
+    return steering == Steering::Kernel;
 
 }
-
-/// \endcond
  
-/**
+/// \copydoc udp::ISocket::set_busy_poll
 
-* @brief Construct a UDP socket and apply basic defaults.
+BusyPoll ISocket::set_busy_poll(const BusyPoll& want) {
 
-*
+    (void)want; // default: interrupt-driven receives only
 
-* @details
+    return BusyPoll{};
 
-* - Creates a non-blocking socket via `make_socket()`.
+}
+ 
+/// \copydoc udp::ISocket::set_recv_wait
 
-* - Enables `SO_REUSEADDR` to ease local restarts during tests/demos.
+bool ISocket::set_recv_wait(int timeout_ms) {
 
-* - Stores `batch_hint_` for internal pre-allocation strategies.
+    (void)timeout_ms; // default: receives never block
 
-*/
+    return false;
 
-UdpSocket::UdpSocket(int batch_hint)
+}
+ 
+/// \copydoc udp::ISocket::set_zerocopy
 
-    : sockfd_(make_socket()), batch_hint_(batch_hint), connected_(false) {
+bool ISocket::set_zerocopy(bool enable) {
 
-    int one = 1;
+    (void)enable; // default: sends always copy
 
-    setsockopt(sockfd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    return false;
 
 }
  
-/**
+/// \copydoc udp::ISocket::reap_tx
 
-* @brief Close the file descriptor if still open.
+TxCompletions ISocket::reap_tx() {
 
-*/
+    TxCompletions c;
 
-UdpSocket::~UdpSocket() {
+    c.released = tx_issued(); // copying sends are done when they return
 
-    if (sockfd_ >= 0) ::close(sockfd_);
+    return c;
 
 }
  
+/// \cond INTERNAL
+
 /**
 
-* \copydoc udp::ISocket::bind
+* @brief Create a non-blocking UDP socket (IPv4).
 
 *
 
 * @details
 
-* - Optionally enables `SO_REUSEPORT` when requested and supported.
+* - Uses `AF_INET`/`SOCK_DGRAM` with protocol 0.
 
-* - Binds to `INADDR_ANY` on the given port (host byte order converted via `htons`).
+* - Sets `O_NONBLOCK` so that hot paths can poll and treat `EAGAIN`/`EWOULDBLOCK`
 
-* - Throws `std::runtime_error` with `strerror(errno)` on failure.
+*   as "no messages" (return 0) rather than blocking the thread.
+
+*
+
+* @throws std::runtime_error if `socket()` fails.
 
 */
 
-void UdpSocket::bind(uint16_t port, bool reuseport) {
+static int make_socket() {
 
-    if (reuseport) {
+    int s = ::socket(AF_INET, SOCK_DGRAM, 0);
 
-#ifdef SO_REUSEPORT
+    if (s < 0) throw std::runtime_error("socket() failed");
 
-        int one = 1;
+    int flags = fcntl(s, F_GETFL, 0);
 
-        setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    fcntl(s, F_SETFL, flags | O_NONBLOCK);
 
-#endif
+    return s;
 
-    }
+}
+ 
+#if defined(__linux__)
 
-    sockaddr_in addr{};
+/**
 
-    addr.sin_family = AF_INET;
+* @brief Segment size of one received message: the `UDP_GRO` control value if
 
-    addr.sin_addr.s_addr = INADDR_ANY;
+* present, else the whole message (it was not coalesced).
 
-    addr.sin_port = htons(port);
+*/
 
-    if (::bind(sockfd_, (sockaddr*)&addr, sizeof(addr)) < 0)
+static uint32_t gro_segment(const msghdr& h, uint32_t msg_len) {
 
-        throw std::runtime_error("bind() failed: " + std::string(strerror(errno)));
+#ifdef UDP_GRO
+
+    for (cmsghdr* c = CMSG_FIRSTHDR(const_cast<msghdr*>(&h)); c; c = CMSG_NXTHDR(const_cast<msghdr*>(&h), c)) {
+
+        if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+
+            int seg = 0;
+
+            memcpy(&seg, CMSG_DATA(c), sizeof(seg));
+
+            if (seg > 0) return static_cast<uint32_t>(seg);
+
+        }
+
+    }
+
+#endif
+
+    return msg_len;
 
 }
  
 /**
 
-* \copydoc udp::ISocket::connect
+* @brief Kernel RX timestamp (CLOCK_REALTIME ns) of one received message, 0 if absent.
 
 *
 
-* @details
-
-* - Resolves the dotted IPv4 string with `inet_pton`.
+* @details `type` is `SCM_TIMESTAMPNS` (one `timespec`) or `SCM_TIMESTAMPING`
 
-* - Calls `::connect()` and sets `connected_ = true` on success.
+* (three `timespec`s, the first being the software stamp); both start with the
 
-* - Throws `std::runtime_error` with `strerror(errno)` on failure.
+* value we want.
 
 */
 
-void UdpSocket::connect(const std::string& ip, uint16_t port) {
+static uint64_t rx_timestamp(const msghdr& h, int type) {
 
-    memset(&peer_, 0, sizeof(peer_));
+    for (cmsghdr* c = CMSG_FIRSTHDR(const_cast<msghdr*>(&h)); c; c = CMSG_NXTHDR(const_cast<msghdr*>(&h), c)) {
 
-    peer_.sin_family = AF_INET;
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == type) {
 
-    inet_pton(AF_INET, ip.c_str(), &peer_.sin_addr);
+            timespec ts;
 
-    peer_.sin_port = htons(port);
+            memcpy(&ts, CMSG_DATA(c), sizeof(ts));
 
-    if (::connect(sockfd_, (sockaddr*)&peer_, sizeof(peer_)) < 0)
+            return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(ts.tv_nsec);
 
-        throw std::runtime_error("connect() failed: " + std::string(strerror(errno)));
+        }
 
-    connected_ = true;
+    }
+
+    return 0;
 
 }
  
-/**
+/// @brief `CLOCK_REALTIME - CLOCK_MONOTONIC` in ns, to move kernel stamps onto the `now_ns()` base.
 
-* \copydoc udp::ISocket::recv_batch
+static uint64_t realtime_offset_ns() {
 
-*
+    timespec rt, mono;
 
-* @details Linux fast-path:
+    clock_gettime(CLOCK_REALTIME, &rt);
 
-* - Prepares `mmsghdr`/`iovec` arrays for up to `bufs.size()` messages.
+    clock_gettime(CLOCK_MONOTONIC, &mono);
 
-* - Calls `recvmmsg()` once; on `EAGAIN`/`EWOULDBLOCK` returns 0 (no messages).
+    return (static_cast<uint64_t>(rt.tv_sec) - static_cast<uint64_t>(mono.tv_sec)) * 1'000'000'000ull
 
-* - On other errors returns -1; otherwise returns the number of messages received.
+         + static_cast<uint64_t>(rt.tv_nsec) - static_cast<uint64_t>(mono.tv_nsec);
 
-*
+}
 
-* Fallback:
+#endif
+ 
+/// @brief Same IPv4 address and port (the fields a UDP destination consists of).
 
-* - Performs a single `recvfrom` into `bufs[0]` and returns 1 on success,
+static inline bool same_peer(const sockaddr_in& a, const sockaddr_in& b) {
 
-*   0 on `EAGAIN`/`EWOULDBLOCK`, or -1 on error.
+    return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
 
-*
+}
 
-* @note Return value is a **message count**, not bytes.
+/// \endcond
+ 
+#if defined(__linux__)
 
-*/
+/**
 
-ssize_t UdpSocket::recv_batch(std::vector<std::vector<uint8_t>>& bufs) {
+* @brief Grow the ring to at least `n` messages and re-wire every header.
 
-#if defined(__linux__)
+*
 
-    // Use recvmmsg if available
+* @details Growing may move the underlying arrays, so all `msg_hdr` pointers are
 
-    const size_t n = bufs.size();
+* re-pointed at their slot's `iovec`, address and control storage afterwards.
 
-    std::vector<iovec> iov(n);
+* Calls with `n <= capacity()` are no-ops, which keeps the hot path allocation-free.
 
-    std::vector<mmsghdr> msgs(n);
+*/
 
-    std::vector<sockaddr_in> addrs(n);
+void UdpSocket::MsgRing::reserve(size_t n) {
 
-    std::vector<char> ctrl(64 * n); // ancillary control (unused), keeps API parity
- 
-    for (size_t i=0;i<n;i++) {
+    if (n <= msgs.size()) return;
+
+    iov.resize(n);
+
+    msgs.resize(n);
+
+    addrs.resize(n);
 
-        iov[i].iov_base = bufs[i].data();
+    ctrl.resize(kCtrlLen * n);
 
-        iov[i].iov_len  = bufs[i].size();
+    for (size_t i=0;i<n;i++) {
 
         memset(&msgs[i], 0, sizeof(mmsghdr));
 
@@ -282,35 +350,49 @@ ssize_t UdpSocket::recv_batch(std::vector<std::vector<uint8_t>>& bufs) {
 
         msgs[i].msg_hdr.msg_namelen= sizeof(sockaddr_in);
 
-        msgs[i].msg_hdr.msg_control= ctrl.data() + i*64;
+        msgs[i].msg_hdr.msg_control= ctrl.data() + i*kCtrlLen;
 
-        msgs[i].msg_hdr.msg_controllen = 64;
+        msgs[i].msg_hdr.msg_controllen = kCtrlLen;
 
     }
 
-    int r = recvmmsg(sockfd_, msgs.data(), n, 0, nullptr);
+}
 
-    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+#endif
+ 
+/**
 
-    if (r < 0) return -1;
+* @brief Construct a UDP socket and apply basic defaults.
 
-    return r;
+*
 
-#else
+* @details
 
-    // Fallback to single recvfrom
+* - Creates a non-blocking socket via `make_socket()`.
 
-    sockaddr_in addr{};
+* - Enables `SO_REUSEADDR` to ease local restarts during tests/demos.
 
-    socklen_t alen = sizeof(addr);
+* - Pre-sizes the RX/TX header rings for `batch_hint_` messages so the first
 
-    ssize_t r = recvfrom(sockfd_, bufs[0].data(), bufs[0].size(), 0, (sockaddr*)&addr, &alen);
+*   batch call already runs allocation-free.
 
-    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+*/
 
-    if (r < 0) return -1;
+UdpSocket::UdpSocket(int batch_hint)
 
-    return 1;
+    : sockfd_(make_socket()), batch_hint_(batch_hint), connected_(false), gso_(false), gro_(false), zc_(false), ts_mode_(0), rx_flags_(0) {
+
+    int one = 1;
+
+    setsockopt(sockfd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+#if defined(__linux__)
+
+    const size_t hint = batch_hint_ > 0 ? static_cast<size_t>(batch_hint_) : 1;
+
+    rx_ring_.reserve(hint);
+
+    tx_ring_.reserve(hint);
 
 #endif
 
@@ -318,127 +400,1455 @@ ssize_t UdpSocket::recv_batch(std::vector<std::vector<uint8_t>>& bufs) {
  
 /**
 
-* \copydoc udp::ISocket::send_batch
+* @brief Close the file descriptor if still open.
 
-*
+*/
 
-* @details Linux fast-path:
+UdpSocket::~UdpSocket() {
 
-* - Prepares `mmsghdr`/`iovec` arrays for up to `bufs.size()` messages.
+    if (sockfd_ >= 0) ::close(sockfd_);
 
-* - If the socket is not `connected_`, per-call `addr` is attached to each msg.
+}
+ 
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
 
-* - Calls `sendmmsg()` once; on `EAGAIN`/`EWOULDBLOCK` returns 0, on other errors -1,
+/// \cond INTERNAL
 
-*   else the number of messages actually sent.
+/**
+
+* @brief Classic-BPF reuseport program for `steer` over `groups` sockets.
 
 *
 
-* Fallback:
+* @details Reuseport programs see the skb with the UDP header already pulled, so
 
-* - Loops `send()` (connected) or `sendto()` (unconnected) over `bufs`.
+* header fields are read relative to the network header (`SKF_NET_OFF`); the
 
-* - Returns the **count** of successful sends.
+* source port sits behind the variable-length IPv4 header (`X = 4 * IHL`). The
 
-*
+* selected field is mixed with a multiplicative (golden ratio) hash so that
 
-* @note Return value is a **message count**, not bytes.
+* neighbouring addresses/ports do not land on neighbouring sockets, then reduced
+
+* modulo the group size. Empty for @ref udp::Steering::Kernel.
 
 */
 
-ssize_t UdpSocket::send_batch(const std::vector<std::vector<uint8_t>>& bufs, const sockaddr_in* addr) {
+static std::vector<sock_filter> steering_program(Steering steer, unsigned groups) {
 
-#if defined(__linux__)
+    std::vector<sock_filter> p;
 
-    const size_t n = bufs.size();
+    auto op = [&p](uint16_t code, uint32_t k) { p.push_back(sock_filter{code, 0, 0, k}); };
 
-    std::vector<iovec> iov(n);
+    const uint32_t kSrcAddr = static_cast<uint32_t>(SKF_NET_OFF) + 12;
 
-    std::vector<mmsghdr> msgs(n);
+    switch (steer) {
 
-    for (size_t i=0;i<n;i++) {
+    case Steering::Kernel:
 
-        iov[i].iov_base = const_cast<uint8_t*>(bufs[i].data());
+        return p;
 
-        iov[i].iov_len  = bufs[i].size();
+    case Steering::Cpu:
 
-        memset(&msgs[i], 0, sizeof(mmsghdr));
+        op(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU));
 
-        msgs[i].msg_hdr.msg_iov    = &iov[i];
+        break;
 
-        msgs[i].msg_hdr.msg_iovlen = 1;
+    case Steering::SrcIp:
 
-        if (!connected_) {
+        op(BPF_LD | BPF_W | BPF_ABS, kSrcAddr);
 
-            msgs[i].msg_hdr.msg_name    = const_cast<sockaddr_in*>(addr);
+        break;
 
-            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    case Steering::SrcPort:
 
-        }
+        op(BPF_LDX | BPF_B | BPF_MSH, static_cast<uint32_t>(SKF_NET_OFF));
 
-    }
+        op(BPF_LD | BPF_H | BPF_IND, static_cast<uint32_t>(SKF_NET_OFF));
 
-    int r = sendmmsg(sockfd_, msgs.data(), n, 0);
+        break;
 
-    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+    case Steering::Flow:
 
-    if (r < 0) return -1;
+        op(BPF_LD | BPF_W | BPF_ABS, kSrcAddr);
 
-    return r;
+        op(BPF_ST, 0);
 
-#else
+        op(BPF_LDX | BPF_B | BPF_MSH, static_cast<uint32_t>(SKF_NET_OFF));
 
-    // Fallback to single sendto/connect
+        op(BPF_LD | BPF_H | BPF_IND, static_cast<uint32_t>(SKF_NET_OFF));
 
-    ssize_t cnt = 0;
+        op(BPF_LDX | BPF_MEM, 0);
 
-    for (auto& b : bufs) {
+        op(BPF_ALU | BPF_XOR | BPF_X, 0);
 
-        ssize_t r;
+        break;
 
-        if (connected_) r = ::send(sockfd_, b.data(), b.size(), 0);
+    }
 
-        else            r = ::sendto(sockfd_, b.data(), b.size(), 0, (sockaddr*)addr, sizeof(sockaddr_in));
+    if (steer != Steering::Cpu) {
 
-        if (r >= 0) cnt++;
+        op(BPF_ALU | BPF_MUL | BPF_K, 0x9E3779B1u);
+
+        op(BPF_ALU | BPF_RSH | BPF_K, 16);
 
     }
 
-    return cnt;
+    op(BPF_ALU | BPF_MOD | BPF_K, groups ? groups : 1);
 
-#endif
+    op(BPF_RET | BPF_A, 0);
+
+    return p;
 
 }
+
+/// \endcond
+
+#endif
  
-/// \copydoc udp::ISocket::set_rcvbuf
+/// \copydoc udp::parse_steering
 
-void UdpSocket::set_rcvbuf(int bytes) {
+bool parse_steering(const std::string& name, Steering& out) {
 
-    setsockopt(sockfd_, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+    if (name == "kernel") { out = Steering::Kernel; return true; }
 
-}
- 
-/// \copydoc udp::ISocket::set_sndbuf
+    if (name == "cpu") { out = Steering::Cpu; return true; }
 
-void UdpSocket::set_sndbuf(int bytes) {
+    if (name == "src-ip") { out = Steering::SrcIp; return true; }
 
-    setsockopt(sockfd_, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes));
+    if (name == "src-port") { out = Steering::SrcPort; return true; }
+
+    if (name == "flow") { out = Steering::Flow; return true; }
+
+    return false;
 
 }
  
 /**
 
-* @brief Return up to `bufs.size()` preloaded datagrams into caller buffers.
+* \copydoc udp::ISocket::set_steering
 
 *
 
-* @details Copies from `rx_store_` into `bufs[i]` up to the minimum of source
+* @details Only records the choice; @ref bind attaches the program.
 
-* size and destination capacity (truncation possible, consistent with UDP recv).
+*/
 
-* Advances an internal cursor so subsequent calls continue where the last ended.
+bool UdpSocket::set_steering(Steering steering, unsigned group_size) {
 
-*
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+
+    steer_ = steering;
+
+    steer_group_ = group_size ? group_size : 1;
+
+    return true;
+
+#else
+
+    return steering == Steering::Kernel;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::bind
+
+*
+
+* @details
+
+* - Optionally enables `SO_REUSEPORT` when requested and supported.
+
+* - With reuseport and a steering mode (@ref set_steering), attaches the steering
+
+*   program to the group once bound. Every member attaches the same program, so
+
+*   the last bind wins and the result does not depend on bind order.
+
+* - Binds to `INADDR_ANY` on the given port (host byte order converted via `htons`).
+
+* - Throws `std::runtime_error` with `strerror(errno)` on failure.
+
+*/
+
+void UdpSocket::bind(uint16_t port, bool reuseport) {
+
+    if (reuseport) {
+
+#ifdef SO_REUSEPORT
+
+        int one = 1;
+
+        setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+#endif
+
+    }
+
+    sockaddr_in addr{};
+
+    addr.sin_family = AF_INET;
+
+    addr.sin_addr.s_addr = INADDR_ANY;
+
+    addr.sin_port = htons(port);
+
+    if (::bind(sockfd_, (sockaddr*)&addr, sizeof(addr)) < 0)
+
+        throw std::runtime_error("bind() failed: " + std::string(strerror(errno)));
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+
+    if (reuseport && steer_ != Steering::Kernel) {
+
+        std::vector<sock_filter> prog = steering_program(steer_, steer_group_);
+
+        sock_fprog fprog{};
+
+        fprog.len = static_cast<unsigned short>(prog.size());
+
+        fprog.filter = prog.data();
+
+        if (setsockopt(sockfd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &fprog, sizeof(fprog)) < 0)
+
+            throw std::runtime_error("SO_ATTACH_REUSEPORT_CBPF failed: " + std::string(strerror(errno)));
+
+    }
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::connect
+
+*
+
+* @details
+
+* - Resolves the dotted IPv4 string with `inet_pton`.
+
+* - Calls `::connect()` and sets `connected_ = true` on success.
+
+* - Throws `std::runtime_error` with `strerror(errno)` on failure.
+
+*/
+
+void UdpSocket::connect(const std::string& ip, uint16_t port) {
+
+    memset(&peer_, 0, sizeof(peer_));
+
+    peer_.sin_family = AF_INET;
+
+    inet_pton(AF_INET, ip.c_str(), &peer_.sin_addr);
+
+    peer_.sin_port = htons(port);
+
+    if (::connect(sockfd_, (sockaddr*)&peer_, sizeof(peer_)) < 0)
+
+        throw std::runtime_error("connect() failed: " + std::string(strerror(errno)));
+
+    connected_ = true;
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::recv_batch
+
+*
+
+* @details Linux fast-path:
+
+* - Grows the persistent RX ring if `bufs.size()` exceeds its capacity (rare),
+
+*   then points each slot's `iovec` at `bufs[i]` and resets the lengths the
+
+*   kernel writes back (`msg_namelen`, `msg_controllen`, `msg_flags`).
+
+* - Calls `recvmmsg()` once; on `EAGAIN`/`EWOULDBLOCK` returns 0 (no messages).
+
+* - On other errors returns -1; otherwise returns the number of messages received.
+
+*
+
+* Fallback:
+
+* - Performs a single `recvfrom` into `bufs[0]` and returns 1 on success,
+
+*   0 on `EAGAIN`/`EWOULDBLOCK`, or -1 on error.
+
+*
+
+* @note Return value is a **message count**, not bytes.
+
+*/
+
+ssize_t UdpSocket::recv_batch(std::vector<std::vector<uint8_t>>& bufs) {
+
+#if defined(__linux__)
+
+    if (gro_) {
+
+        // Split coalesced reads, then copy each datagram (truncating like recvfrom).
+
+        if (gro_scratch_.size() < bufs.size()) gro_scratch_.resize(bufs.size());
+
+        ssize_t r = take_gro(gro_scratch_.data(), bufs.size());
+
+        for (ssize_t i=0;i<r;i++) {
+
+            size_t len = std::min<size_t>(gro_scratch_[i].len, bufs[i].size());
+
+            memcpy(bufs[i].data(), gro_scratch_[i].data, len);
+
+        }
+
+        return r;
+
+    }
+
+    // Use recvmmsg if available
+
+    const size_t n = bufs.size();
+
+    rx_ring_.reserve(n);
+
+    mmsghdr* msgs = rx_ring_.msgs.data();
+
+    for (size_t i=0;i<n;i++) {
+
+        rx_ring_.iov[i].iov_base = bufs[i].data();
+
+        rx_ring_.iov[i].iov_len  = bufs[i].size();
+
+        msgs[i].msg_hdr.msg_namelen    = sizeof(sockaddr_in);
+
+        msgs[i].msg_hdr.msg_controllen = kCtrlLen;
+
+        msgs[i].msg_hdr.msg_flags      = 0;
+
+    }
+
+    int r = recvmmsg(sockfd_, msgs, n, rx_flags_, nullptr);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0) return -1;
+
+    return r;
+
+#else
+
+    // Fallback to single recvfrom
+
+    sockaddr_in addr{};
+
+    socklen_t alen = sizeof(addr);
+
+    ssize_t r = recvfrom(sockfd_, bufs[0].data(), bufs[0].size(), 0, (sockaddr*)&addr, &alen);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0) return -1;
+
+    return 1;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::send_batch
+
+*
+
+* @details Linux fast-path:
+
+* - Grows the persistent TX ring if `bufs.size()` exceeds its capacity (rare),
+
+*   then points each slot's `iovec` at `bufs[i]`.
+
+* - If the socket is not `connected_`, per-call `addr` is attached to each msg.
+
+* - Calls `sendmmsg()` once; on `EAGAIN`/`EWOULDBLOCK` returns 0, on other errors -1,
+
+*   else the number of messages actually sent.
+
+*
+
+* Fallback:
+
+* - Loops `send()` (connected) or `sendto()` (unconnected) over `bufs`.
+
+* - Returns the **count** of successful sends.
+
+*
+
+* @note Return value is a **message count**, not bytes.
+
+*/
+
+ssize_t UdpSocket::send_batch(const std::vector<std::vector<uint8_t>>& bufs, const sockaddr_in* addr) {
+
+#if defined(__linux__)
+
+    const size_t n = bufs.size();
+
+    tx_ring_.reserve(n);
+
+    mmsghdr* msgs = tx_ring_.msgs.data();
+
+    for (size_t i=0;i<n;i++) {
+
+        tx_ring_.iov[i].iov_base = const_cast<uint8_t*>(bufs[i].data());
+
+        tx_ring_.iov[i].iov_len  = bufs[i].size();
+
+        msgs[i].msg_hdr.msg_iov        = &tx_ring_.iov[i];
+
+        msgs[i].msg_hdr.msg_iovlen     = 1;
+
+        msgs[i].msg_hdr.msg_name       = connected_ ? nullptr : const_cast<sockaddr_in*>(addr);
+
+        msgs[i].msg_hdr.msg_namelen    = connected_ ? 0 : sizeof(sockaddr_in);
+
+        msgs[i].msg_hdr.msg_control    = nullptr;
+
+        msgs[i].msg_hdr.msg_controllen = 0;
+
+    }
+
+    int r = send_msgs(msgs, n);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0) return -1;
+
+    return r;
+
+#else
+
+    // Fallback to single sendto/connect
+
+    ssize_t cnt = 0;
+
+    for (auto& b : bufs) {
+
+        ssize_t r;
+
+        if (connected_) r = ::send(sockfd_, b.data(), b.size(), MSG_DONTWAIT);
+
+        else            r = ::sendto(sockfd_, b.data(), b.size(), MSG_DONTWAIT, (sockaddr*)addr, sizeof(sockaddr_in));
+
+        if (r >= 0) cnt++;
+
+    }
+
+    return cnt;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::recv_batch(PacketSlab&)
+
+*
+
+* @details Linux fast-path:
+
+* - With GRO active (@ref set_gro), delegates to @ref take_gro: the views then
+
+*   point into the socket's GRO buffers instead of the slab slots.
+
+* - Resets the slab views, grows the persistent RX ring if needed (rare), and
+
+*   points each `iovec` straight at the matching slab slot.
+
+* - Calls `recvmmsg()` once, then copies each `msg_len` and source address into
+
+*   the corresponding view. No allocation, no per-packet copy of payload bytes.
+
+* - With RX timestamps enabled, also fills each view's `rx_ts_ns` from the
+
+*   message's control area (converted to the steady clock).
+
+*
+
+* Fallback:
+
+* - Performs a single `recvfrom` into slot 0.
+
+*
+
+* @note Return value is a **message count**, not bytes.
+
+*/
+
+ssize_t UdpSocket::recv_batch(PacketSlab& slab) {
+
+    slab.reset_views();
+
+#if defined(__linux__)
+
+    if (gro_) {
+
+        ssize_t r = take_gro(slab.begin(), slab.capacity());
+
+        if (r > 0) slab.set_size(static_cast<size_t>(r));
+
+        return r;
+
+    }
+
+    const size_t n = slab.capacity();
+
+    rx_ring_.reserve(n);
+
+    mmsghdr* msgs = rx_ring_.msgs.data();
+
+    for (size_t i=0;i<n;i++) {
+
+        rx_ring_.iov[i].iov_base = slab.slot(i);
+
+        rx_ring_.iov[i].iov_len  = slab.slot_size();
+
+        msgs[i].msg_hdr.msg_namelen    = sizeof(sockaddr_in);
+
+        msgs[i].msg_hdr.msg_controllen = kCtrlLen;
+
+        msgs[i].msg_hdr.msg_flags      = 0;
+
+    }
+
+    int r = recvmmsg(sockfd_, msgs, n, rx_flags_, nullptr);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0) return -1;
+
+    for (int i=0;i<r;i++) {
+
+        slab[i].len  = msgs[i].msg_len;
+
+        slab[i].addr = rx_ring_.addrs[i];
+
+    }
+
+    if (ts_mode_) {
+
+        const uint64_t off = realtime_offset_ns();
+
+        for (int i=0;i<r;i++) {
+
+            const uint64_t ts = rx_timestamp(msgs[i].msg_hdr, ts_mode_);
+
+            slab[i].rx_ts_ns = ts > off ? ts - off : 0;
+
+        }
+
+    }
+
+    slab.set_size(static_cast<size_t>(r));
+
+    return r;
+
+#else
+
+    socklen_t alen = sizeof(sockaddr_in);
+
+    ssize_t r = recvfrom(sockfd_, slab.slot(0), slab.slot_size(), 0, (sockaddr*)&slab[0].addr, &alen);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0) return -1;
+
+    slab[0].len = static_cast<uint32_t>(r);
+
+    slab.set_size(1);
+
+    return 1;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::send_batch(const PacketSlab&,const sockaddr_in*)
+
+*
+
+* @details Linux fast-path:
+
+* - With GSO active (@ref set_gso), delegates to @ref send_gso.
+
+* - Points each TX ring `iovec` at view `i` (`data`, `len`) of the slab.
+
+* - Destination per message: nothing if `connected_`, else `addr` if given,
+
+*   else the view's own address.
+
+* - Calls `sendmmsg()` once; on `EAGAIN`/`EWOULDBLOCK` returns 0, on other errors -1.
+
+*
+
+* Fallback:
+
+* - Loops `send()`/`sendto()` over the valid views.
+
+*
+
+* @note Return value is a **message count**, not bytes.
+
+*/
+
+ssize_t UdpSocket::send_batch(const PacketSlab& slab, const sockaddr_in* addr) {
+
+    const size_t n = slab.size();
+
+    if (n == 0) return 0;
+
+#if defined(__linux__)
+
+    if (gso_) return send_gso(slab, addr);
+
+    tx_ring_.reserve(n);
+
+    mmsghdr* msgs = tx_ring_.msgs.data();
+
+    for (size_t i=0;i<n;i++) {
+
+        const PacketView& v = slab[i];
+
+        const sockaddr_in* dst = addr ? addr : &v.addr;
+
+        tx_ring_.iov[i].iov_base = v.data;
+
+        tx_ring_.iov[i].iov_len  = v.len;
+
+        msgs[i].msg_hdr.msg_iov        = &tx_ring_.iov[i];
+
+        msgs[i].msg_hdr.msg_iovlen     = 1;
+
+        msgs[i].msg_hdr.msg_name       = connected_ ? nullptr : const_cast<sockaddr_in*>(dst);
+
+        msgs[i].msg_hdr.msg_namelen    = connected_ ? 0 : sizeof(sockaddr_in);
+
+        msgs[i].msg_hdr.msg_control    = nullptr;
+
+        msgs[i].msg_hdr.msg_controllen = 0;
+
+    }
+
+    int r = send_msgs(msgs, n);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0) return -1;
+
+    return r;
+
+#else
+
+    ssize_t cnt = 0;
+
+    for (const PacketView& v : slab) {
+
+        const sockaddr_in* dst = addr ? addr : &v.addr;
+
+        ssize_t r;
+
+        if (connected_) r = ::send(sockfd_, v.data, v.len, MSG_DONTWAIT);
+
+        else            r = ::sendto(sockfd_, v.data, v.len, MSG_DONTWAIT, (const sockaddr*)dst, sizeof(sockaddr_in));
+
+        if (r >= 0) cnt++;
+
+    }
+
+    return cnt;
+
+#endif
+
+}
+ 
+#if defined(__linux__)
+
+/**
+
+* @brief GSO send: one `sendmmsg` entry per run of same-destination, same-size views.
+
+*
+
+* @details
+
+* - A run starts at view `i` with segment size `len(i)` and extends while the
+
+*   next view has the same destination, is not longer than the segment size, and
+
+*   the run stays within @ref kMaxGsoSegs segments and @ref kMaxGsoBytes bytes.
+
+*   A shorter view ends the run (the kernel only allows a short final segment).
+
+* - Views are gathered in place: TX ring `iovec`s `[i, i+k)` become the run's
+
+*   `msg_iov`, so no payload is copied. Runs of more than one view carry a
+
+*   `UDP_SEGMENT` control message in the message's own control slot.
+
+* - The return value is still a **datagram** count: the `msg_iovlen` of every
+
+*   message the kernel accepted.
+
+* - If the kernel or route rejects GSO (`EIO`/`EINVAL`, e.g. segment size above
+
+*   the path MTU or no checksum offload), GSO is switched off for this socket and
+
+*   the batch is resent through the plain path.
+
+*/
+
+ssize_t UdpSocket::send_gso(const PacketSlab& slab, const sockaddr_in* addr) {
+
+    const size_t n = slab.size();
+
+    tx_ring_.reserve(n);
+
+    mmsghdr* msgs = tx_ring_.msgs.data();
+
+    size_t m = 0;
+
+    for (size_t i=0;i<n;) {
+
+        const PacketView& first = slab[i];
+
+        const uint32_t seg = first.len;
+
+        tx_ring_.iov[i].iov_base = first.data;
+
+        tx_ring_.iov[i].iov_len  = seg;
+
+        size_t k = 1, bytes = seg;
+
+        while (seg > 0 && i + k < n && k < kMaxGsoSegs) {
+
+            const PacketView& v = slab[i + k];
+
+            if (v.len == 0 || v.len > seg || bytes + v.len > kMaxGsoBytes) break;
+
+            if (!connected_ && !addr && !same_peer(v.addr, first.addr)) break;
+
+            tx_ring_.iov[i + k].iov_base = v.data;
+
+            tx_ring_.iov[i + k].iov_len  = v.len;
+
+            bytes += v.len;
+
+            ++k;
+
+            if (v.len < seg) break;
+
+        }
+
+        msghdr& h = msgs[m].msg_hdr;
+
+        const sockaddr_in* dst = addr ? addr : &first.addr;
+
+        h.msg_iov     = &tx_ring_.iov[i];
+
+        h.msg_iovlen  = k;
+
+        h.msg_name    = connected_ ? nullptr : const_cast<sockaddr_in*>(dst);
+
+        h.msg_namelen = connected_ ? 0 : sizeof(sockaddr_in);
+
+        if (k > 1) {
+
+            h.msg_control    = tx_ring_.ctrl.data() + m*kCtrlLen;
+
+            h.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+            cmsghdr* c = CMSG_FIRSTHDR(&h);
+
+            c->cmsg_level = SOL_UDP;
+
+            c->cmsg_type  = UDP_SEGMENT;
+
+            c->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+
+            const uint16_t gso_size = static_cast<uint16_t>(seg);
+
+            memcpy(CMSG_DATA(c), &gso_size, sizeof(gso_size));
+
+        } else {
+
+            h.msg_control    = nullptr;
+
+            h.msg_controllen = 0;
+
+        }
+
+        ++m;
+
+        i += k;
+
+    }
+
+    int r = send_msgs(msgs, m);
+
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+    if (r < 0 && (errno == EIO || errno == EINVAL)) {
+
+        gso_ = false;
+
+        return send_batch(slab, addr);
+
+    }
+
+    if (r < 0) return -1;
+
+    ssize_t sent = 0;
+
+    for (int j=0;j<r;j++) sent += static_cast<ssize_t>(msgs[j].msg_hdr.msg_iovlen);
+
+    return sent;
+
+}
+ 
+/**
+
+* @brief Hand out up to `max` datagrams from GRO reads, reading more only when none are queued.
+
+*
+
+* @details
+
+* - When the previous reads are fully split, one `recvmmsg()` fills every GRO
+
+*   buffer slot (`gro_buf_.size() / kGroBufSize` messages); `EAGAIN` returns 0.
+
+* - Each read is cut into `gro_seg_`-byte views (the last one may be shorter), all
+
+*   carrying the read's source address and RX timestamp. The cursor (`gro_next_`, `gro_off_`)
+
+*   survives across calls, so a read larger than the caller's batch is finished
+
+*   by the following call(s) without a syscall.
+
+*/
+
+ssize_t UdpSocket::take_gro(PacketView* out, size_t max) {
+
+    if (gro_next_ >= gro_msgs_) {
+
+        const size_t n = gro_buf_.size() / kGroBufSize;
+
+        mmsghdr* msgs = rx_ring_.msgs.data();
+
+        for (size_t i=0;i<n;i++) {
+
+            rx_ring_.iov[i].iov_base = gro_buf_.data() + i*kGroBufSize;
+
+            rx_ring_.iov[i].iov_len  = kGroBufSize;
+
+            msgs[i].msg_hdr.msg_namelen    = sizeof(sockaddr_in);
+
+            msgs[i].msg_hdr.msg_controllen = kCtrlLen;
+
+            msgs[i].msg_hdr.msg_flags      = 0;
+
+        }
+
+        int r = recvmmsg(sockfd_, msgs, n, rx_flags_, nullptr);
+
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+        if (r < 0) return -1;
+
+        gro_msgs_ = static_cast<size_t>(r);
+
+        gro_next_ = 0;
+
+        gro_off_  = 0;
+
+    }
+
+    size_t k = 0;
+
+    const uint64_t off = ts_mode_ ? realtime_offset_ns() : 0;
+
+    while (k < max && gro_next_ < gro_msgs_) {
+
+        const mmsghdr& m = rx_ring_.msgs[gro_next_];
+
+        if (gro_off_ == 0) {
+
+            gro_seg_ = gro_segment(m.msg_hdr, m.msg_len);
+
+            const uint64_t ts = ts_mode_ ? rx_timestamp(m.msg_hdr, ts_mode_) : 0;
+
+            gro_ts_ = ts > off ? ts - off : 0;
+
+        }
+
+        const uint32_t len = std::min<uint32_t>(gro_seg_, m.msg_len - gro_off_);
+
+        out[k].data = gro_buf_.data() + gro_next_*kGroBufSize + gro_off_;
+
+        out[k].len  = len;
+
+        out[k].addr = rx_ring_.addrs[gro_next_];
+
+        out[k].rx_ts_ns = gro_ts_;
+
+        ++k;
+
+        gro_off_ += len;
+
+        if (gro_off_ >= m.msg_len) {
+
+            ++gro_next_;
+
+            gro_off_ = 0;
+
+        }
+
+    }
+
+    return static_cast<ssize_t>(k);
+
+}
+
+#endif
+ 
+/**
+
+* \copydoc udp::ISocket::set_gso
+
+*
+
+* @details Probes `UDP_SEGMENT` with `getsockopt` (kernels before 4.18 reject it);
+
+* the segment size itself is sent per message, so nothing is set on the socket.
+
+*/
+
+bool UdpSocket::set_gso(bool enable) {
+
+#if defined(__linux__) && defined(UDP_SEGMENT)
+
+    gso_ = false;
+
+    if (enable) {
+
+        int size = 0;
+
+        socklen_t len = sizeof(size);
+
+        gso_ = getsockopt(sockfd_, SOL_UDP, UDP_SEGMENT, &size, &len) == 0;
+
+    }
+
+    return gso_;
+
+#else
+
+    (void)enable;
+
+    return false;
+
+#endif
+
+}
+ 
+#if defined(__linux__)
+
+/**
+
+* @brief Single exit point to `sendmmsg()` for every UdpSocket send path.
+
+*
+
+* @details Adds `MSG_ZEROCOPY` while zero-copy is active and counts accepted
+
+* messages as issued zero-copy ids. `ENOBUFS` in that mode means the socket's
+
+* notification budget (`optmem`) is exhausted until completions are reaped, so it
+
+* is reported as `EAGAIN` (0 messages sent) like a full send buffer.
+
+*/
+
+int UdpSocket::send_msgs(mmsghdr* msgs, size_t n) {
+
+    int flags = MSG_DONTWAIT; // the socket itself may block for receives (set_recv_wait)
+
+#ifdef MSG_ZEROCOPY
+
+    if (zc_) flags |= MSG_ZEROCOPY;
+
+#endif
+
+    int r = sendmmsg(sockfd_, msgs, n, flags);
+
+    if (r > 0 && zc_) zc_issued_ += static_cast<uint64_t>(r);
+
+    if (r < 0 && zc_ && errno == ENOBUFS) errno = EAGAIN;
+
+    return r;
+
+}
+ 
+/**
+
+* @brief Account for completed zero-copy ids `[lo, hi]` (32-bit, wrapping).
+
+*
+
+* @details Ids are widened relative to the released watermark. A range starting at
+
+* the watermark advances it (absorbing any parked ranges it now touches); a range
+
+* further ahead is parked in `zc_ooo_`, which in practice stays empty because UDP
+
+* notifications complete in order.
+
+*/
+
+void UdpSocket::complete_zc(uint32_t lo, uint32_t hi, bool copied) {
+
+    const uint64_t first = zc_done_.released + static_cast<uint32_t>(lo - static_cast<uint32_t>(zc_done_.released));
+
+    const uint64_t last  = first + static_cast<uint32_t>(hi - lo);
+
+    const uint64_t n = last - first + 1;
+
+    if (copied) zc_done_.copied += n;
+
+    else        zc_done_.zerocopy += n;
+
+    if (first != zc_done_.released) {
+
+        zc_ooo_.emplace_back(first, last);
+
+        return;
+
+    }
+
+    zc_done_.released = last + 1;
+
+    for (size_t i=0;i<zc_ooo_.size();) {
+
+        if (zc_ooo_[i].first <= zc_done_.released) {
+
+            zc_done_.released = std::max(zc_done_.released, zc_ooo_[i].second + 1);
+
+            zc_ooo_[i] = zc_ooo_.back();
+
+            zc_ooo_.pop_back();
+
+            i = 0;
+
+        } else {
+
+            ++i;
+
+        }
+
+    }
+
+}
+
+#endif
+ 
+/**
+
+* \copydoc udp::ISocket::set_gro
+
+*
+
+* @details Sets `UDP_GRO` on the socket (Linux 5.0+) and, when enabling, sizes the
+
+* GRO buffers for `batch_hint` reads of @ref kGroBufSize bytes. Toggling discards
+
+* any segments still queued from earlier reads.
+
+*/
+
+bool UdpSocket::set_gro(bool enable) {
+
+#if defined(__linux__) && defined(UDP_GRO)
+
+    int on = enable ? 1 : 0;
+
+    if (setsockopt(sockfd_, SOL_UDP, UDP_GRO, &on, sizeof(on)) < 0) {
+
+        gro_ = false;
+
+        return false;
+
+    }
+
+    gro_ = enable;
+
+    gro_msgs_ = gro_next_ = 0;
+
+    gro_off_ = 0;
+
+    if (gro_) {
+
+        const size_t n = batch_hint_ > 0 ? static_cast<size_t>(batch_hint_) : 1;
+
+        gro_buf_.resize(n * kGroBufSize);
+
+        gro_scratch_.resize(n);
+
+        rx_ring_.reserve(n);
+
+    }
+
+    return gro_;
+
+#else
+
+    (void)enable;
+
+    return false;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::set_rx_timestamps
+
+*
+
+* @details Tries software `SO_TIMESTAMPING` first (`SOF_TIMESTAMPING_RX_SOFTWARE |
+
+* SOF_TIMESTAMPING_SOFTWARE`), then `SO_TIMESTAMPNS`, and remembers which control
+
+* message type to parse. Disabling clears both options.
+
+*/
+
+bool UdpSocket::set_rx_timestamps(bool enable) {
+
+#if defined(__linux__) && defined(SO_TIMESTAMPNS)
+
+    ts_mode_ = 0;
+
+    if (!enable) {
+
+        int zero = 0;
+
+#ifdef SO_TIMESTAMPING
+
+        setsockopt(sockfd_, SOL_SOCKET, SO_TIMESTAMPING, &zero, sizeof(zero));
+
+#endif
+
+        setsockopt(sockfd_, SOL_SOCKET, SO_TIMESTAMPNS, &zero, sizeof(zero));
+
+        return false;
+
+    }
+
+#ifdef SO_TIMESTAMPING
+
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+    if (setsockopt(sockfd_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+
+        ts_mode_ = SCM_TIMESTAMPING;
+
+        return true;
+
+    }
+
+#endif
+
+    int one = 1;
+
+    if (setsockopt(sockfd_, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0)
+
+        ts_mode_ = SCM_TIMESTAMPNS;
+
+    return ts_mode_ != 0;
+
+#else
+
+    (void)enable;
+
+    return false;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::set_recv_wait
+
+*
+
+* @details Clears `O_NONBLOCK`, bounds each wait with `SO_RCVTIMEO` and passes
+
+* `MSG_WAITFORONE` to `recvmmsg`, which blocks for the first message only. Every
+
+* send path passes `MSG_DONTWAIT`, so sends keep their non-blocking behaviour.
+
+*/
+
+bool UdpSocket::set_recv_wait(int timeout_ms) {
+
+    const int flags = fcntl(sockfd_, F_GETFL, 0);
+
+    timeval tv{};
+
+    tv.tv_sec  = timeout_ms / 1000;
+
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+
+    if (timeout_ms <= 0) {
+
+        setsockopt(sockfd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+        fcntl(sockfd_, F_SETFL, flags | O_NONBLOCK);
+
+        rx_flags_ = 0;
+
+        return false;
+
+    }
+
+    if (setsockopt(sockfd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) return false;
+
+    if (fcntl(sockfd_, F_SETFL, flags & ~O_NONBLOCK) < 0) return false;
+
+#ifdef MSG_WAITFORONE
+
+    rx_flags_ = MSG_WAITFORONE;
+
+#endif
+
+    return true;
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::set_busy_poll
+
+*
+
+* @details Each option is set only when requested (non-zero) and guarded by its
+
+* own `#ifdef`, since `SO_PREFER_BUSY_POLL`/`SO_BUSY_POLL_BUDGET` are newer (5.11)
+
+* than `SO_BUSY_POLL`. Failures are not errors: the read-back tells the caller.
+
+*/
+
+BusyPoll UdpSocket::set_busy_poll(const BusyPoll& want) {
+
+    BusyPoll got;
+
+#if defined(__linux__) && defined(SO_BUSY_POLL)
+
+    socklen_t len = sizeof(int);
+
+    if (want.usecs > 0) setsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL, &want.usecs, sizeof(int));
+
+    getsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL, &got.usecs, &len);
+
+#ifdef SO_PREFER_BUSY_POLL
+
+    int prefer = want.prefer ? 1 : 0;
+
+    if (prefer) setsockopt(sockfd_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+
+    len = sizeof(int);
+
+    if (getsockopt(sockfd_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, &len) == 0) got.prefer = prefer != 0;
+
+#endif
+
+#ifdef SO_BUSY_POLL_BUDGET
+
+    // Not readable on every kernel (ENOPROTOOPT): fall back to what was accepted.
+
+    if (want.budget > 0 && setsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &want.budget, sizeof(int)) == 0)
+
+        got.budget = want.budget;
+
+    int budget = 0;
+
+    len = sizeof(int);
+
+    if (getsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget, &len) == 0) got.budget = budget;
+
+#endif
+
+#else
+
+    (void)want;
+
+#endif
+
+    return got;
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::set_zerocopy
+
+*
+
+* @details Sets `SO_ZEROCOPY` (Linux 5.0+ for UDP). Disabling only stops adding
+
+* `MSG_ZEROCOPY`; completions of sends already issued are still reaped.
+
+*/
+
+bool UdpSocket::set_zerocopy(bool enable) {
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
+    zc_ = false;
+
+    if (enable) {
+
+        int one = 1;
+
+        zc_ = setsockopt(sockfd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+
+        if (zc_) zc_ooo_.reserve(16);
+
+    }
+
+    return zc_;
+
+#else
+
+    (void)enable;
+
+    return false;
+
+#endif
+
+}
+ 
+/**
+
+* \copydoc udp::ISocket::reap_tx
+
+*
+
+* @details Returns immediately (no syscall) when nothing is outstanding. Otherwise
+
+* drains `MSG_ERRQUEUE` with `MSG_DONTWAIT`; each notification carries one
+
+* contiguous id range, and the copied-fallback flag applies to the whole range.
+
+*/
+
+TxCompletions UdpSocket::reap_tx() {
+
+#if defined(__linux__) && defined(SO_EE_ORIGIN_ZEROCOPY)
+
+    if (zc_done_.released == zc_issued_) return zc_done_;
+
+    char ctrl[128];
+
+    for (;;) {
+
+        msghdr msg{};
+
+        msg.msg_control = ctrl;
+
+        msg.msg_controllen = sizeof(ctrl);
+
+        if (recvmsg(sockfd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) break;
+
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+
+            if (!(c->cmsg_level == SOL_IP && c->cmsg_type == IP_RECVERR)) continue;
+
+            sock_extended_err ee;
+
+            memcpy(&ee, CMSG_DATA(c), sizeof(ee));
+
+            if (ee.ee_errno != 0 || ee.ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+
+            complete_zc(ee.ee_info, ee.ee_data, (ee.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+
+        }
+
+    }
+
+#endif
+
+    return zc_done_;
+
+}
+ 
+/// \copydoc udp::UdpSocket::ring_capacity
+
+size_t UdpSocket::ring_capacity() const {
+
+#if defined(__linux__)
+
+    return rx_ring_.capacity();
+
+#else
+
+    return 0;
+
+#endif
+
+}
+ 
+/// \copydoc udp::ISocket::set_rcvbuf
+
+void UdpSocket::set_rcvbuf(int bytes) {
+
+    setsockopt(sockfd_, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+
+}
+ 
+/// \copydoc udp::ISocket::set_sndbuf
+
+void UdpSocket::set_sndbuf(int bytes) {
+
+    setsockopt(sockfd_, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes));
+
+}
+ 
+/**
+
+* @brief Return up to `bufs.size()` preloaded datagrams into caller buffers.
+
+*
+
+* @details Copies from `rx_store_` into `bufs[i]` up to the minimum of source
+
+* size and destination capacity (truncation possible, consistent with UDP recv).
+
+* Advances an internal cursor so subsequent calls continue where the last ended.
+
+*
 
 * @return Number of messages copied into `bufs` (0..bufs.size()).
 
@@ -482,14 +1892,149 @@ ssize_t MockSocket::recv_batch(std::vector<std::vector<uint8_t>>& bufs) {
 
 */
 
-ssize_t MockSocket::send_batch(const std::vector<std::vector<uint8_t>>& bufs, const sockaddr_in* ) {
+ssize_t MockSocket::send_batch(const std::vector<std::vector<uint8_t>>& bufs, const sockaddr_in* addr) {
+
+    for (auto& b : bufs) {
+
+        tx_store_.push_back(b);
 
-    for (auto& b : bufs) tx_store_.push_back(b);
+        tx_addrs_.push_back(addr ? *addr : sockaddr_in{});
+
+    }
 
     return static_cast<ssize_t>(bufs.size());
 
 }
  
+/**
+
+* @brief Copy up to `slab.capacity()` preloaded datagrams into the slab slots.
+
+*
+
+* @details Like the vector flavor, truncates to the slot size. Each view also
+
+* receives the source address given to @ref preload_recv, and its timestamp
+
+* once RX timestamps are enabled.
+
+*
+
+* @return Number of messages copied (0..slab.capacity()).
+
+*/
+
+ssize_t MockSocket::recv_batch(PacketSlab& slab) {
+
+    slab.reset_views();
+
+    size_t i=0;
+
+    for (; i<slab.capacity() && recv_cursor_ < rx_store_.size(); ++i, ++recv_cursor_) {
+
+        auto& src = rx_store_[recv_cursor_];
+
+        size_t n = std::min(slab.slot_size(), src.size());
+
+        std::copy(src.begin(), src.begin()+n, slab.slot(i));
+
+        slab[i].len  = static_cast<uint32_t>(n);
+
+        slab[i].addr = rx_addrs_[recv_cursor_];
+
+        if (rx_ts_on_) slab[i].rx_ts_ns = rx_ts_[recv_cursor_];
+
+    }
+
+    slab.set_size(i);
+
+    return static_cast<ssize_t>(i);
+
+}
+ 
+/**
+
+* @brief Record the valid views of `slab` in the sent store.
+
+*
+
+* @details Destination bookkeeping mirrors @ref UdpSocket: `addr` if given,
+
+* otherwise each view's own address.
+
+*
+
+* @return The number of messages recorded (equals `slab.size()`).
+
+*/
+
+ssize_t MockSocket::send_batch(const PacketSlab& slab, const sockaddr_in* addr) {
+
+    for (const PacketView& v : slab) {
+
+        tx_store_.emplace_back(v.data, v.data + v.len);
+
+        tx_addrs_.push_back(addr ? *addr : v.addr);
+
+    }
+
+    return static_cast<ssize_t>(slab.size());
+
+}
+ 
+/// \copydoc udp::parse_backend
+
+bool parse_backend(const std::string& name, SocketBackend& out) {
+
+    if (name == "mmsg") { out = SocketBackend::Mmsg; return true; }
+
+    if (name == "io_uring") { out = SocketBackend::IoUring; return true; }
+
+    return false;
+
+}
+ 
+/**
+
+* @brief Instantiate the requested backend, falling back to `UdpSocket`.
+
+*
+
+* @details The io_uring constructor itself is the capability probe: it throws
+
+* with a descriptive reason (missing syscall, provided buffer rings or multishot
+
+* receive), which is reported once on `stderr`. A refused SQPOLL request (the
+
+* ring is then created without it) is reported the same way.
+
+*/
+
+std::unique_ptr<ISocket> create_socket(SocketBackend backend, int batch_hint, bool sqpoll) {
+
+    if (backend == SocketBackend::IoUring) {
+
+        try {
+
+            auto s = std::make_unique<IoUringSocket>(batch_hint, sqpoll);
+
+            if (sqpoll && !s->sqpoll()) std::cerr << "io_uring SQPOLL refused by the kernel, submitting with io_uring_enter\n";
+
+            return s;
+
+        } catch (const std::exception& e) {
+
+            std::cerr << "io_uring backend unavailable (" << e.what()
+                      << "), falling back to recvmmsg/sendmmsg\n";
+
+        }
+
+    }
+
+    return std::make_unique<UdpSocket>(batch_hint);
+
+}
+ 
 } // namespace udp
 
  
\ No newline at end of file
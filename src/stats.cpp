@@ -1,10 +1,38 @@
 /**
 * @file
-* @brief Implementation unit placeholder for udp::Stats.
+* @brief Out-of-line parts of udp::Stats.
 *
-* All current members are inline in `include/udp/stats.hpp` for hot-path
-* performance. This TU exists as a placeholder for future non-inline
-* expansions and to keep build graphs stable.
+* Hot-path members stay inline in `include/udp/stats.hpp`. Only the cold shard
+* merge used by snapshots and `/metrics` lives here.
 */
 #include "udp/stats.hpp"
-// All inline / trivial; kept for potential expansion
\ No newline at end of file
+ 
+namespace udp {
+ 
+/// \copydoc udp::Stats::merge_from
+void Stats::merge_from(const Stats& o) {
+    auto add = [](std::atomic<uint64_t>& dst, const std::atomic<uint64_t>& src) {
+        dst.fetch_add(src.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    };
+    add(sent_, o.sent_);
+    add(recv_, o.recv_);
+    add(rx_bytes_, o.rx_bytes_);
+    add(tx_bytes_, o.tx_bytes_);
+    add(zc_sends_, o.zc_sends_);
+    add(zc_copied_, o.zc_copied_);
+    add(queue_ns_, o.queue_ns_);
+    add(queue_n_, o.queue_n_);
+    add(proc_ns_, o.proc_ns_);
+    add(proc_n_, o.proc_n_);
+    add(loop_idle_, o.loop_idle_);
+    add(loop_busy_, o.loop_busy_);
+    add(seq_lost_, o.seq_lost_);
+    add(seq_reordered_, o.seq_reordered_);
+    add(seq_duplicate_, o.seq_duplicate_);
+    add(seq_invalid_, o.seq_invalid_);
+    for (size_t k=0; k<kLatencyKinds; ++k) lat_[k].merge_from(o.lat_[k]);
+ 
+    clients_.merge_from(o.clients_);
+}
+ 
+} // namespace udp
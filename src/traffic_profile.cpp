@@ -0,0 +1,184 @@
+/**
+* @file
+* @brief TrafficProfile parsing (CLI spec and schedule files) and rate lookup.
+*/
+#include "udp/traffic_profile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+ 
+namespace udp {
+ 
+/// \cond INTERNAL
+static std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    std::string cur;
+    std::istringstream in(s);
+    while (std::getline(in, cur, sep)) out.push_back(cur);
+    return out;
+}
+ 
+static std::string trim(const std::string& s) {
+    const size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return "";
+    return s.substr(b, s.find_last_not_of(" \t\r") - b + 1);
+}
+ 
+/// @brief Parse a non-negative number followed by one of @p units (scale factors).
+static bool parse_scaled(const std::string& s, double& out,
+                         std::initializer_list<std::pair<const char*, double>> units) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    const double v = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || !std::isfinite(v) || v < 0) return false;
+    const std::string suffix(end);
+    for (const auto& u : units) {
+        if (suffix == u.first) { out = v * u.second; return true; }
+    }
+    return false;
+}
+ 
+static const char* kind_name(PhaseKind k) {
+    switch (k) {
+    case PhaseKind::Constant: return "const";
+    case PhaseKind::Poisson:  return "poisson";
+    case PhaseKind::Warmup:   return "warmup";
+    case PhaseKind::Ramp:     return "ramp";
+    case PhaseKind::Step:     return "step";
+    case PhaseKind::OnOff:    return "onoff";
+    }
+    return "?";
+}
+/// \endcond
+ 
+/// \copydoc udp::parse_rate
+bool parse_rate(const std::string& s, double& out) {
+    return parse_scaled(s, out, {{"", 1}, {"k", 1e3}, {"K", 1e3}, {"M", 1e6}, {"G", 1e9}});
+}
+ 
+/// \copydoc udp::parse_duration
+bool parse_duration(const std::string& s, double& out) {
+    return parse_scaled(s, out, {{"", 1}, {"s", 1}, {"ms", 1e-3}, {"us", 1e-6}});
+}
+ 
+void TrafficProfile::add(const Phase& p) {
+    if (starts_.empty()) starts_.push_back(0);
+    phases_.push_back(p);
+    starts_.push_back(starts_.back() + p.seconds);
+}
+ 
+/**
+* @details Every phase must have a positive duration; @c onoff needs a positive
+* period and @c step at least one level.
+*/
+TrafficProfile TrafficProfile::parse(const std::string& spec) {
+    TrafficProfile prof;
+    std::string flat = spec;
+    std::replace(flat.begin(), flat.end(), '\n', ',');
+    for (const std::string& raw : split(flat, ',')) {
+        const std::string text = trim(raw);
+        if (text.empty()) continue;
+        const std::vector<std::string> f = split(text, ':');
+        const std::string& kind = f[0];
+        Phase p;
+        bool ok = false;
+        if ((kind == "const" || kind == "poisson" || kind == "warmup") && f.size() == 3) {
+            p.kind = kind == "const" ? PhaseKind::Constant : kind == "poisson" ? PhaseKind::Poisson : PhaseKind::Warmup;
+            ok = parse_rate(f[1], p.pps) && parse_duration(f[2], p.seconds);
+        } else if (kind == "ramp" && f.size() == 4) {
+            p.kind = PhaseKind::Ramp;
+            ok = parse_rate(f[1], p.pps) && parse_rate(f[2], p.pps_end) && parse_duration(f[3], p.seconds);
+        } else if (kind == "step" && f.size() == 5) {
+            p.kind = PhaseKind::Step;
+            double steps = 0;
+            ok = parse_rate(f[1], p.pps) && parse_rate(f[2], p.pps_end) && parse_rate(f[3], steps)
+                 && steps >= 1 && steps == std::floor(steps) && parse_duration(f[4], p.seconds);
+            p.steps = static_cast<unsigned>(std::min(steps, 1e6));
+        } else if (kind == "onoff" && f.size() == 5) {
+            p.kind = PhaseKind::OnOff;
+            ok = parse_rate(f[1], p.pps) && parse_duration(f[2], p.on_s) && parse_duration(f[3], p.off_s)
+                 && p.on_s + p.off_s > 0 && parse_duration(f[4], p.seconds);
+        }
+        if (!ok || p.seconds <= 0) throw std::invalid_argument("bad traffic phase '" + text + "'");
+        prof.add(p);
+    }
+    return prof;
+}
+ 
+TrafficProfile TrafficProfile::load(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) throw std::runtime_error("cannot read schedule file " + path);
+    std::string spec, line;
+    while (std::getline(f, line)) {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        spec += line;
+        spec += '\n';
+    }
+    return parse(spec);
+}
+ 
+double TrafficProfile::peak() const {
+    double m = 0;
+    for (const Phase& p : phases_) m = std::max({m, p.pps, p.pps_end});
+    return m;
+}
+ 
+/**
+* @details Linear in the number of phases (a handful), so it is cheap enough to
+* call once per send.
+*/
+TrafficProfile::Point TrafficProfile::at(double t) const {
+    Point pt;
+    if (phases_.empty() || t >= duration() || t < 0) {
+        pt.done = !phases_.empty() && t >= duration();
+        return pt;
+    }
+    size_t i = 0;
+    while (i + 1 < phases_.size() && t >= starts_[i + 1]) ++i;
+    const Phase& p = phases_[i];
+    const double x = t - starts_[i];
+    switch (p.kind) {
+    case PhaseKind::Constant:
+    case PhaseKind::Warmup:
+        pt.pps = p.pps;
+        break;
+    case PhaseKind::Poisson:
+        pt.pps = p.pps;
+        pt.poisson = true;
+        break;
+    case PhaseKind::Ramp:
+        pt.pps = p.pps + (p.pps_end - p.pps) * (x / p.seconds);
+        break;
+    case PhaseKind::Step: {
+        const unsigned level = std::min(p.steps - 1, static_cast<unsigned>(x / p.seconds * p.steps));
+        pt.pps = p.steps > 1 ? p.pps + (p.pps_end - p.pps) * level / (p.steps - 1) : p.pps;
+        break;
+    }
+    case PhaseKind::OnOff:
+        pt.pps = std::fmod(x, p.on_s + p.off_s) < p.on_s ? p.pps : 0;
+        break;
+    }
+    pt.warmup = p.kind == PhaseKind::Warmup;
+    return pt;
+}
+ 
+std::string TrafficProfile::to_string() const {
+    std::ostringstream oss;
+    oss.precision(15);
+    for (size_t i=0; i<phases_.size(); ++i) {
+        const Phase& p = phases_[i];
+        if (i) oss << ",";
+        oss << kind_name(p.kind) << ":" << p.pps;
+        if (p.kind == PhaseKind::Ramp || p.kind == PhaseKind::Step) oss << ":" << p.pps_end;
+        if (p.kind == PhaseKind::Step) oss << ":" << p.steps;
+        if (p.kind == PhaseKind::OnOff) oss << ":" << p.on_s << ":" << p.off_s;
+        oss << ":" << p.seconds;
+    }
+    return oss.str();
+}
+ 
+} // namespace udp
@@ -0,0 +1,92 @@
+/**
+* @file
+* @brief WaitStrategy implementation: socket preparation, fallbacks and the backoff slow path.
+*/
+#include "udp/wait_strategy.hpp"
+#include <iostream>
+#include <sched.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+ 
+namespace udp {
+ 
+/// \copydoc udp::parse_wait
+bool parse_wait(const std::string& name, WaitKind& out) {
+    if (name == "spin") { out = WaitKind::Spin; return true; }
+    if (name == "spin-yield") { out = WaitKind::SpinYield; return true; }
+    if (name == "spin-epoll") { out = WaitKind::SpinEpoll; return true; }
+    if (name == "block") { out = WaitKind::Block; return true; }
+    return false;
+}
+ 
+/// \copydoc udp::wait_name
+const char* wait_name(WaitKind kind) {
+    switch (kind) {
+    case WaitKind::Spin:      return "spin";
+    case WaitKind::SpinYield: return "spin-yield";
+    case WaitKind::SpinEpoll: return "spin-epoll";
+    case WaitKind::Block:     return "block";
+    }
+    return "?";
+}
+ 
+/**
+* @brief Prepare @p sock for the requested policy, degrading when it cannot.
+*
+* @details Block needs @ref ISocket::set_recv_wait; SpinEpoll needs a pollable
+* @ref ISocket::wait_fd. Each failure is reported once and falls back one step.
+*/
+WaitStrategy::WaitStrategy(ISocket& sock, const WaitConfig& cfg)
+: sock_(sock), cfg_(cfg), kind_(cfg.kind) {
+    if (cfg_.timeout_ms <= 0) cfg_.timeout_ms = 1;
+    if (kind_ == WaitKind::Block && !sock_.set_recv_wait(cfg_.timeout_ms)) {
+        std::cerr << "[wait] blocking receive unsupported by this socket, using spin-epoll\n";
+        kind_ = WaitKind::SpinEpoll;
+    }
+    if (kind_ == WaitKind::SpinEpoll) {
+#if defined(__linux__)
+        const int fd = sock_.wait_fd();
+        if (fd >= 0) epfd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd_ >= 0) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                ::close(epfd_);
+                epfd_ = -1;
+            }
+        }
+#endif
+        if (epfd_ < 0) {
+            std::cerr << "[wait] socket is not pollable, using spin-yield\n";
+            kind_ = WaitKind::SpinYield;
+        }
+    }
+}
+ 
+WaitStrategy::~WaitStrategy() {
+    if (kind_ == WaitKind::Block) sock_.set_recv_wait(0);
+    if (epfd_ >= 0) ::close(epfd_);
+}
+ 
+/**
+* @brief Spin budget exhausted: yield the core, or sleep until the socket is readable.
+*
+* @details The epoll sleep is bounded by `timeout_ms` so the owning loop still
+* notices a stop request. The spin budget is re-armed after each sleep so a burst
+* that follows is received without further sleeps.
+*/
+void WaitStrategy::backoff() {
+#if defined(__linux__)
+    if (kind_ == WaitKind::SpinEpoll) {
+        epoll_event ev;
+        epoll_wait(epfd_, &ev, 1, cfg_.timeout_ms);
+        empty_ = 0;
+        return;
+    }
+#endif
+    sched_yield();
+}
+ 
+} // namespace udp
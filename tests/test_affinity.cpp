@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "udp/affinity.hpp"
+#include "udp/packet_pool.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+ 
+using namespace udp;
+ 
+TEST(Affinity, ParsesKernelCpuLists) {
+    EXPECT_EQ(parse_cpu_list("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_EQ(parse_cpu_list("0-1\n"), (std::vector<int>{0, 1}));
+    EXPECT_TRUE(parse_cpu_list("").empty());
+    EXPECT_TRUE(parse_cpu_list("3-1").empty());
+    EXPECT_TRUE(parse_cpu_list("a,b").empty());
+    EXPECT_TRUE(parse_cpu_list("1:2").empty());
+}
+ 
+TEST(Affinity, AllowedCpusMapToOnlineNodes) {
+    const std::vector<int> nodes = numa_nodes();
+    if (nodes.empty()) GTEST_SKIP() << "no NUMA topology in sysfs";
+    for (int cpu : allowed_cpus()) {
+        const int node = cpu_numa_node(cpu);
+        ASSERT_NE(std::find(nodes.begin(), nodes.end(), node), nodes.end()) << "cpu " << cpu;
+        const std::vector<int> cpus = node_cpus(node);
+        EXPECT_NE(std::find(cpus.begin(), cpus.end(), cpu), cpus.end());
+    }
+    EXPECT_TRUE(node_cpus(-1).empty());
+    EXPECT_EQ(cpu_numa_node(-1), -1);
+}
+ 
+TEST(Affinity, VirtualOrUnknownInterfacesHaveNoNode) {
+    EXPECT_EQ(nic_numa_node("lo"), -1);
+    EXPECT_EQ(nic_numa_node("no-such-if0"), -1);
+    EXPECT_EQ(nic_numa_node("../../devices"), -1);
+    EXPECT_EQ(nic_numa_node(""), -1);
+}
+ 
+TEST(Affinity, NodeLocalMemoryIsZeroedAndUsable) {
+    const std::vector<int> nodes = numa_nodes();
+    const int node = nodes.empty() ? -1 : nodes.front();
+    const size_t bytes = 3 * 4096 + 100;
+    auto* p = static_cast<uint8_t*>(alloc_on_node(bytes, node));
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+    EXPECT_TRUE(std::all_of(p, p + bytes, [](uint8_t b) { return b == 0; }));
+    p[bytes - 1] = 0xAB;
+    free_on_node(p, bytes);
+ 
+    if (node >= 0) { EXPECT_TRUE(pin_current_thread_to_node(node)); }
+    EXPECT_FALSE(pin_current_thread_to_node(100000));
+}
+ 
+TEST(Affinity, FifoRejectsOutOfRangePriorities) {
+    errno = 0;
+    EXPECT_FALSE(set_current_thread_fifo(0));
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_FALSE(set_current_thread_fifo(100));
+}
+ 
+TEST(PacketPool, PlacedOnRequestedNode) {
+    const std::vector<int> nodes = numa_nodes();
+    if (nodes.empty()) GTEST_SKIP() << "no NUMA topology in sysfs";
+    PacketPool pool(64, 2048, false, nodes.front());
+    EXPECT_EQ(pool.node(), nodes.front());
+    EXPECT_NE(pool.to_string().find("node="), std::string::npos);
+    PacketHandle h = pool.alloc();
+    ASSERT_TRUE(h);
+    EXPECT_EQ(h.data()[0], 0u);
+ 
+    PacketPool anywhere(64, 2048, false);
+    EXPECT_EQ(anywhere.node(), -1);
+}
@@ -1,6 +1,16 @@
 #include <gtest/gtest.h>
 #include "udp/client.hpp"
 #include "udp/socket.hpp"
+#include "udp/affinity.hpp"
+#include "udp/tx_template.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
  
 using namespace udp;
  
@@ -17,4 +27,190 @@ TEST(Client, SendsSomething) {
     // Not directly observable from MockSocket since we moved it;
     // This test ensures start/stop paths are covered.
     SUCCEED();
-}
\ No newline at end of file
+}
+ 
+TEST(Client, ZeroCopyCompletionsReachStats) {
+    auto rx = std::make_unique<UdpSocket>(16);
+    rx->bind(0, false);
+ 
+    auto tx = std::make_unique<UdpSocket>(16);
+    if (!tx->set_zerocopy(true)) GTEST_SKIP() << "MSG_ZEROCOPY not supported";
+    tx->set_zerocopy(false); // the client enables it itself
+ 
+    ClientConfig cfg;
+    cfg.port = local_port(*rx);
+    cfg.pps = 20000;
+    cfg.seconds = 1;
+    cfg.batch = 16;
+    cfg.payload = 4096;
+    cfg.zerocopy = true;
+    UdpClient c(std::move(tx), cfg);
+    c.start();
+    c.join();
+ 
+    // Every issued send is accounted exactly once, either as zero-copy or copied.
+    EXPECT_GT(c.stats().sent(), 0u);
+    EXPECT_EQ(c.stats().zc_sends() + c.stats().zc_copied(), c.stats().sent());
+}
+ 
+TEST(TxTemplate, FormatsOnceAndPatchesOnlySeqAndTimestamp) {
+    PacketPool pool(4, 128, false);
+    PacketSlab slab(pool, 4);
+    TxTemplate tpl(slab, 100, 0x5A);
+    EXPECT_EQ(tpl.capacity(), 4u);
+    EXPECT_EQ(tpl.stamp(3, 7, 1234), 10u);
+    ASSERT_EQ(slab.size(), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(slab[i].len, 100u);
+        PacketHeader h;
+        std::memcpy(&h, slab[i].data, sizeof(h));
+        EXPECT_EQ(h.seq, 7 + i);
+        EXPECT_EQ(h.send_ts_ns, 1234u);
+        EXPECT_EQ(h.magic, kMagic);
+        EXPECT_EQ(slab[i].data[99], 0x5A);
+    }
+    slab[1].data[50] = 0; // payload is left alone by later stamps
+    tpl.stamp(4, 10, 99);
+    EXPECT_EQ(slab.size(), 4u);
+    EXPECT_EQ(slab[1].data[50], 0);
+}
+ 
+TEST(Client, SendsPrebuiltDatagramsWithConsecutiveSequences) {
+    auto ms = std::make_unique<MockSocket>();
+    MockSocket* mock = ms.get(); // read after stop() only
+    ClientConfig cfg;
+    cfg.pps = 2000;
+    cfg.seconds = 1;
+    cfg.batch = 8;
+    cfg.payload = 48;
+    UdpClient c(std::move(ms), cfg);
+    c.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    c.stop();
+    ASSERT_GE(mock->sent_count(), 8u);
+    ASSERT_EQ(mock->sent_count(), c.stats().sent());
+    for (size_t i = 0; i < mock->sent_count(); ++i) {
+        const std::vector<uint8_t>& d = mock->sent()[i];
+        ASSERT_EQ(d.size(), 48u);
+        PacketHeader h;
+        std::memcpy(&h, d.data(), sizeof(h));
+        EXPECT_EQ(h.seq, i + 1);
+        EXPECT_EQ(h.magic, kMagic);
+        EXPECT_GT(h.send_ts_ns, 0u);
+    }
+}
+ 
+TEST(Client, ThreadsSplitTheRateAndOwnTheirSockets) {
+    ClientConfig cfg;
+    cfg.pps = 1000;
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (int i = 0; i < 3; ++i) socks.push_back(std::make_unique<MockSocket>());
+    UdpClient c(std::move(socks), cfg);
+    ASSERT_EQ(c.threads(), 3u);
+    EXPECT_EQ(c.thread_pps(0), 334u);
+    EXPECT_EQ(c.thread_pps(1), 333u);
+    EXPECT_EQ(c.thread_pps(2), 333u);
+    if (!allowed_cpus().empty()) { EXPECT_GE(c.thread_cpu(2), 0); } // several senders are pinned
+}
+ 
+TEST(Client, ThreadsSendIndependentSequencesFromOwnPorts) {
+    UdpSocket rx(64);
+    rx.bind(0, false);
+    rx.set_rcvbuf(1 << 20);
+ 
+    ClientConfig cfg;
+    cfg.port = local_port(rx);
+    cfg.pps = 6000;
+    cfg.seconds = 1;
+    cfg.batch = 10;
+    cfg.payload = 64;
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (int i = 0; i < 3; ++i) socks.push_back(std::make_unique<UdpSocket>(16));
+    UdpClient c(std::move(socks), cfg);
+ 
+    std::map<uint16_t, std::vector<uint64_t>> seqs; // source port -> sequence numbers
+    std::atomic<bool> done{false};
+    std::thread drain([&] {
+        PacketSlab in(64, 2048);
+        int quiet = 0;
+        while (!done || quiet < 50) {
+            ssize_t r = rx.recv_batch(in);
+            if (r <= 0) {
+                ++quiet;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            quiet = 0;
+            for (ssize_t i = 0; i < r; ++i) {
+                PacketHeader h;
+                std::memcpy(&h, in[i].data, sizeof(h));
+                seqs[ntohs(in[i].addr.sin_port)].push_back(h.seq);
+            }
+        }
+    });
+    c.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    c.stop();
+    done = true;
+    drain.join();
+ 
+    ASSERT_EQ(seqs.size(), 3u);
+    uint64_t total = 0;
+    for (const auto& [port, got] : seqs) {
+        ASSERT_FALSE(got.empty());
+        for (size_t i = 0; i < got.size(); ++i) ASSERT_EQ(got[i], i + 1) << "port " << port;
+        total += got.size();
+    }
+    EXPECT_EQ(total, c.stats().sent());
+    uint64_t shards = 0;
+    for (size_t t = 0; t < c.threads(); ++t) shards += c.thread_stats(t).sent();
+    EXPECT_EQ(shards, c.stats().sent());
+}
+ 
+TEST(Client, ClosedLoopMatchesEchoesAndMeasuresRtt) {
+    UdpSocket echo(64);
+    echo.bind(0, false);
+ 
+    std::atomic<bool> done{false};
+    std::thread echoer([&] {
+        PacketSlab in(64, 2048);
+        bool junk_sent = false;
+        while (!done) {
+            if (echo.recv_batch(in) <= 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            echo.send_batch(in, nullptr);
+            if (!junk_sent) { // one foreign datagram: must be counted as unmatched
+                std::vector<std::vector<uint8_t>> junk(1, std::vector<uint8_t>(8, 0xEE));
+                echo.send_batch(junk, &in[0].addr);
+                junk_sent = true;
+            }
+        }
+    });
+ 
+    ClientConfig cfg;
+    cfg.port = local_port(echo);
+    cfg.pps = 2000;
+    cfg.seconds = 1;
+    cfg.batch = 8;
+    cfg.rtt = true;
+    UdpClient c(std::make_unique<UdpSocket>(16), cfg);
+    c.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    c.stop();
+    done = true;
+    echoer.join();
+ 
+    const uint64_t sent = c.stats().sent();
+    ASSERT_GT(sent, 100u);
+    EXPECT_EQ(c.echoes(), sent);
+    EXPECT_EQ(c.unmatched_echoes(), 1u);
+    LatencyHistogram raw = c.rtt(), co = c.rtt_corrected();
+    EXPECT_EQ(raw.count(), sent);
+    EXPECT_GT(raw.percentile(50), 0u);
+    // One packet per send: the intended time never follows the actual send time.
+    EXPECT_GE(co.max(), raw.max());
+    EXPECT_GT(c.achieved_pps(), 0.0);
+    EXPECT_NE(c.summary().find(" rtt_us p50="), std::string::npos);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "udp/pacer.hpp"
+#include "udp/common.hpp"
+ 
+using namespace udp;
+ 
+TEST(Pacer, CatchUpNamesRoundTrip) {
+    for (CatchUp c : {CatchUp::Burst, CatchUp::Cap, CatchUp::Skip}) {
+        CatchUp parsed = CatchUp::Burst;
+        ASSERT_TRUE(parse_catch_up(catch_up_name(c), parsed));
+        EXPECT_EQ(parsed, c);
+    }
+    CatchUp untouched = CatchUp::Skip;
+    EXPECT_FALSE(parse_catch_up("drop", untouched));
+    EXPECT_EQ(untouched, CatchUp::Skip);
+}
+ 
+TEST(Pacer, AutoChunkIsTenMicrosecondsOfTraffic) {
+    EXPECT_EQ(Pacer::auto_chunk(1000, 64), 1u);
+    EXPECT_EQ(Pacer::auto_chunk(100'000, 64), 1u);
+    EXPECT_EQ(Pacer::auto_chunk(1'000'000, 64), 10u);
+    EXPECT_EQ(Pacer::auto_chunk(100'000'000, 64), 64u);
+    PacerConfig cfg;
+    cfg.chunk = 100;
+    cfg.max_chunk = 16;
+    Pacer p(cfg);
+    EXPECT_EQ(p.chunk(), 16u);
+}
+ 
+TEST(Pacer, HoldsTheRateInChunks) {
+    PacerConfig cfg;
+    cfg.pps = 20'000;
+    cfg.chunk = 4;
+    Pacer p(cfg);
+    const uint64_t t0 = now_ns();
+    p.start(t0);
+    uint64_t sent = 0;
+    while (now_ns() - t0 < 50'000'000ull) {
+        const size_t n = p.wait();
+        EXPECT_GE(n, 4u);
+        sent += n;
+    }
+    // One packet per 50 µs; a loaded machine may end up behind, never ahead.
+    const uint64_t due = (now_ns() - t0) / 50'000 + 1;
+    EXPECT_LE(sent, due + 4u);
+    EXPECT_GE(sent + p.skipped(), 900u);
+    EXPECT_GT(p.error().count(), 0u);
+}
+ 
+TEST(Pacer, CatchUpPolicies) {
+    // Start 10 ms in the past at 100 kpps: ~1000 packets owed at the first wake-up.
+    auto first = [](CatchUp c, uint64_t& skipped) {
+        PacerConfig cfg;
+        cfg.pps = 100'000;
+        cfg.max_chunk = 64;
+        cfg.catch_up = c;
+        Pacer p(cfg);
+        p.start(now_ns() - 10'000'000ull);
+        const size_t n = p.wait();
+        skipped = p.skipped();
+        EXPECT_GE(p.error().max(), 10'000'000ull - 1'000'000ull); // measured from the oldest sent slot
+        return n;
+    };
+    uint64_t skipped = 0;
+    EXPECT_EQ(first(CatchUp::Burst, skipped), 64u);
+    EXPECT_EQ(skipped, 0u);
+    EXPECT_EQ(first(CatchUp::Cap, skipped), 64u);
+    EXPECT_GE(skipped, 1000u - 64u);
+    EXPECT_EQ(first(CatchUp::Skip, skipped), 1u);
+    EXPECT_GE(skipped, 999u);
+}
+ 
+TEST(Pacer, PausedRateReleasesNothing) {
+    PacerConfig cfg;
+    cfg.pps = 0;
+    Pacer p(cfg);
+    p.start(now_ns());
+    const uint64_t t0 = now_ns();
+    EXPECT_EQ(p.wait(), 0u);
+    EXPECT_LT(now_ns() - t0, 50'000'000ull);
+    p.set_rate(1'000'000);
+    EXPECT_GE(p.wait(), 10u);
+}
+ 
+TEST(Pacer, PoissonGapsKeepTheMeanRate) {
+    PacerConfig cfg;
+    cfg.pps = 20'000;
+    cfg.chunk = 1;
+    cfg.poisson = true;
+    Pacer p(cfg);
+    const uint64_t t0 = now_ns();
+    p.start(t0);
+    uint64_t sent = 0;
+    while (now_ns() - t0 < 100'000'000ull) sent += p.wait();
+    // ~2000 arrivals expected (sd ~45); a loaded machine may fall behind, never ahead.
+    EXPECT_LT(sent, 2300u);
+    EXPECT_GT(sent + p.skipped(), 1700u);
+}
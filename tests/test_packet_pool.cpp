@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "udp/packet_pool.hpp"
+#include "udp/packet_slab.hpp"
+#include "udp/ring.hpp"
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+ 
+using namespace udp;
+ 
+TEST(PacketPool, HandsOutAlignedSlotsUntilExhausted) {
+    PacketPool pool(8, 1500, false);
+    EXPECT_EQ(pool.backing(), PoolBacking::Pages);
+    EXPECT_EQ(pool.slot_size(), 1536u);
+    EXPECT_GE(pool.slots(), 8u); // page rounding slack becomes extra slots
+    EXPECT_EQ(pool.bytes() % pool.page_size(), 0u);
+ 
+    std::vector<PacketHandle> held;
+    std::set<uint8_t*> seen;
+    for (size_t i = 0; i < pool.slots(); ++i) {
+        held.push_back(pool.alloc());
+        ASSERT_TRUE(held.back());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(held.back().data()) % 64, 0u);
+        seen.insert(held.back().data());
+    }
+    EXPECT_EQ(seen.size(), pool.slots());
+    EXPECT_EQ(pool.in_use(), pool.slots());
+    EXPECT_FALSE(pool.alloc());
+    EXPECT_EQ(pool.alloc_failures(), 1u);
+ 
+    held.clear();
+    EXPECT_EQ(pool.in_use(), 0u);
+    EXPECT_TRUE(pool.alloc());
+}
+ 
+TEST(PacketPool, LastHandleReturnsTheSlot) {
+    PacketPool pool(1, 2048, false);
+    PacketHandle a = pool.alloc();
+    std::memset(a.data(), 0xAB, 16);
+    PacketHandle b = a;
+    EXPECT_EQ(a.use_count(), 2u);
+    EXPECT_EQ(b.data(), a.data());
+    a.reset();
+    EXPECT_FALSE(a);
+    EXPECT_EQ(b.use_count(), 1u);
+    EXPECT_EQ(pool.in_use(), 1u);
+    PacketHandle c = std::move(b);
+    EXPECT_FALSE(b);
+    EXPECT_EQ(c.data()[15], 0xAB);
+    c = PacketHandle();
+    EXPECT_EQ(pool.in_use(), 0u);
+}
+ 
+TEST(PacketPool, HugepageRequestFallsBackAndStaysUsable) {
+    PacketPool pool(64, 2048);
+    // Whatever the host offers, the mapping is page-rounded and fully usable.
+    if (pool.backing() != PoolBacking::Pages) {
+        EXPECT_EQ(pool.page_size(), PacketPool::kHugePage);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.alloc().data()) % PacketPool::kHugePage, 0u);
+    }
+    EXPECT_EQ(pool.bytes() % pool.page_size(), 0u);
+    EXPECT_EQ(pool.slots(), pool.bytes() / 2048);
+    EXPECT_FALSE(pool.to_string().empty());
+}
+ 
+TEST(PacketPool, SlabBorrowsAdjacentSlots) {
+    PacketPool pool(16, 2048, false);
+    {
+        PacketSlab slab(pool, 4);
+        EXPECT_EQ(pool.in_use(), 4u);
+        EXPECT_EQ(slab.slot_size(), 2048u);
+        for (size_t i = 1; i < 4; ++i) EXPECT_EQ(slab.slot(i), slab.slot(i - 1) + 2048);
+        EXPECT_EQ(slab[2].data, slab.slot(2));
+    }
+    EXPECT_EQ(pool.in_use(), 0u);
+    PacketPool tiny(1, 64, false);
+    EXPECT_THROW(PacketSlab(tiny, tiny.slots() + 1), std::bad_alloc);
+    EXPECT_EQ(tiny.in_use(), 0u);
+}
+ 
+// Handles cross threads through a ring and are released on the consumer side.
+TEST(PacketPool, HandlesCrossThreadsWithoutCopies) {
+    PacketPool pool(64, 256, false);
+    SpscRing<PacketHandle*> ring(16);
+    constexpr int kCount = 20000;
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i) {
+            PacketHandle h;
+            while (!(h = pool.alloc())) std::this_thread::yield();
+            std::memcpy(h.data(), &i, sizeof(i));
+            auto* moved = new PacketHandle(std::move(h));
+            while (!ring.push(moved)) std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < kCount; ++i) {
+        PacketHandle* h = nullptr;
+        while (!ring.pop(h)) std::this_thread::yield();
+        int v;
+        std::memcpy(&v, h->data(), sizeof(v));
+        ASSERT_EQ(v, i);
+        delete h;
+    }
+    producer.join();
+    EXPECT_EQ(pool.in_use(), 0u);
+}
+ 
+TEST(PacketPool, ConcurrentAllocAndReleaseKeepCountsConsistent) {
+    PacketPool pool(32, 128, false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 20000; ++i) {
+                PacketHandle a = pool.alloc(), b = pool.alloc();
+                if (a && b) { ASSERT_NE(a.data(), b.data()); }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(pool.in_use(), 0u);
+    std::set<uint8_t*> seen;
+    std::vector<PacketHandle> all;
+    while (PacketHandle h = pool.alloc()) {
+        seen.insert(h.data());
+        all.push_back(std::move(h));
+    }
+    EXPECT_EQ(seen.size(), pool.slots()); // free list intact: every slot exactly once
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "udp/ring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+ 
+using namespace udp;
+ 
+TEST(SpscRing, FifoWithinRoundedCapacity) {
+    SpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(99));
+    EXPECT_EQ(ring.size(), 4u);
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.pop(v));
+    EXPECT_EQ(ring.size(), 0u);
+}
+ 
+TEST(SpscRing, HandsOffAcrossThreadsInOrder) {
+    SpscRing<uint64_t> ring(64);
+    constexpr uint64_t kCount = 200000;
+    std::thread producer([&] {
+        for (uint64_t i = 1; i <= kCount; ++i) {
+            while (!ring.push(i)) std::this_thread::yield();
+        }
+    });
+    uint64_t expect = 1, v = 0;
+    while (expect <= kCount) {
+        if (!ring.pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(v, expect);
+        expect++;
+    }
+    producer.join();
+}
+ 
+TEST(SpscRing, BatchOpsStopAtBoundsAndWrap) {
+    SpscRing<int> ring(8);
+    int in[6] = {0, 1, 2, 3, 4, 5}, out[8] = {};
+    EXPECT_EQ(ring.push_n(in, 6), 6u);
+    EXPECT_EQ(ring.pop_n(out, 4), 4u);
+    EXPECT_EQ(ring.push_n(in, 6), 6u); // wraps past the end of the array
+    EXPECT_EQ(ring.push_n(in, 6), 0u); // full
+    EXPECT_EQ(ring.pop_n(out, 8), 8u);
+    const int expect[8] = {4, 5, 0, 1, 2, 3, 4, 5};
+    EXPECT_TRUE(std::equal(out, out + 8, expect));
+    EXPECT_EQ(ring.pop_n(out, 8), 0u);
+}
+ 
+TEST(MpmcRing, FifoWithinRoundedCapacity) {
+    MpmcRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, out[10] = {};
+    EXPECT_EQ(ring.push_n(in, 10), 8u);
+    EXPECT_EQ(ring.size(), 8u);
+    EXPECT_FALSE(ring.push(42));
+    EXPECT_EQ(ring.pop_n(out, 10), 8u);
+    EXPECT_TRUE(std::equal(out, out + 8, in));
+    int v = -1;
+    EXPECT_FALSE(ring.pop(v));
+    EXPECT_TRUE(ring.push(42)); // slots are reusable after a full lap
+    ASSERT_TRUE(ring.pop(v));
+    EXPECT_EQ(v, 42);
+}
+ 
+// Stress tests: meant to run under ThreadSanitizer (configure with -DENABLE_TSAN=ON).
+ 
+TEST(RingStress, SpscBatchesArriveOnceAndInOrder) {
+    SpscRing<uint64_t> ring(32);
+    constexpr uint64_t kCount = 100000;
+    std::thread producer([&] {
+        uint64_t next = 1, chunk[7];
+        while (next <= kCount) {
+            size_t n = 0;
+            for (; n < 7 && next + n <= kCount; ++n) chunk[n] = next + n;
+            size_t done = 0;
+            while (done < n) {
+                done += ring.push_n(chunk + done, n - done);
+                if (done < n) std::this_thread::yield();
+            }
+            next += n;
+        }
+    });
+    uint64_t expect = 1, got[5];
+    while (expect <= kCount) {
+        const size_t n = ring.pop_n(got, 5);
+        if (!n) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(got[i], expect++);
+    }
+    producer.join();
+    EXPECT_EQ(ring.size(), 0u);
+}
+ 
+TEST(RingStress, MpmcDeliversEveryItemExactlyOnce) {
+    constexpr unsigned kProducers = 4, kConsumers = 4;
+    constexpr uint64_t kPerProducer = 20000;
+    MpmcRing<uint64_t> ring(64);
+    std::atomic<uint64_t> consumed{0};
+    std::vector<std::vector<uint64_t>> seen(kConsumers);
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                // Producer id in the top bits, sequence below.
+                while (!ring.push((uint64_t(p) << 32) | i)) std::this_thread::yield();
+            }
+        });
+    }
+    for (unsigned c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&, c] {
+            uint64_t v;
+            while (consumed.load(std::memory_order_relaxed) < kProducers * kPerProducer) {
+                if (ring.pop(v)) {
+                    seen[c].push_back(v);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+ 
+    std::vector<uint64_t> count(kProducers * kPerProducer, 0);
+    for (const auto& s : seen) {
+        std::vector<int64_t> last(kProducers, -1);
+        for (uint64_t v : s) {
+            const unsigned p = static_cast<unsigned>(v >> 32);
+            const int64_t i = static_cast<int64_t>(v & 0xffffffffu);
+            ASSERT_LT(p, kProducers);
+            EXPECT_GT(i, last[p]); // per-producer order holds within each consumer
+            last[p] = i;
+            count[p * kPerProducer + static_cast<uint64_t>(i)]++;
+        }
+    }
+    EXPECT_EQ(std::count(count.begin(), count.end(), 1u), static_cast<std::ptrdiff_t>(count.size()));
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "udp/seq_window.hpp"
+ 
+using namespace udp;
+ 
+static SeqCounts feed(SeqWindow& w, std::initializer_list<uint64_t> seqs) {
+    SeqCounts d;
+    for (uint64_t s : seqs) w.observe(s, d);
+    return d;
+}
+ 
+TEST(SeqWindow, InOrderCountsNothing) {
+    SeqWindow w;
+    SeqCounts d;
+    for (uint64_t s = 1; s <= 5000; ++s) w.observe(s, d);
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(w.top(), 5000u);
+}
+ 
+TEST(SeqWindow, GapIsLostUntilTheLateDatagramArrives) {
+    SeqWindow w;
+    SeqCounts d = feed(w, {1, 2, 5, 6});
+    EXPECT_EQ(d.lost, 2);
+    EXPECT_EQ(w.lost(), 2u);
+    d = feed(w, {3});
+    EXPECT_EQ(d.lost, -1);
+    EXPECT_EQ(d.reordered, 1u);
+    EXPECT_EQ(w.lost(), 1u);
+}
+ 
+TEST(SeqWindow, DuplicatesInsideTheWindow) {
+    SeqWindow w;
+    const SeqCounts d = feed(w, {1, 2, 2, 3, 1, 3});
+    EXPECT_EQ(d.duplicate, 3u);
+    EXPECT_EQ(d.reordered, 0u);
+    EXPECT_EQ(d.lost, 0);
+}
+ 
+TEST(SeqWindow, SlidingClearsOldBits) {
+    SeqWindow w;
+    // Sequence 10 and 10 + kBits share a bit; the slide must clear it.
+    SeqCounts d = feed(w, {10, 10 + SeqWindow::kBits - 1});
+    EXPECT_EQ(d.lost, static_cast<int64_t>(SeqWindow::kBits - 2));
+    d = feed(w, {10 + SeqWindow::kBits, 9 + SeqWindow::kBits / 2});
+    EXPECT_EQ(d.duplicate, 0u);
+    EXPECT_EQ(d.reordered, 1u);
+    // Behind the window: assumed to be a late original, not a duplicate.
+    d = feed(w, {10});
+    EXPECT_EQ(d.reordered, 1u);
+    EXPECT_EQ(d.duplicate, 0u);
+    // A jump further than the window forgets everything remembered.
+    d = feed(w, {100'000, 100'000 - 5});
+    EXPECT_EQ(d.reordered, 1u);
+}
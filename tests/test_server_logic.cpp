@@ -2,7 +2,10 @@
 #include "udp/server.hpp"
 #include "udp/socket.hpp"
 #include "udp/common.hpp"
+#include "udp/affinity.hpp"
+#include <algorithm>
 #include <thread>
+#include <arpa/inet.h>
  
 using namespace udp;
  
@@ -31,4 +34,438 @@ TEST(Server, ReceivesAndEchoes) {
     srv.stop();
     SUCCEED();
 }
- 
\ No newline at end of file
+  
+TEST(Server, AdmissionCapAndEchoUseSlabAddresses) {
+    auto ms = std::make_unique<MockSocket>();
+    MockSocket* mock = ms.get(); // owned by the server below; used before start/after stop only
+ 
+    std::vector<uint8_t> pkt(sizeof(PacketHeader) + 8, 0);
+    auto* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+    hdr->seq = 1; hdr->send_ts_ns = now_ns(); hdr->magic = kMagic;
+    for (uint16_t port : {1000, 1001, 1000, 1002}) {
+        sockaddr_in from{};
+        from.sin_family = AF_INET;
+        from.sin_addr.s_addr = htonl(0x7f000001);
+        from.sin_port = htons(port);
+        mock->preload_recv(pkt, from);
+    }
+ 
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.echo = true;
+    cfg.verbose = false;
+    cfg.max_clients = 2;
+    UdpServer srv(std::move(ms), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    // Port 1002 is a third client and must be dropped.
+    EXPECT_EQ(srv.stats().recv(), 3u);
+    EXPECT_EQ(srv.stats().unique_clients(), 2u);
+    ASSERT_EQ(mock->sent_count(), 3u);
+    EXPECT_EQ(ntohs(mock->sent_addrs()[0].sin_port), 1000);
+    EXPECT_EQ(ntohs(mock->sent_addrs()[1].sin_port), 1001);
+    EXPECT_EQ(ntohs(mock->sent_addrs()[2].sin_port), 1000);
+    EXPECT_EQ(mock->sent()[0].size(), pkt.size());
+}
+ 
+TEST(Server, AdmissionCountsAClientOnceAcrossWorkers) {
+    std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+    auto* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+    hdr->seq = 1; hdr->magic = kMagic;
+    auto from = [](uint16_t port) {
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(0x7f000001);
+        a.sin_port = htons(port);
+        return a;
+    };
+    // Client 3000 reaches both workers (as a migrating flow can under Steering::Cpu).
+    auto a = std::make_unique<MockSocket>();
+    auto b = std::make_unique<MockSocket>();
+    a->preload_recv(pkt, from(3000));
+    b->preload_recv(pkt, from(3000));
+    b->preload_recv(pkt, from(3001));
+    std::vector<std::unique_ptr<ISocket>> socks;
+    socks.push_back(std::move(a));
+    socks.push_back(std::move(b));
+ 
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.max_clients = 2;
+    UdpServer srv(std::move(socks), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    EXPECT_EQ(srv.stats().recv(), 3u);
+    EXPECT_EQ(srv.stats().unique_clients(), 2u);
+}
+ 
+TEST(Server, RejectedClientFloodLeavesAdmittedClientServed) {
+    std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+    auto* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+    hdr->magic = kMagic;
+    auto from = [](uint16_t port) {
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(0x7f000001);
+        a.sin_port = htons(port);
+        return a;
+    };
+    // Client 4000 comes first on both workers and fills the single slot; 4001 then floods both.
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (int w = 0; w < 2; ++w) {
+        auto m = std::make_unique<MockSocket>();
+        hdr->seq = 1; m->preload_recv(pkt, from(4000));
+        for (uint64_t i = 1; i <= 500; ++i) { hdr->seq = i; m->preload_recv(pkt, from(4001)); }
+        if (w == 0) { hdr->seq = 2; m->preload_recv(pkt, from(4000)); }
+        socks.push_back(std::move(m));
+    }
+ 
+    ServerConfig cfg;
+    cfg.batch = 64;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.max_clients = 1;
+    UdpServer srv(std::move(socks), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    srv.stop();
+ 
+    EXPECT_EQ(srv.stats().recv(), 3u);
+    EXPECT_EQ(srv.stats().unique_clients(), 1u);
+}
+ 
+TEST(Server, GsoEchoGroupsRepliesPerPeerInOrder) {
+    auto ms = std::make_unique<MockSocket>();
+    MockSocket* mock = ms.get();
+ 
+    std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+    uint64_t seq = 0;
+    for (uint16_t port : {2001, 2000, 2001, 2000, 2001}) {
+        auto* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+        hdr->seq = ++seq; hdr->magic = kMagic;
+        sockaddr_in from{};
+        from.sin_family = AF_INET;
+        from.sin_addr.s_addr = htonl(0x7f000001);
+        from.sin_port = htons(port);
+        mock->preload_recv(pkt, from);
+    }
+ 
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.echo = true;
+    cfg.verbose = false;
+    cfg.gso = true;
+    UdpServer srv(std::move(ms), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    ASSERT_EQ(mock->sent_count(), 5u);
+    const uint16_t want_port[] = {2000, 2000, 2001, 2001, 2001};
+    const uint64_t want_seq[]  = {2, 4, 1, 3, 5};
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(ntohs(mock->sent_addrs()[i].sin_port), want_port[i]);
+        EXPECT_EQ(reinterpret_cast<const PacketHeader*>(mock->sent()[i].data())->seq, want_seq[i]);
+    }
+}
+ 
+TEST(Server, RxTimestampsSplitQueueingFromProcessingDelay) {
+    auto ms = std::make_unique<MockSocket>();
+    MockSocket* mock = ms.get();
+ 
+    const uint64_t t0 = now_ns();
+    std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+    auto* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+    hdr->seq = 1; hdr->send_ts_ns = t0 - 5'000'000; hdr->magic = kMagic;
+    mock->preload_recv(pkt, sockaddr_in{}, t0);          // one-way latency: 5 ms
+    std::vector<uint8_t> junk(sizeof(PacketHeader), 0); // no magic: no one-way sample
+    mock->preload_recv(junk, sockaddr_in{}, t0);
+    mock->preload_recv(pkt);                            // no RX timestamp: not sampled
+ 
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    UdpServer srv(std::move(ms), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    EXPECT_EQ(srv.stats().recv(), 3u);
+    EXPECT_EQ(srv.stats().queue_delay_count(), 2u);
+    EXPECT_GT(srv.stats().queue_delay_ns(), 0u);
+    EXPECT_EQ(srv.stats().proc_delay_count(), 2u);
+    EXPECT_EQ(srv.stats().one_way_count(), 1u);
+    EXPECT_EQ(srv.stats().one_way_ns(), 5'000'000u);
+    EXPECT_GE(srv.stats().latency(Latency::RecvCall).count(), 1u);
+}
+ 
+TEST(Server, ValidatesHeadersAndTracksSequencesPerClient) {
+    auto ms = std::make_unique<MockSocket>();
+    MockSocket* mock = ms.get();
+    auto send = [&](uint16_t port, uint64_t seq, uint32_t magic) {
+        std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+        auto* hdr = reinterpret_cast<PacketHeader*>(pkt.data());
+        hdr->seq = seq; hdr->magic = magic;
+        sockaddr_in from{};
+        from.sin_family = AF_INET;
+        from.sin_addr.s_addr = htonl(0x7f000001);
+        from.sin_port = htons(port);
+        mock->preload_recv(pkt, from);
+    };
+    // Client A: 1 2 4 5 3 3 (one reordered, one duplicate, nothing lost).
+    for (uint64_t s : {1, 2, 4, 5, 3, 3}) send(5000, s, kMagic);
+    // Client B runs its own numbering: 1 2 6 (3 lost), plus a foreign datagram.
+    for (uint64_t s : {1, 2, 6}) send(5001, s, kMagic);
+    send(5001, 7, 0xdeadbeef);
+    mock->preload_recv(std::vector<uint8_t>(4, 0)); // too short for a header
+ 
+    ServerConfig cfg;
+    cfg.batch = 4;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    UdpServer srv(std::move(ms), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    const Stats st = srv.stats();
+    EXPECT_EQ(st.recv(), 11u);
+    EXPECT_EQ(st.seq_reordered(), 1u);
+    EXPECT_EQ(st.seq_duplicate(), 1u);
+    EXPECT_EQ(st.seq_lost(), 3u);
+    EXPECT_EQ(st.seq_invalid(), 2u);
+}
+ 
+TEST(Server, WorkersShareOnePortWithShardedAdmissionAndStats) {
+    constexpr size_t kWorkers = 4, kClients = 16, kPerClient = 8;
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (size_t i = 0; i < kWorkers; ++i) socks.push_back(std::make_unique<UdpSocket>(16));
+ 
+    ServerConfig cfg;
+    cfg.port = 0; // first worker picks, the others join its reuseport group
+    cfg.batch = 16;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.max_clients = 10;
+    UdpServer srv(std::move(socks), cfg);
+    ASSERT_EQ(srv.workers(), kWorkers);
+    ASSERT_NE(srv.port(), 0);
+    srv.start();
+ 
+    // Distinct source ports are distinct flows, spread over the group by the kernel.
+    std::vector<std::unique_ptr<UdpSocket>> clients;
+    std::vector<std::vector<uint8_t>> pkts(kPerClient, std::vector<uint8_t>(sizeof(PacketHeader), 0));
+    for (size_t c = 0; c < kClients; ++c) {
+        clients.push_back(std::make_unique<UdpSocket>(16));
+        clients.back()->connect("127.0.0.1", srv.port());
+        clients.back()->send_batch(pkts);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    srv.stop();
+ 
+    // Admission cap is global: 10 of the 16 clients are served, all their packets counted.
+    Stats all = srv.stats();
+    EXPECT_EQ(all.unique_clients(), 10u);
+    EXPECT_EQ(all.recv(), 10u * kPerClient);
+    size_t active = 0;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kWorkers; ++i) {
+        sum += srv.worker_stats(i).recv();
+        if (srv.worker_stats(i).recv() > 0) active++;
+    }
+    EXPECT_EQ(sum, all.recv());
+    EXPECT_GE(active, 2u);
+}
+ 
+// Start a server with `workers` reuseport sockets and the given steering, send
+// `per_client` packets from each of `clients` sockets (distinct source ports) and
+// return per-worker receive counts after stopping.
+static std::vector<uint64_t> steer_round(Steering steering, size_t workers, size_t clients, size_t per_client) {
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (size_t i = 0; i < workers; ++i) socks.push_back(std::make_unique<UdpSocket>(16));
+    ServerConfig cfg;
+    cfg.port = 0;
+    cfg.batch = 16;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.steering = steering;
+    UdpServer srv(std::move(socks), cfg);
+    srv.start();
+    std::vector<std::unique_ptr<UdpSocket>> senders;
+    std::vector<std::vector<uint8_t>> pkts(per_client, std::vector<uint8_t>(sizeof(PacketHeader), 0));
+    for (size_t c = 0; c < clients; ++c) {
+        senders.push_back(std::make_unique<UdpSocket>(16));
+        senders.back()->connect("127.0.0.1", srv.port());
+        senders.back()->send_batch(pkts);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    srv.stop();
+    std::vector<uint64_t> per_worker;
+    for (size_t i = 0; i < workers; ++i) per_worker.push_back(srv.worker_stats(i).recv());
+    EXPECT_EQ(srv.imbalance_ratio(), 1.0); // no full one-second window yet
+    return per_worker;
+}
+ 
+TEST(Server, SrcIpSteeringKeepsOneHostOnOneWorker) {
+    std::vector<uint64_t> got = steer_round(Steering::SrcIp, 4, 16, 4);
+    // Every flow comes from 127.0.0.1, so one worker takes all 64 packets.
+    EXPECT_EQ(*std::max_element(got.begin(), got.end()), 64u);
+    EXPECT_EQ(std::count(got.begin(), got.end(), 0u), 3);
+}
+ 
+TEST(Server, CpuSteeringFollowsTheSoftirqCpu) {
+    std::vector<int> cpus = allowed_cpus();
+    ASSERT_FALSE(cpus.empty());
+    // Loopback delivers on the sending CPU, so pin the sender first.
+    std::vector<uint64_t> got;
+    std::thread sender([&] {
+        ASSERT_TRUE(pin_current_thread(cpus[0]));
+        got = steer_round(Steering::Cpu, 4, 8, 4);
+    });
+    sender.join();
+    ASSERT_EQ(got.size(), 4u);
+    EXPECT_EQ(got[static_cast<size_t>(cpus[0]) % 4], 32u);
+}
+ 
+TEST(Server, PipelineAccountsForEveryDatagram) {
+    auto ms = std::make_unique<MockSocket>();
+    MockSocket* mock = ms.get(); // owned by the server below; used before start/after stop only
+    std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(0x0A000001);
+    a.sin_port = htons(4000);
+    for (int i = 0; i < 200; ++i) mock->preload_recv(pkt, a);
+ 
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.echo = true;
+    cfg.pipeline = true;
+    cfg.ring_depth = 2; // tiny pool: the RX thread may outrun processing
+    cfg.wait.kind = WaitKind::SpinYield;
+    UdpServer srv(std::move(ms), cfg);
+    ASSERT_TRUE(srv.pipelined(0));
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    // Every datagram was either processed or counted as a ring drop.
+    EXPECT_EQ(srv.stats().recv() + srv.ring_drops(0), 200u);
+    EXPECT_EQ(mock->sent_count(), srv.stats().recv());
+    EXPECT_EQ(srv.ring_occupancy(0), 0u);
+}
+ 
+TEST(Server, PipelineEchoesOverUdp) {
+    ServerConfig cfg;
+    cfg.port = 0;
+    cfg.batch = 16;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.echo = true;
+    cfg.pipeline = true;
+    cfg.ring_depth = 64;
+    cfg.wait.kind = WaitKind::SpinYield;
+    UdpServer srv(std::make_unique<UdpSocket>(16), cfg);
+    ASSERT_TRUE(srv.pipelined(0));
+    srv.start();
+ 
+    UdpSocket client(16);
+    client.connect("127.0.0.1", srv.port());
+    std::vector<std::vector<uint8_t>> pkts(64, std::vector<uint8_t>(sizeof(PacketHeader), 3));
+    ASSERT_EQ(client.send_batch(pkts), 64);
+    size_t echoed = 0;
+    PacketSlab in(16, 2048);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (echoed < 64 && std::chrono::steady_clock::now() < deadline) {
+        ssize_t r = client.recv_batch(in);
+        if (r > 0) echoed += static_cast<size_t>(r);
+        else std::this_thread::yield();
+    }
+    srv.stop();
+ 
+    EXPECT_EQ(echoed, 64u);
+    EXPECT_EQ(srv.stats().recv(), 64u);
+    EXPECT_EQ(srv.ring_drops(0), 0u);
+}
+ 
+TEST(Server, ReceiveSlabsComeFromThePacketPool) {
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.hugepages = false;
+    UdpServer inline_srv(std::make_unique<MockSocket>(), cfg);
+    EXPECT_EQ(inline_srv.pool().in_use(), 8u);
+    EXPECT_EQ(inline_srv.pool().backing(), PoolBacking::Pages);
+ 
+    cfg.pipeline = true;
+    cfg.ring_depth = 4;
+    UdpServer piped(std::make_unique<MockSocket>(), cfg);
+    EXPECT_EQ(piped.pool().in_use(), (4u + 1u) * 8u); // pooled slabs plus the spare
+    EXPECT_EQ(piped.pool().alloc_failures(), 0u);
+}
+ 
+TEST(Server, WorkersShareAPoolPerNumaNode) {
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.hugepages = false;
+    cfg.nic = "lo"; // virtual: no node, so placement falls back to the CPUs
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (int i = 0; i < 3; ++i) socks.push_back(std::make_unique<MockSocket>());
+    UdpServer srv(std::move(socks), cfg);
+    EXPECT_EQ(srv.nic_node(), -1);
+ 
+    size_t slabs = 0;
+    for (size_t k = 0; k < srv.pools(); ++k) slabs += srv.pool(k).in_use();
+    EXPECT_EQ(slabs, 3u * 8u);
+    for (size_t i = 0; i < srv.workers(); ++i) {
+        if (srv.worker_cpu(i) < 0) continue; // no affinity mask on this platform
+        EXPECT_EQ(srv.worker_node(i), cpu_numa_node(srv.worker_cpu(i)));
+        if (srv.worker_node(i) < 0) continue;
+        bool found = false;
+        for (size_t k = 0; k < srv.pools(); ++k) found |= srv.pool(k).node() == srv.worker_node(i);
+        EXPECT_TRUE(found) << "worker " << i;
+    }
+    EXPECT_LE(srv.pools(), std::max<size_t>(numa_nodes().size(), 1));
+}
+ 
+TEST(Server, ExplicitCpuListPinsEveryThread) {
+    std::vector<int> cpus = allowed_cpus();
+    ASSERT_FALSE(cpus.empty());
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.cpu_list = {cpus.back()};
+    UdpServer single(std::make_unique<MockSocket>(), cfg);
+    EXPECT_EQ(single.worker_cpu(0), cpus.back()); // pinned even as the only worker
+    EXPECT_EQ(single.worker_proc_cpu(0), -1);
+ 
+    cfg.pipeline = true;
+    cfg.ring_depth = 2;
+    cfg.cpu_list = {cpus.front(), cpus.back()};
+    std::vector<std::unique_ptr<ISocket>> socks;
+    for (int i = 0; i < 2; ++i) socks.push_back(std::make_unique<MockSocket>());
+    UdpServer piped(std::move(socks), cfg);
+    // RX, processing, RX, processing: the two-entry list wraps around.
+    for (size_t i = 0; i < 2; ++i) {
+        EXPECT_EQ(piped.worker_cpu(i), cpus.front());
+        EXPECT_EQ(piped.worker_proc_cpu(i), cpus.back());
+    }
+    piped.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    piped.stop();
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "udp/socket.hpp"
+#include "udp/common.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace udp;
+ 
+// Count every global heap allocation. This replaces operator new for the whole
+// binary, so these tests build into their own executable (alloc_tests).
+static std::atomic<size_t> g_allocs{0};
+ 
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+ 
+// Send `tx_bufs` and drain until as many datagrams arrived (loopback is fast,
+// but give the kernel a few spins before declaring a miss).
+static size_t round_trip(UdpSocket& tx, UdpSocket& rx,
+                         const std::vector<std::vector<uint8_t>>& tx_bufs,
+                         std::vector<std::vector<uint8_t>>& rx_bufs) {
+    ssize_t sent = tx.send_batch(tx_bufs);
+    size_t got = 0;
+    for (int spin = 0; spin < 100000 && got < (size_t)sent; ++spin) {
+        ssize_t r = rx.recv_batch(rx_bufs);
+        if (r > 0) got += (size_t)r;
+    }
+    return got;
+}
+ 
+TEST(UdpSocket, SteadyStateBatchIoIsAllocationFree) {
+    UdpSocket rx(8), tx(8);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+ 
+    std::vector<std::vector<uint8_t>> tx_bufs(8, std::vector<uint8_t>(64, 0x5A));
+    std::vector<std::vector<uint8_t>> rx_bufs(8, std::vector<uint8_t>(2048));
+ 
+    size_t before = g_allocs.load();
+    size_t delivered = 0;
+    for (int it = 0; it < 100; ++it) delivered += round_trip(tx, rx, tx_bufs, rx_bufs);
+    size_t after = g_allocs.load();
+ 
+    EXPECT_EQ(after - before, 0u);
+    EXPECT_EQ(delivered, 800u);
+}
+ 
+TEST(UdpSocket, RingGrowsOnceForLargerBatch) {
+    UdpSocket rx(4), tx(4);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+ 
+    std::vector<std::vector<uint8_t>> tx_bufs(32, std::vector<uint8_t>(32, 0x11));
+    std::vector<std::vector<uint8_t>> rx_bufs(32, std::vector<uint8_t>(2048));
+ 
+    EXPECT_EQ(round_trip(tx, rx, tx_bufs, rx_bufs), 32u);
+    EXPECT_EQ(rx.ring_capacity(), 32u);
+ 
+    size_t before = g_allocs.load();
+    size_t delivered = round_trip(tx, rx, tx_bufs, rx_bufs);
+    size_t after = g_allocs.load();
+    EXPECT_EQ(after - before, 0u);
+    EXPECT_EQ(delivered, 32u);
+}
+ 
+TEST(UdpSocket, SlabRoundTripIsAllocationFreeAndReportsSource) {
+    UdpSocket rx(16), tx(16);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+ 
+    PacketSlab out(16, 64), in(16, 2048);
+    for (size_t i = 0; i < out.capacity(); ++i) {
+        out[i].data[0] = static_cast<uint8_t>(i);
+        out[i].len = 64;
+    }
+    out.set_size(out.capacity());
+ 
+    size_t before = g_allocs.load();
+    size_t delivered = 0;
+    bool lengths_ok = true;
+    for (int it = 0; it < 50; ++it) {
+        ssize_t sent = tx.send_batch(out);
+        size_t got = 0;
+        for (int spin = 0; spin < 100000 && got < (size_t)sent; ++spin) {
+            ssize_t r = rx.recv_batch(in);
+            for (ssize_t i = 0; i < r; ++i) lengths_ok = lengths_ok && in[i].len == 64;
+            if (r > 0) got += (size_t)r;
+        }
+        delivered += got;
+    }
+    size_t after = g_allocs.load();
+ 
+    EXPECT_EQ(after - before, 0u);
+    EXPECT_EQ(delivered, 800u);
+    EXPECT_TRUE(lengths_ok);
+    EXPECT_EQ(ntohl(in[0].addr.sin_addr.s_addr), 0x7f000001u);
+    EXPECT_EQ(in[0].addr.sin_port, htons(local_port(tx)));
+}
+ 
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "udp/io_uring_socket.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+#include <cstring>
+ 
+using namespace udp;
+ 
+// Every test needs a kernel with multishot recvmsg + provided buffer rings.
+#define REQUIRE_IO_URING()                                   \
+    do {                                                     \
+        std::string why;                                     \
+        if (!IoUringSocket::supported(&why)) GTEST_SKIP() << why; \
+    } while (0)
+ 
+// Poll `rx` until `want` datagrams arrived or the spin budget ran out.
+static size_t drain(ISocket& rx, PacketSlab& slab, size_t want,
+                    std::vector<uint32_t>* lens = nullptr) {
+    size_t got = 0;
+    for (int spin = 0; spin < 1000000 && got < want; ++spin) {
+        ssize_t r = rx.recv_batch(slab);
+        for (ssize_t i = 0; i < r; ++i)
+            if (lens) lens->push_back(slab[i].len);
+        if (r > 0) got += (size_t)r;
+    }
+    return got;
+}
+ 
+TEST(IoUringSocket, ParseBackendNames) {
+    SocketBackend b = SocketBackend::Mmsg;
+    EXPECT_TRUE(parse_backend("io_uring", b));
+    EXPECT_EQ(b, SocketBackend::IoUring);
+    EXPECT_TRUE(parse_backend("mmsg", b));
+    EXPECT_EQ(b, SocketBackend::Mmsg);
+    EXPECT_FALSE(parse_backend("dpdk", b));
+    EXPECT_EQ(b, SocketBackend::Mmsg);
+}
+ 
+TEST(IoUringSocket, FactoryAlwaysReturnsASocket) {
+    // Falls back to UdpSocket when io_uring is unavailable.
+    auto s = create_socket(SocketBackend::IoUring, 8);
+    ASSERT_NE(s, nullptr);
+    EXPECT_GE(s->fd(), 0);
+}
+ 
+TEST(IoUringSocket, FactoryPassesSqpollThrough) {
+    REQUIRE_IO_URING();
+    auto s = create_socket(SocketBackend::IoUring, 8, true);
+    auto* u = dynamic_cast<IoUringSocket*>(s.get());
+    ASSERT_NE(u, nullptr);
+    IoUringSocket probe(8, true);
+    EXPECT_EQ(u->sqpoll(), probe.sqpoll()); // SQPOLL can be refused; the factory must still ask
+}
+ 
+TEST(IoUringSocket, MultishotReceiveCarriesLengthAndSource) {
+    REQUIRE_IO_URING();
+    IoUringSocket rx(8);
+    rx.bind(0, false);
+    UdpSocket tx(8);
+    tx.connect("127.0.0.1", local_port(rx));
+ 
+    std::vector<std::vector<uint8_t>> bufs;
+    for (size_t i = 0; i < 8; ++i) bufs.emplace_back(40 + i, uint8_t(i));
+    ASSERT_EQ(tx.send_batch(bufs), 8);
+ 
+    PacketSlab slab(8, 2048);
+    ssize_t r = 0;
+    for (int spin = 0; spin < 1000000 && r == 0; ++spin) r = rx.recv_batch(slab);
+    ASSERT_GT(r, 0);
+    EXPECT_EQ(slab[0].len, 40u);
+    EXPECT_EQ(slab[0].data[0], 0);
+    EXPECT_EQ(ntohs(slab[0].addr.sin_port), local_port(tx));
+    EXPECT_EQ(slab[0].addr.sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+ 
+    std::vector<uint32_t> lens;
+    for (ssize_t i = 0; i < r; ++i) lens.push_back(slab[i].len);
+    drain(rx, slab, 8 - (size_t)r, &lens);
+    ASSERT_EQ(lens.size(), 8u);
+    for (size_t i = 0; i < 8; ++i) EXPECT_EQ(lens[i], 40u + i);
+}
+ 
+TEST(IoUringSocket, ArmedReceiveNeedsNoSyscalls) {
+    REQUIRE_IO_URING();
+    IoUringSocket rx(16);
+    rx.bind(0, false);
+    UdpSocket tx(16);
+    tx.connect("127.0.0.1", local_port(rx));
+    std::vector<std::vector<uint8_t>> bufs(16, std::vector<uint8_t>(64, 0x11));
+    PacketSlab slab(16, 2048);
+ 
+    const uint64_t before = rx.enter_calls();
+    size_t got = 0;
+    for (int it = 0; it < 50; ++it) {
+        ASSERT_EQ(tx.send_batch(bufs), 16);
+        got += drain(rx, slab, 16);
+    }
+    EXPECT_EQ(got, 50u * 16u);
+    EXPECT_EQ(rx.enter_calls(), before);
+}
+ 
+TEST(IoUringSocket, BatchedSendUsesPerViewDestinationAndOneEnter) {
+    REQUIRE_IO_URING();
+    UdpSocket rx(8);
+    rx.bind(0, false);
+    IoUringSocket tx(8);
+ 
+    PacketSlab out(8, 64);
+    sockaddr_in dst{};
+    dst.sin_family = AF_INET;
+    dst.sin_port = htons(local_port(rx));
+    dst.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (size_t i = 0; i < 8; ++i) {
+        std::memset(out.slot(i), int(i), 32);
+        out[i].len = 32;
+        out[i].addr = dst;
+    }
+    out.set_size(8);
+ 
+    const uint64_t before = tx.enter_calls();
+    ASSERT_EQ(tx.send_batch(out), 8);
+    if (!tx.sqpoll()) { EXPECT_LE(tx.enter_calls() - before, 2u); }
+ 
+    PacketSlab in(8, 2048);
+    std::vector<uint32_t> lens;
+    EXPECT_EQ(drain(rx, in, 8, &lens), 8u);
+    for (uint32_t l : lens) EXPECT_EQ(l, 32u);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "udp/socket.hpp"
+#include <arpa/inet.h>
  
 using namespace udp;
  
@@ -16,4 +17,34 @@ TEST(MockSocket, SendAndRecv) {
     EXPECT_EQ(w, 1);
     EXPECT_EQ(s.sent_count(), 1u);
 }
- 
\ No newline at end of file
+  
+TEST(MockSocket, SlabRecvCarriesLengthAndAddress) {
+    MockSocket s;
+    sockaddr_in from{};
+    from.sin_family = AF_INET;
+    from.sin_addr.s_addr = htonl(0x7f000001);
+    from.sin_port = htons(4242);
+    s.preload_recv(std::vector<uint8_t>(40, 0xCD), from);
+    s.preload_recv(std::vector<uint8_t>(10, 0xEF), from);
+ 
+    PacketSlab slab(4, 100);
+    EXPECT_EQ(slab.slot_size() % kCacheLine, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(slab.slot(0)) % kCacheLine, 0u);
+ 
+    auto r = s.recv_batch(slab);
+    ASSERT_EQ(r, 2);
+    EXPECT_EQ(slab.size(), 2u);
+    EXPECT_EQ(slab[0].len, 40u);
+    EXPECT_EQ(slab[1].len, 10u);
+    EXPECT_EQ(slab[1].data, slab.slot(1));
+    EXPECT_EQ(slab[1].data[0], 0xEF);
+    EXPECT_EQ(ntohs(slab[0].addr.sin_port), 4242);
+ 
+    // Send back only the second packet, to the address it came from.
+    slab[0] = slab[1];
+    slab.set_size(1);
+    EXPECT_EQ(s.send_batch(slab), 1);
+    ASSERT_EQ(s.sent_count(), 1u);
+    EXPECT_EQ(s.sent()[0].size(), 10u);
+    EXPECT_EQ(ntohs(s.sent_addrs()[0].sin_port), 4242);
+}
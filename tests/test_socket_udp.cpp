@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "udp/socket.hpp"
+#include "udp/common.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+ 
+using namespace udp;
+ 
+// Send `tx_bufs` and drain until as many datagrams arrived (loopback is fast,
+// but give the kernel a few spins before declaring a miss).
+static size_t round_trip(UdpSocket& tx, UdpSocket& rx,
+                         const std::vector<std::vector<uint8_t>>& tx_bufs,
+                         std::vector<std::vector<uint8_t>>& rx_bufs) {
+    ssize_t sent = tx.send_batch(tx_bufs);
+    size_t got = 0;
+    for (int spin = 0; spin < 100000 && got < (size_t)sent; ++spin) {
+        ssize_t r = rx.recv_batch(rx_bufs);
+        if (r > 0) got += (size_t)r;
+    }
+    return got;
+}
+ 
+TEST(UdpSocket, RingsPresizedFromHint) {
+    UdpSocket s(16);
+    EXPECT_EQ(s.ring_capacity(), 16u);
+}
+ 
+TEST(UdpSocket, GsoSendIsSplitBackIntoOriginalDatagrams) {
+    UdpSocket rx(64), tx(64);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    if (!tx.set_gso(true)) GTEST_SKIP() << "UDP_SEGMENT not supported";
+ 
+    // 64 full segments followed by a short tail segment and a second run.
+    PacketSlab out(66, 256), in(66, 2048);
+    for (size_t i = 0; i < out.capacity(); ++i) {
+        out[i].data[0] = static_cast<uint8_t>(i);
+        out[i].len = i == 64 ? 100 : 200;
+    }
+    out.set_size(out.capacity());
+    ASSERT_EQ(tx.send_batch(out), 66);
+ 
+    std::vector<std::pair<uint8_t, uint32_t>> got;
+    for (int spin = 0; spin < 100000 && got.size() < 66; ++spin) {
+        ssize_t r = rx.recv_batch(in);
+        for (ssize_t i = 0; i < r; ++i) got.emplace_back(in[i].data[0], in[i].len);
+    }
+    ASSERT_EQ(got.size(), 66u);
+    for (size_t i = 0; i < got.size(); ++i) {
+        EXPECT_EQ(got[i].first, static_cast<uint8_t>(i));
+        EXPECT_EQ(got[i].second, i == 64 ? 100u : 200u);
+    }
+    EXPECT_TRUE(tx.gso());
+}
+ 
+TEST(UdpSocket, GsoRunsSplitPerDestination) {
+    UdpSocket a(8), b(8), tx(8);
+    a.bind(0, false);
+    b.bind(0, false);
+    if (!tx.set_gso(true)) GTEST_SKIP() << "UDP_SEGMENT not supported";
+ 
+    sockaddr_in dst[2]{};
+    for (int k = 0; k < 2; ++k) {
+        dst[k].sin_family = AF_INET;
+        dst[k].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        dst[k].sin_port = htons(local_port(k == 0 ? a : b));
+    }
+    PacketSlab out(8, 64), in(8, 2048);
+    for (size_t i = 0; i < 8; ++i) {
+        out[i].len = 64;
+        out[i].addr = dst[i < 3 ? 0 : 1];
+    }
+    out.set_size(8);
+    ASSERT_EQ(tx.send_batch(out), 8);
+ 
+    size_t got_a = 0, got_b = 0;
+    for (int spin = 0; spin < 100000 && got_a + got_b < 8; ++spin) {
+        ssize_t r = a.recv_batch(in);
+        if (r > 0) got_a += (size_t)r;
+        r = b.recv_batch(in);
+        if (r > 0) got_b += (size_t)r;
+    }
+    EXPECT_EQ(got_a, 3u);
+    EXPECT_EQ(got_b, 5u);
+}
+ 
+TEST(UdpSocket, GroReadsAreSplitAcrossCallsInOrder) {
+    UdpSocket rx(8), tx(64);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    if (!rx.set_gro(true)) GTEST_SKIP() << "UDP_GRO not supported";
+    tx.set_gso(true); // produces coalescable runs on loopback; plain sends also work
+ 
+    PacketSlab out(40, 256), in(16, 64);
+    for (size_t i = 0; i < out.capacity(); ++i) {
+        out[i].data[0] = static_cast<uint8_t>(i);
+        out[i].len = i == 39 ? 50 : 200;
+    }
+    out.set_size(out.capacity());
+    ASSERT_EQ(tx.send_batch(out), 40);
+ 
+    // The receive slab holds 16 views: a coalesced read of 40 segments must be
+    // returned over several calls, in order, each view with its own length.
+    std::vector<std::pair<uint8_t, uint32_t>> got;
+    for (int spin = 0; spin < 100000 && got.size() < 40; ++spin) {
+        ssize_t r = rx.recv_batch(in);
+        ASSERT_LE(r, 16);
+        for (ssize_t i = 0; i < r; ++i) {
+            got.emplace_back(in[i].data[0], in[i].len);
+            EXPECT_EQ(in[i].addr.sin_port, htons(local_port(tx)));
+        }
+    }
+    ASSERT_EQ(got.size(), 40u);
+    for (size_t i = 0; i < got.size(); ++i) {
+        EXPECT_EQ(got[i].first, static_cast<uint8_t>(i));
+        EXPECT_EQ(got[i].second, i == 39 ? 50u : 200u);
+    }
+}
+ 
+TEST(UdpSocket, GroVectorReceiveCopiesEachSegment) {
+    UdpSocket rx(8), tx(8);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    if (!rx.set_gro(true)) GTEST_SKIP() << "UDP_GRO not supported";
+    tx.set_gso(true);
+ 
+    std::vector<std::vector<uint8_t>> tx_bufs(8, std::vector<uint8_t>(100, 0x42));
+    std::vector<std::vector<uint8_t>> rx_bufs(8, std::vector<uint8_t>(2048, 0));
+    size_t got = round_trip(tx, rx, tx_bufs, rx_bufs);
+    EXPECT_EQ(got, 8u);
+    EXPECT_EQ(rx_bufs[7][99], 0x42);
+}
+ 
+TEST(UdpSocket, ZeroCopySendsAreReleasedThroughErrorQueue) {
+    UdpSocket rx(8), tx(8);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    EXPECT_EQ(tx.reap_tx().released, 0u);
+    if (!tx.set_zerocopy(true)) GTEST_SKIP() << "MSG_ZEROCOPY not supported";
+ 
+    PacketSlab out(8, 2048), in(8, 2048);
+    for (size_t i = 0; i < 8; ++i) out[i].len = 1500;
+    out.set_size(8);
+    for (int it = 0; it < 4; ++it) ASSERT_EQ(tx.send_batch(out), 8);
+    EXPECT_EQ(tx.tx_issued(), 32u);
+ 
+    TxCompletions c;
+    for (int spin = 0; spin < 100000 && c.released < tx.tx_issued(); ++spin) {
+        c = tx.reap_tx();
+        while (rx.recv_batch(in) > 0) {}
+    }
+    EXPECT_EQ(c.released, 32u);
+    EXPECT_EQ(c.zerocopy + c.copied, 32u);
+}
+ 
+TEST(UdpSocket, RxTimestampsAreOnTheSteadyClock) {
+    UdpSocket rx(8), tx(8);
+    rx.bind(0, false);
+    if (!rx.set_rx_timestamps(true)) GTEST_SKIP() << "kernel RX timestamps unavailable";
+    tx.connect("127.0.0.1", local_port(rx));
+ 
+    PacketSlab out(4, 64), in(8, 2048);
+    for (size_t i = 0; i < out.capacity(); ++i) out[i].len = 64;
+    out.set_size(out.capacity());
+ 
+    const uint64_t before = now_ns();
+    ASSERT_EQ(tx.send_batch(out), 4);
+    size_t got = 0;
+    bool stamps_ok = true;
+    for (int spin = 0; spin < 100000 && got < 4; ++spin) {
+        ssize_t r = rx.recv_batch(in);
+        const uint64_t after = now_ns();
+        for (ssize_t i = 0; i < r; ++i) {
+            // Allow some slack for the realtime/monotonic offset sampling.
+            stamps_ok = stamps_ok && in[i].rx_ts_ns + 1'000'000 >= before && in[i].rx_ts_ns <= after + 1'000'000;
+        }
+        if (r > 0) got += (size_t)r;
+    }
+    EXPECT_EQ(got, 4u);
+    EXPECT_TRUE(stamps_ok);
+ 
+    rx.set_rx_timestamps(false);
+    EXPECT_FALSE(rx.rx_timestamps());
+    ASSERT_EQ(tx.send_batch(out), 4);
+    got = 0;
+    for (int spin = 0; spin < 100000 && got < 4; ++spin) {
+        ssize_t r = rx.recv_batch(in);
+        for (ssize_t i = 0; i < r; ++i) EXPECT_EQ(in[i].rx_ts_ns, 0u);
+        if (r > 0) got += (size_t)r;
+    }
+}
+ 
+TEST(UdpSocket, BusyPollSettingsAreReadBack) {
+    UdpSocket s(8);
+    EXPECT_FALSE(s.set_busy_poll(BusyPoll{}).enabled()); // nothing requested: kernel default
+ 
+    BusyPoll want;
+    want.usecs = 25;
+    want.prefer = true;
+    want.budget = 8;
+    BusyPoll got = s.set_busy_poll(want);
+    if (!got.enabled()) GTEST_SKIP() << "SO_BUSY_POLL refused (needs CAP_NET_ADMIN above the sysctl default)";
+    EXPECT_EQ(got.usecs, 25);
+    EXPECT_EQ(got.to_string().rfind("usecs=25 ", 0), 0u);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "udp/stats.hpp"
+#include "udp/histogram.hpp"
+#include <thread>
  
 using namespace udp;
  
@@ -22,4 +24,131 @@ TEST(Stats, Clients) {
     s.note_client(0x7f000001, 9001);
     EXPECT_EQ(s.unique_clients(), 2u);
     EXPECT_NE(s.to_string().size(), 0u);
-}
\ No newline at end of file
+}
+ 
+TEST(Stats, MergeSumsCountersAndUnionsClients) {
+    Stats a, b;
+    a.inc_recv(3);
+    a.add_rx_bytes(30);
+    a.add_queue_delay(100, 2);
+    a.note_client(0x7f000001, 9000);
+    b.inc_recv(4);
+    b.add_loop_iters(7, 1);
+    b.note_client(0x7f000001, 9000);
+    b.note_client(0x7f000001, 9001);
+ 
+    Stats m;
+    m.merge_from(a);
+    m.merge_from(b);
+    EXPECT_EQ(m.recv(), 7u);
+    EXPECT_EQ(m.rx_bytes(), 30u);
+    EXPECT_EQ(m.queue_delay_ns(), 100u);
+    EXPECT_EQ(m.queue_delay_count(), 2u);
+    EXPECT_EQ(m.loop_idle(), 7u);
+    EXPECT_EQ(m.unique_clients(), 2u);
+ 
+    Stats copy(m);
+    EXPECT_EQ(copy.recv(), 7u);
+    EXPECT_EQ(copy.unique_clients(), 2u);
+}
+ 
+TEST(Histogram, ExactBelow64AndWithinThreePercentAbove) {
+    LatencyHistogram h;
+    for (uint64_t v = 0; v < 64; ++v) EXPECT_EQ(LatencyHistogram::bucket_of(v), v);
+    for (uint64_t v : {64ull, 100ull, 1'000ull, 12'345ull, 1'000'000ull, 999'999'999ull}) {
+        const size_t b = LatencyHistogram::bucket_of(v);
+        ASSERT_LT(b, LatencyHistogram::kBuckets);
+        EXPECT_LE(LatencyHistogram::bucket_low(b), v);
+        EXPECT_GE(LatencyHistogram::bucket_high(b), v);
+        EXPECT_LE(LatencyHistogram::bucket_high(b) - LatencyHistogram::bucket_low(b), v / 32);
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_of(~0ull), LatencyHistogram::kBuckets - 1);
+    EXPECT_EQ(h.percentile(50), 0u);
+}
+ 
+TEST(Histogram, PercentilesMergeAndMax) {
+    LatencyHistogram a, b;
+    for (uint64_t v = 1; v <= 1000; ++v) a.record(v * 1000); // 1 µs .. 1 ms
+    b.record_n(5'000'000, 10);
+    EXPECT_EQ(a.count(), 1000u);
+    EXPECT_EQ(a.max(), 1'000'000u);
+    EXPECT_NEAR(static_cast<double>(a.percentile(50)), 500'000.0, 500'000.0 * 0.035);
+    EXPECT_NEAR(static_cast<double>(a.percentile(99)), 990'000.0, 990'000.0 * 0.035);
+    EXPECT_EQ(a.percentile(100), 1'000'000u);
+ 
+    LatencyHistogram m(a);
+    m.merge_from(b);
+    EXPECT_EQ(m.count(), 1010u);
+    EXPECT_EQ(m.max(), 5'000'000u);
+    EXPECT_EQ(m.sum(), a.sum() + 50'000'000u);
+    EXPECT_EQ(m.percentile(99.9), 5'000'000u);
+}
+ 
+TEST(Stats, LatencyHistogramsPerKindMergeAndCopy) {
+    Stats a, b;
+    for (uint64_t v = 1; v <= 100; ++v) a.record_latency(Latency::OneWay, v * 1000);
+    b.record_latency(Latency::OneWay, 2'000'000);
+    b.record_latency(Latency::SendCall, 700);
+    EXPECT_EQ(a.one_way_count(), 100u);
+    EXPECT_EQ(a.one_way_ns(), 5'050'000u);
+    EXPECT_EQ(a.latency(Latency::Rtt).count(), 0u);
+ 
+    Stats m;
+    m.merge_from(a);
+    m.merge_from(b);
+    const Stats copy(m);
+    EXPECT_EQ(copy.latency(Latency::OneWay).count(), 101u);
+    EXPECT_EQ(copy.latency(Latency::OneWay).max(), 2'000'000u);
+    EXPECT_EQ(copy.latency(Latency::OneWay).count_at_or_below(50'000), 50u);
+    EXPECT_EQ(copy.latency(Latency::SendCall).count(), 1u);
+    EXPECT_EQ(copy.latency(Latency::SendCall).percentile(50), 700u);
+}
+ 
+TEST(Stats, ReceiveAndSendGroupsHaveIndependentWriters) {
+    // One thread per counter group on the same shard (a server's RX and echo
+    // paths); the groups sit on separate cache lines and keep every update.
+    Stats s;
+    std::thread rx([&] { for (int i = 0; i < 100'000; ++i) { s.inc_recv(64); s.add_rx_bytes(4096); } });
+    std::thread tx([&] { for (int i = 0; i < 100'000; ++i) { s.inc_sent(64); s.add_tx_bytes(4096); } });
+    rx.join();
+    tx.join();
+    EXPECT_EQ(s.recv(), 6'400'000u);
+    EXPECT_EQ(s.rx_bytes(), 409'600'000u);
+    EXPECT_EQ(s.sent(), 6'400'000u);
+    EXPECT_EQ(s.tx_bytes(), 409'600'000u);
+}
+ 
+TEST(Stats, ClientTableGrowsAndKeepsCounts) {
+    ClientTable t;
+    for (uint16_t port = 1; port <= 1000; ++port) t.add(ClientKey{0x0a000001, port}, port);
+    t.add(ClientKey{0x0a000001, 7});
+    EXPECT_EQ(t.size(), 1000u);
+    EXPECT_EQ(t.hits(ClientKey{0x0a000001, 7}), 8u);
+    EXPECT_EQ(t.hits(ClientKey{0x0a000001, 1000}), 1000u);
+    EXPECT_EQ(t.hits(ClientKey{0x0a000002, 7}), 0u);
+    uint64_t total = 0;
+    size_t seen = 0;
+    t.for_each([&](const ClientKey&, uint64_t n) { total += n; ++seen; });
+    EXPECT_EQ(seen, 1000u);
+    EXPECT_EQ(total, 500'500u + 1u);
+}
+ 
+TEST(Stats, ScrapesReadClientsWhileTheWriterInserts) {
+    Stats s;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint32_t addr = 1; addr <= 20'000; ++addr) s.note_client(addr, 9000);
+        done = true;
+    });
+    size_t last = 0;
+    while (!done) {
+        Stats snap(s); // what a scrape does
+        const size_t n = snap.unique_clients();
+        EXPECT_GE(s.unique_clients(), last);
+        EXPECT_LE(n, 20'000u);
+        last = n;
+    }
+    writer.join();
+    EXPECT_EQ(s.unique_clients(), 20'000u);
+    EXPECT_EQ(Stats(s).unique_clients(), 20'000u);
+}
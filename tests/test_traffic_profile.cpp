@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "udp/traffic_profile.hpp"
+#include "udp/client.hpp"
+#include "udp/socket.hpp"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+ 
+using namespace udp;
+ 
+TEST(TrafficProfile, ParsesRatesAndDurationsWithSuffixes) {
+    double v = 0;
+    EXPECT_TRUE(parse_rate("250k", v));
+    EXPECT_DOUBLE_EQ(v, 250000);
+    EXPECT_TRUE(parse_rate("1.5M", v));
+    EXPECT_DOUBLE_EQ(v, 1.5e6);
+    EXPECT_FALSE(parse_rate("-3", v));
+    EXPECT_FALSE(parse_rate("10kpps", v));
+    EXPECT_TRUE(parse_duration("250ms", v));
+    EXPECT_DOUBLE_EQ(v, 0.25);
+    EXPECT_TRUE(parse_duration("500us", v));
+    EXPECT_DOUBLE_EQ(v, 500e-6);
+    EXPECT_TRUE(parse_duration("3", v));
+    EXPECT_DOUBLE_EQ(v, 3);
+    EXPECT_FALSE(parse_duration("", v));
+}
+ 
+TEST(TrafficProfile, RateFollowsEveryPhaseKind) {
+    TrafficProfile p = TrafficProfile::parse(
+        "warmup:1k:1s, const:10k:1s, ramp:0:100k:2s, step:10k:40k:4:4s, onoff:50k:100ms:300ms:1s, poisson:5k:1");
+    ASSERT_EQ(p.phases().size(), 6u);
+    EXPECT_DOUBLE_EQ(p.duration(), 10.0);
+    EXPECT_DOUBLE_EQ(p.peak(), 100000.0);
+ 
+    EXPECT_TRUE(p.at(0.5).warmup);
+    EXPECT_DOUBLE_EQ(p.at(0.5).pps, 1000);
+    EXPECT_FALSE(p.at(1.5).warmup);
+    EXPECT_DOUBLE_EQ(p.at(1.5).pps, 10000);
+    EXPECT_DOUBLE_EQ(p.at(3.0).pps, 50000);      // halfway up the ramp
+    EXPECT_DOUBLE_EQ(p.at(4.5).pps, 10000);      // step levels 10k, 20k, 30k, 40k
+    EXPECT_DOUBLE_EQ(p.at(6.5).pps, 30000);
+    EXPECT_DOUBLE_EQ(p.at(7.99).pps, 40000);
+    EXPECT_DOUBLE_EQ(p.at(8.05).pps, 50000);     // on
+    EXPECT_DOUBLE_EQ(p.at(8.2).pps, 0);          // off
+    EXPECT_DOUBLE_EQ(p.at(8.45).pps, 50000);     // next period
+    EXPECT_TRUE(p.at(9.5).poisson);
+    EXPECT_TRUE(p.at(10.0).done);
+    EXPECT_FALSE(p.at(9.99).done);
+ 
+    TrafficProfile again = TrafficProfile::parse(p.to_string());
+    EXPECT_EQ(again.to_string(), p.to_string());
+    EXPECT_DOUBLE_EQ(again.at(6.5).pps, 30000);
+}
+ 
+TEST(TrafficProfile, RejectsMalformedPhases) {
+    for (const char* bad : {"const:10k", "ramp:1:2:0", "step:1:2:0:5", "onoff:1k:0:0:5", "burst:1k:1", "const:abc:1"}) {
+        EXPECT_THROW(TrafficProfile::parse(bad), std::invalid_argument) << bad;
+    }
+    EXPECT_TRUE(TrafficProfile::parse("").empty());
+    EXPECT_THROW(TrafficProfile::load("/nonexistent/schedule"), std::runtime_error);
+}
+ 
+TEST(TrafficProfile, LoadsScheduleFile) {
+    const std::string path = ::testing::TempDir() + "udp_schedule.txt";
+    {
+        std::ofstream f(path);
+        f << "# warm the caches first\n"
+          << "warmup:2k:500ms\n\n"
+          << "const:20k:2   # steady\n"
+          << "ramp:20k:0:1s\n";
+    }
+    TrafficProfile p = TrafficProfile::load(path);
+    std::remove(path.c_str());
+    ASSERT_EQ(p.phases().size(), 3u);
+    EXPECT_DOUBLE_EQ(p.duration(), 3.5);
+    EXPECT_EQ(p.phases()[1].kind, PhaseKind::Constant);
+    EXPECT_DOUBLE_EQ(p.at(3.0).pps, 10000);
+}
+ 
+TEST(Client, ProfileDrivesTheRateAndExcludesWarmup) {
+    ClientConfig cfg;
+    cfg.batch = 16;
+    cfg.hugepages = false;
+    cfg.profile = TrafficProfile::parse("warmup:4k:100ms,const:2k:200ms,onoff:8k:50ms:50ms:200ms");
+    std::vector<std::unique_ptr<ISocket>> socks;
+    socks.push_back(std::make_unique<MockSocket>());
+    socks.push_back(std::make_unique<MockSocket>());
+    UdpClient c(std::move(socks), cfg);
+    EXPECT_EQ(c.thread_pps(0) + c.thread_pps(1), 8000u); // split of the peak
+    c.start();
+    c.join();
+ 
+    // Warm-up: 400 packets, outside the stats. Then 400 + 800 counted.
+    EXPECT_NEAR(static_cast<double>(c.warmup_sent()), 400.0, 60.0);
+    EXPECT_NEAR(static_cast<double>(c.stats().sent()), 1200.0, 150.0);
+    EXPECT_NE(c.summary().find(" warmup="), std::string::npos);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "udp/socket.hpp"
+#include <arpa/inet.h>
+#include <cstdint>
+#include <sys/socket.h>
+ 
+/**
+* @file
+* @brief Helpers shared by the unit tests and the loopback benchmarks.
+*/
+ 
+namespace udp {
+ 
+/// @brief Port @p s is bound to (host order), e.g. after `bind(0, ...)`.
+inline uint16_t local_port(const ISocket& s) {
+    sockaddr_in a{};
+    socklen_t len = sizeof(a);
+    getsockname(s.fd(), (sockaddr*)&a, &len);
+    return ntohs(a.sin_port);
+}
+ 
+} // namespace udp
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "udp/wait_strategy.hpp"
+#include "udp/server.hpp"
+#include "udp/common.hpp"
+#include "test_util.hpp"
+#include <arpa/inet.h>
+#include <chrono>
+#include <thread>
+ 
+using namespace udp;
+ 
+static double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+ 
+TEST(WaitStrategy, NamesRoundTrip) {
+    for (WaitKind k : {WaitKind::Spin, WaitKind::SpinYield, WaitKind::SpinEpoll, WaitKind::Block}) {
+        WaitKind parsed = WaitKind::Spin;
+        ASSERT_TRUE(parse_wait(wait_name(k), parsed));
+        EXPECT_EQ(parsed, k);
+    }
+    WaitKind untouched = WaitKind::Block;
+    EXPECT_FALSE(parse_wait("sleep", untouched));
+    EXPECT_EQ(untouched, WaitKind::Block);
+}
+ 
+TEST(WaitStrategy, CountsIdleAndBusyIterations) {
+    MockSocket sock;
+    WaitStrategy w(sock, WaitConfig{});
+    w.after_recv(0);
+    w.after_recv(3);
+    w.after_recv(-1);
+    w.after_recv(0);
+    EXPECT_EQ(w.kind(), WaitKind::Spin);
+    EXPECT_EQ(w.idle_iters(), 3u);
+    EXPECT_EQ(w.busy_iters(), 1u);
+}
+ 
+TEST(WaitStrategy, UnpollableSocketDegradesToSpinYield) {
+    MockSocket sock; // fd() == -1, no blocking receive
+    WaitConfig cfg;
+    cfg.kind = WaitKind::Block;
+    WaitStrategy w(sock, cfg);
+    EXPECT_EQ(w.kind(), WaitKind::SpinYield);
+}
+ 
+TEST(WaitStrategy, SpinEpollSleepsUntilReadableOrTimeout) {
+    UdpSocket rx(8), tx(8);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    WaitConfig cfg;
+    cfg.kind = WaitKind::SpinEpoll;
+    cfg.spin = 2;
+    cfg.timeout_ms = 20;
+    WaitStrategy w(rx, cfg);
+    ASSERT_EQ(w.kind(), WaitKind::SpinEpoll);
+ 
+    // Spin budget first, then one bounded sleep.
+    auto t0 = std::chrono::steady_clock::now();
+    w.after_recv(0);
+    w.after_recv(0);
+    EXPECT_LT(elapsed_ms(t0), 15.0);
+    t0 = std::chrono::steady_clock::now();
+    w.after_recv(0);
+    EXPECT_GE(elapsed_ms(t0), 15.0);
+ 
+    // Pending data ends the sleep early (budget was re-armed by the sleep).
+    std::vector<std::vector<uint8_t>> pkt(1, std::vector<uint8_t>(32, 1));
+    ASSERT_EQ(tx.send_batch(pkt), 1);
+    cfg.timeout_ms = 1000;
+    WaitStrategy slow(rx, cfg);
+    slow.after_recv(0);
+    slow.after_recv(0);
+    t0 = std::chrono::steady_clock::now();
+    slow.after_recv(0);
+    EXPECT_LT(elapsed_ms(t0), 500.0);
+}
+ 
+TEST(WaitStrategy, BlockingReceiveWaitsForFirstDatagram) {
+    UdpSocket rx(8), tx(8);
+    rx.bind(0, false);
+    tx.connect("127.0.0.1", local_port(rx));
+    WaitConfig cfg;
+    cfg.kind = WaitKind::Block;
+    cfg.timeout_ms = 20;
+    {
+        WaitStrategy w(rx, cfg);
+        ASSERT_EQ(w.kind(), WaitKind::Block);
+ 
+        PacketSlab in(8, 2048);
+        auto t0 = std::chrono::steady_clock::now();
+        EXPECT_EQ(rx.recv_batch(in), 0); // times out
+        EXPECT_GE(elapsed_ms(t0), 15.0);
+ 
+        std::thread sender([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            std::vector<std::vector<uint8_t>> pkts(3, std::vector<uint8_t>(32, 7));
+            tx.send_batch(pkts);
+        });
+        cfg.timeout_ms = 1000;
+        rx.set_recv_wait(cfg.timeout_ms);
+        size_t got = 0;
+        for (int i = 0; i < 3 && got < 3; ++i) {
+            ssize_t r = rx.recv_batch(in);
+            w.after_recv(r);
+            if (r > 0) got += (size_t)r;
+        }
+        sender.join();
+        EXPECT_EQ(got, 3u);
+        EXPECT_GE(w.busy_iters(), 1u);
+    }
+    // Strategy gone: receives are non-blocking again.
+    PacketSlab in(8, 2048);
+    auto t0 = std::chrono::steady_clock::now();
+    EXPECT_EQ(rx.recv_batch(in), 0);
+    EXPECT_LT(elapsed_ms(t0), 10.0);
+}
+ 
+TEST(Server, WaitStrategyIterationsReachStats) {
+    auto ms = std::make_unique<MockSocket>();
+    std::vector<uint8_t> pkt(sizeof(PacketHeader), 0);
+    ms->preload_recv(pkt);
+ 
+    ServerConfig cfg;
+    cfg.batch = 8;
+    cfg.metrics_port = 0;
+    cfg.verbose = false;
+    cfg.wait.kind = WaitKind::SpinYield;
+    cfg.wait.spin = 10;
+    UdpServer srv(std::move(ms), cfg);
+    srv.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    srv.stop();
+ 
+    EXPECT_EQ(srv.stats().recv(), 1u);
+    EXPECT_EQ(srv.stats().loop_busy(), 1u);
+    EXPECT_GT(srv.stats().loop_idle(), 10u);
+}
@@ -21,30 +21,25 @@ SRV_PID=$!
 echo "[E2E] server started (pid=$SRV_PID) on UDP :9000, metrics :9100, max-clients=100"
 sleep 0.5
  
-# Launch clients and collect their PIDs (log each launch; use --verbose)
-PIDS=()
-for i in $(seq 1 10); do
-  echo "[E2E] launching client $i..."
-  "$BUILD/udp_client" \
-    --server 127.0.0.1 \
-    --port 9000 \
-    --pps 10000 \
-    --seconds 5 \
-    --payload 64 \
-    --batch 64 \
-    --id "$i" \
-    --verbose &
-  pid=$!
-  PIDS+=("$pid")
-  echo "[E2E] client $i started (pid=$pid)"
-done
+# One client process with 10 sender threads (10 sockets / source ports, 10 kpps each)
+echo "[E2E] launching client with 10 sender threads..."
+"$BUILD/udp_client" \
+  --server 127.0.0.1 \
+  --port 9000 \
+  --pps 100000 \
+  --threads 10 \
+  --seconds 5 \
+  --payload 64 \
+  --batch 64 \
+  --id 1 \
+  --verbose &
+CLI_PID=$!
+echo "[E2E] client started (pid=$CLI_PID)"
  
-# Wait only for clients to finish
-for p in "${PIDS[@]}"; do
-  if ! wait "$p"; then
-    echo "[E2E] WARNING: client process (pid=$p) exited with non-zero status"
-  fi
-done
+# Wait only for the client to finish
+if ! wait "$CLI_PID"; then
+  echo "[E2E] WARNING: client process (pid=$CLI_PID) exited with non-zero status"
+fi
  
 # Give server a moment to print final stats, then terminate it
 sleep 1